@@ -0,0 +1,419 @@
+#include "benchmark.h"
+
+#include "../protocol/hid/hid.h"
+#include "../protocol/mai2serial/mai2serial.h"
+#include "../protocol/touch_sensor/ad7147/ad7147.h"
+#include "../service/input_manager/input_manager.h"
+#include "../hal/timer_wheel.h"
+#include "../service/ui_manager/engine/fonts/font_data.h"
+
+#define BENCH_INPUT_COUNT 64
+#define BENCH_INPUT_MASK (BENCH_INPUT_COUNT - 1)
+#define BENCH_DEVICE_COUNT 4
+
+/**
+ * 固件内核用例
+ * 输入由固定种子的LCG生成，保证主机与RP2040上每次运行的数据完全一致。
+ * 通过友元访问 InputManager 的私有内核，测量的是固件实际执行的代码而非副本。
+ */
+class FirmwareBenchmark {
+public:
+    static void registerAll(BenchmarkSuite& suite);
+
+private:
+    struct StatePair {
+        uint32_t state1;
+        uint32_t state2;
+    };
+
+    static uint32_t lcg_state_;
+    static StatePair states_[BENCH_INPUT_COUNT];
+    static uint16_t stage_status_[BENCH_INPUT_COUNT];
+    static uint64_t packet_bits_[BENCH_INPUT_COUNT];
+    static InputManager::VotingAggregationState voting_;
+
+    static inline uint32_t next_random() {
+        lcg_state_ = lcg_state_ * 1664525u + 1013904223u;
+        return lcg_state_;
+    }
+    static void setupInputs();
+
+    // 投票聚合
+    static uint32_t runVotingAccumulate(uint32_t iterations);
+    static void setupVotingResult();
+    static uint32_t runVotingResult(uint32_t iterations);
+
+    // 滑动窗口投票：每帧写入一个新样本并滑动窗口
+    static void setupVotingWindow();
+    static uint32_t runVotingWindow(uint32_t iterations);
+
+    // 延迟目标帧查找：满缓冲区、抖动帧间隔、随机目标时间
+    static void setupDelayLookup();
+    static uint32_t runDelayLookup(uint32_t iterations);
+
+    // 区域映射
+    static void setupSerialState();
+    static uint32_t runStoreDelayedSerialState(uint32_t iterations);
+
+    // HID触点坐标查找 (hid_为空，只测量映射查找部分)
+    static void setupHIDTouch();
+    static uint32_t runHIDTouch(uint32_t iterations);
+
+    // 键盘位索引
+    static uint32_t runKeyboardBitIndex(uint32_t iterations);
+
+    // GPIO键盘扫描：16个映射引脚，每次轮询一个引脚发生跳变
+    static void setupGPIOKeyboard();
+    static uint32_t runGPIOKeyboard(uint32_t iterations);
+
+    // 触摸键盘触发：16个双区域组合映射，每次轮询一帧随机触摸状态
+    static void setupTouchKeyboard();
+    static uint32_t runTouchKeyboard(uint32_t iterations);
+    // 同上，但每帧状态保持16次轮询 (Core1轮询频率远高于触摸帧率时的常见情况)
+    static uint32_t runTouchKeyboardSteady(uint32_t iterations);
+
+    // 时间轮：32个不同周期的周期定时器，每次推进37us (接近主循环间隔)
+    static void setupTimerWheel();
+    static uint32_t runTimerWheel(uint32_t iterations);
+
+    // AD7147 stage->通道重建
+    static uint32_t runAD7147Reconstruct(uint32_t iterations);
+
+    // Mai2Serial打包
+    static uint32_t runMai2SerialPack(uint32_t iterations);
+
+    // 字库查找
+    static uint32_t runFontLookup(uint32_t iterations);
+};
+
+uint32_t FirmwareBenchmark::lcg_state_ = 0;
+FirmwareBenchmark::StatePair FirmwareBenchmark::states_[BENCH_INPUT_COUNT];
+uint16_t FirmwareBenchmark::stage_status_[BENCH_INPUT_COUNT];
+uint64_t FirmwareBenchmark::packet_bits_[BENCH_INPUT_COUNT];
+InputManager::VotingAggregationState FirmwareBenchmark::voting_;
+
+void FirmwareBenchmark::setupInputs() {
+    lcg_state_ = 0x4D414932;  // "MAI2"
+    for (uint8_t i = 0; i < BENCH_INPUT_COUNT; i++) {
+        // 触摸状态稀疏：同时按下的区域通常只有少数几个
+        states_[i].state1 = next_random() & next_random() & next_random();
+        states_[i].state2 = next_random() & 0x3;
+        stage_status_[i] = static_cast<uint16_t>(next_random() & next_random());
+        packet_bits_[i] = (static_cast<uint64_t>(states_[i].state2) << 32) | states_[i].state1;
+    }
+}
+
+uint32_t FirmwareBenchmark::runVotingAccumulate(uint32_t iterations) {
+    voting_.reset();
+    for (uint32_t i = 0; i < iterations; i++) {
+        // total_samples为16位，定期清零避免溢出
+        if ((i & 0x1FF) == 0x1FF) voting_.reset();
+        voting_.accumulate(packet_bits_[i & BENCH_INPUT_MASK]);
+    }
+    return voting_.total_samples ^ static_cast<uint32_t>(voting_.count_planes[0]) ^ static_cast<uint32_t>(voting_.count_planes[1] >> 32);
+}
+
+void FirmwareBenchmark::setupVotingResult() {
+    setupInputs();
+    voting_.reset();
+    // 32个样本的聚合窗口，约等于 1kHz采样下32ms聚合延迟
+    for (uint8_t i = 0; i < 32; i++) {
+        voting_.accumulate(packet_bits_[i]);
+    }
+}
+
+uint32_t FirmwareBenchmark::runVotingResult(uint32_t iterations) {
+    uint32_t checksum = 0;
+    Mai2Serial_TouchState last;
+    for (uint32_t i = 0; i < iterations; i++) {
+        last.raw = packet_bits_[i & BENCH_INPUT_MASK];
+        const uint64_t result = voting_.getVotingResult(last);
+        checksum += static_cast<uint32_t>(result) ^ static_cast<uint32_t>(result >> 32);
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::setupVotingWindow() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    input_manager->delay_buffer_head_ = 0;
+    input_manager->delay_buffer_count_ = 0;
+    input_manager->serial_delay_state_.window_valid = false;
+}
+
+uint32_t FirmwareBenchmark::runVotingWindow(uint32_t iterations) {
+    // 10kHz帧率、10ms聚合窗口：窗口内约100个样本
+    static const uint32_t frame_interval_us = 100;
+    static const uint32_t window_us = 10000;
+    static uint32_t now_us = 0;
+    InputManager* input_manager = InputManager::getInstance();
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        now_us += frame_interval_us;
+        InputManager::DelayedSerialState& frame = input_manager->delay_buffer_[input_manager->delay_buffer_head_];
+        frame.timestamp_us = now_us;
+        frame.serial_touch_state.raw = packet_bits_[i & BENCH_INPUT_MASK];
+        uint16_t end_idx = input_manager->delay_buffer_head_;
+        input_manager->delay_buffer_head_ = (input_manager->delay_buffer_head_ + 1) & (InputManager::DELAY_BUFFER_SIZE - 1);
+        if (input_manager->delay_buffer_count_ < InputManager::DELAY_BUFFER_SIZE) {
+            input_manager->delay_buffer_count_++;
+        }
+        input_manager->delay_buffer_seq_++;
+        const uint64_t result = input_manager->updateVotingWindow(end_idx, now_us - window_us);
+        checksum += static_cast<uint32_t>(result) ^ static_cast<uint32_t>(result >> 32);
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::setupDelayLookup() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    // 以非零起点写满并回绕缓冲区，帧间隔在100~400us之间抖动
+    uint32_t now_us = 0xFFF00000u;
+    input_manager->delay_buffer_head_ = 0;
+    input_manager->delay_buffer_count_ = 0;
+    for (uint16_t i = 0; i < InputManager::DELAY_BUFFER_SIZE + 77; i++) {
+        now_us += 100 + (next_random() % 301);
+        InputManager::DelayedSerialState& frame = input_manager->delay_buffer_[input_manager->delay_buffer_head_];
+        frame.timestamp_us = now_us;
+        frame.serial_touch_state.raw = packet_bits_[i & BENCH_INPUT_MASK];
+        input_manager->delay_buffer_head_ = (input_manager->delay_buffer_head_ + 1) & (InputManager::DELAY_BUFFER_SIZE - 1);
+        if (input_manager->delay_buffer_count_ < InputManager::DELAY_BUFFER_SIZE) {
+            input_manager->delay_buffer_count_++;
+        }
+    }
+}
+
+uint32_t FirmwareBenchmark::runDelayLookup(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    const uint16_t newest = (input_manager->delay_buffer_head_ - 1) & (InputManager::DELAY_BUFFER_SIZE - 1);
+    const uint32_t newest_us = input_manager->delay_buffer_[newest].timestamp_us;
+    uint32_t checksum = 0;
+    uint16_t buffer_idx = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // 目标覆盖 0~127ms 的延迟，包含早于最旧帧的情况
+        const uint32_t target_us = newest_us - (stage_status_[i & BENCH_INPUT_MASK] & 0x7F) * 1000u;
+        if (input_manager->findDelayedFrame(target_us, buffer_idx)) {
+            checksum += buffer_idx;
+        }
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::setupSerialState() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    input_manager->config_->device_count = BENCH_DEVICE_COUNT;
+    // 34个区域依次分配到4个模块的前9个通道
+    for (uint8_t area_idx = 0; area_idx < 34; area_idx++) {
+        uint8_t device_mask = 0x80 | (0x08 + area_idx / 9);
+        input_manager->config_->area_channel_mappings.serial_mappings[area_idx].channel =
+            InputManager::encodePhysicalChannelAddress(device_mask, 1UL << (area_idx % 9));
+    }
+    for (uint8_t i = 0; i < BENCH_DEVICE_COUNT; i++) {
+        input_manager->touch_device_states_[i].current_touch_mask =
+            (static_cast<uint32_t>(0x80 | (0x08 + i)) << 24) | (states_[i].state1 & 0x1FF);
+    }
+    // 直接改写了映射，需手动重新编译区域表
+    input_manager->rebuildSerialAreaTable();
+}
+
+uint32_t FirmwareBenchmark::runStoreDelayedSerialState(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    for (uint32_t i = 0; i < iterations; i++) {
+        input_manager->storeDelayedSerialState();
+    }
+    uint16_t last = (input_manager->delay_buffer_head_ - 1) & (InputManager::DELAY_BUFFER_SIZE - 1);
+    return input_manager->delay_buffer_[last].serial_touch_state.parts.state1;
+}
+
+void FirmwareBenchmark::setupHIDTouch() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    input_manager->config_->device_count = BENCH_DEVICE_COUNT;
+    // 每个模块前3个通道映射到坐标，多指同时按下
+    InputManager::TouchFrameSnapshot frame;
+    for (uint8_t i = 0; i < BENCH_DEVICE_COUNT; i++) {
+        const uint8_t device_mask = 0x80 | (0x08 + i);
+        input_manager->config_->touch_device_mappings[i].device_id_mask = device_mask;
+        input_manager->config_->touch_device_mappings[i].max_channels = 12;
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            input_manager->setHIDMapping(device_mask, ch, 0.1f * (ch + 1), 0.2f * (i + 1));
+        }
+        frame.touch_masks[i] = (static_cast<uint32_t>(device_mask) << 24) | (next_random() & 0xFFF);
+    }
+    input_manager->touch_frame_.store(frame);
+}
+
+uint32_t FirmwareBenchmark::runHIDTouch(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    for (uint32_t i = 0; i < iterations; i++) {
+        input_manager->sendHIDTouchData();
+    }
+    return input_manager->touch_frame_.sequence();
+}
+
+uint32_t FirmwareBenchmark::runKeyboardBitIndex(uint32_t iterations) {
+    KeyboardBitmap bitmap;
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        checksum += bitmap.getBitIndex(supported_keys[i % SUPPORTED_KEYS_COUNT]);
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::setupGPIOKeyboard() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    input_manager->clearPhysicalKeyboards();
+    for (uint8_t i = 0; i < 8; i++) {
+        input_manager->addPhysicalKeyboard(static_cast<MCU_GPIO>(2 + i), supported_keys[i], GPIOTriggerLevel::ACTIVE_LOW);
+        input_manager->addPhysicalKeyboard(static_cast<MCP_GPIO>(0xC1 + i), supported_keys[8 + i], GPIOTriggerLevel::ACTIVE_HIGH);
+    }
+    input_manager->mcu_gpio_states_ = 0x3FFFFFFF;
+    input_manager->mcp_gpio_states_.port_a = 0;
+    input_manager->mcp_gpio_states_.port_b = 0;
+    input_manager->processGPIOKeyboard();
+}
+
+uint32_t FirmwareBenchmark::runGPIOKeyboard(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        const uint8_t pin = i & 7;
+        if (i & 8) {
+            input_manager->mcp_gpio_states_.port_a ^= (1u << pin);
+        } else {
+            input_manager->mcu_gpio_states_ ^= (1u << (2 + pin));
+        }
+        // 每次采样推进1ms：同一引脚两次翻转间隔16ms，始终在默认消抖锁定期之外
+        input_manager->gpio_sample_time_us_ += 1000;
+        input_manager->processGPIOKeyboard();
+        checksum += static_cast<uint32_t>(input_manager->gpio_keyboard_bitmap_.bitmap_low);
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::setupTouchKeyboard() {
+    setupInputs();
+    InputManager* input_manager = InputManager::getInstance();
+    // HID未初始化时press/release_key直接返回，只测量分发部分
+    input_manager->hid_ = HID::getInstance();
+    while (!input_manager->getTouchKeyboardMappings().empty()) {
+        const TouchKeyboardMapping& mapping = input_manager->getTouchKeyboardMappings().front();
+        input_manager->removeTouchKeyboardMapping(mapping.area_mask, mapping.key);
+    }
+    for (uint8_t i = 0; i < 16; i++) {
+        const uint64_t area_mask = (1ULL << (next_random() % 34)) | (1ULL << (next_random() % 34));
+        input_manager->addTouchKeyboardMapping(area_mask, (i & 1) ? 0 : 1, supported_keys[i], (i & 2) != 0);
+    }
+}
+
+uint32_t FirmwareBenchmark::runTouchKeyboard(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    Mai2Serial_TouchState state;
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        state.raw = packet_bits_[i & BENCH_INPUT_MASK];
+        input_manager->serial_state_.store(state);
+        input_manager->checkTouchKeyboardTrigger();
+        checksum += input_manager->touch_dispatch_active_;
+    }
+    return checksum;
+}
+
+uint32_t FirmwareBenchmark::runTouchKeyboardSteady(uint32_t iterations) {
+    InputManager* input_manager = InputManager::getInstance();
+    Mai2Serial_TouchState state;
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        state.raw = packet_bits_[(i >> 4) & BENCH_INPUT_MASK];
+        input_manager->serial_state_.store(state);
+        input_manager->checkTouchKeyboardTrigger();
+        checksum += input_manager->touch_dispatch_active_;
+    }
+    return checksum;
+}
+
+static TimerWheel bench_wheel_;
+static WheelTimer bench_timers_[32];
+static uint32_t bench_wheel_now_;
+static uint32_t bench_wheel_fired_;
+
+static void bench_timer_callback(void*) {
+    bench_wheel_fired_++;
+}
+
+void FirmwareBenchmark::setupTimerWheel() {
+    setupInputs();
+    bench_wheel_now_ = time_us_32();
+    bench_wheel_.run(bench_wheel_now_);
+    for (uint8_t i = 0; i < 32; i++) {
+        // 周期覆盖第0-2级：100us - 约1.6s
+        const uint32_t period_us = 100 + (next_random() % (1u << (7 + (i % 8) * 2)));
+        bench_wheel_.schedule_periodic(bench_timers_[i], period_us, bench_timer_callback);
+    }
+}
+
+uint32_t FirmwareBenchmark::runTimerWheel(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        bench_wheel_now_ += 37;
+        bench_wheel_.run(bench_wheel_now_);
+    }
+    return bench_wheel_fired_;
+}
+
+uint32_t FirmwareBenchmark::runAD7147Reconstruct(uint32_t iterations) {
+    // 12个启用通道中跳过一个，覆盖stage与通道不一一对应的情况
+    static const uint32_t enabled_channels_mask = 0x0FDF;
+    static const uint8_t enabled_stages = 11;
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        checksum += AD7147::reconstructChannelMask(stage_status_[i & BENCH_INPUT_MASK], enabled_channels_mask, enabled_stages);
+    }
+    return checksum;
+}
+
+uint32_t FirmwareBenchmark::runMai2SerialPack(uint32_t iterations) {
+    uint8_t packet[9] = {MAI2SERIAL_TOUCH_START_BYTE, 0, 0, 0, 0, 0, 0, 0, MAI2SERIAL_TOUCH_END_BYTE};
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        Mai2Serial::pack_touch_packet(packet_bits_[i & BENCH_INPUT_MASK], packet);
+        checksum += packet[1] ^ packet[4] ^ packet[7];
+    }
+    return checksum;
+}
+
+uint32_t FirmwareBenchmark::runFontLookup(uint32_t iterations) {
+    // 典型页面文本：ASCII与中文混合
+    static const char* const glyphs[] = {"A", "z", "0", ":", "触", "摸", "设", "置", "返", "回", "校", "准"};
+    static const uint8_t glyph_count = sizeof(glyphs) / sizeof(glyphs[0]);
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        FontSearchResult result = FontData::find_character(glyphs[i % glyph_count]);
+        checksum += result.found + result.width;
+    }
+    return checksum;
+}
+
+void FirmwareBenchmark::registerAll(BenchmarkSuite& suite) {
+    setupInputs();
+    suite.add({"voting_accumulate", setupInputs, runVotingAccumulate});
+    suite.add({"voting_get_result", setupVotingResult, runVotingResult});
+    suite.add({"voting_window_slide", setupVotingWindow, runVotingWindow});
+    suite.add({"delay_buffer_lookup", setupDelayLookup, runDelayLookup});
+    suite.add({"store_delayed_serial_state", setupSerialState, runStoreDelayedSerialState});
+    suite.add({"hid_touch_lookup", setupHIDTouch, runHIDTouch});
+    suite.add({"keyboard_get_bit_index", nullptr, runKeyboardBitIndex});
+    suite.add({"gpio_keyboard_scan", setupGPIOKeyboard, runGPIOKeyboard});
+    suite.add({"touch_keyboard_trigger", setupTouchKeyboard, runTouchKeyboard});
+    suite.add({"touch_keyboard_steady", setupTouchKeyboard, runTouchKeyboardSteady});
+    suite.add({"timer_wheel_run", setupTimerWheel, runTimerWheel});
+    suite.add({"ad7147_reconstruct_mask", setupInputs, runAD7147Reconstruct});
+    suite.add({"mai2serial_pack_packet", setupInputs, runMai2SerialPack});
+    suite.add({"font_find_character", nullptr, runFontLookup});
+}
+
+void register_firmware_benchmarks(BenchmarkSuite& suite) {
+    FirmwareBenchmark::registerAll(suite);
+}
@@ -0,0 +1,69 @@
+#include "benchmark.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/**
+ * 微基准入口
+ * 主机 (HAL_SIM): 运行一次并输出到标准输出
+ * RP2040: 启动后运行一次，之后每2秒通过USB CDC重复输出结果，便于串口工具随时连接查看
+ */
+
+#ifdef HAL_SIM
+
+static void print_line(const char* line) {
+    puts(line);
+}
+
+int main() {
+    benchmark_timer_init();
+    BenchmarkSuite suite;
+    register_firmware_benchmarks(suite);
+    suite.run_all(print_line);
+    return 0;
+}
+
+#else
+
+#include <Arduino.h>
+#include "../hal/usb/hal_usb.h"
+
+extern "C" {
+#include "../hal/global_irq.h"
+}
+
+#define BENCH_REPORT_INTERVAL_MS 2000
+
+static std::string report_;
+
+static void append_line(const char* line) {
+    report_ += line;
+    report_ += "\r\n";
+}
+
+void setup() {
+    global_irq_init();
+    HAL_USB* hal_usb = HAL_USB_Device::getInstance();
+    hal_usb->init();
+
+    benchmark_timer_init();
+    BenchmarkSuite suite;
+    register_firmware_benchmarks(suite);
+    char header[64];
+    snprintf(header, sizeof(header), "RP2040 @ %lu Hz", static_cast<unsigned long>(F_CPU));
+    append_line(header);
+    suite.run_all(append_line);
+}
+
+void loop() {
+    static uint32_t last_report_ms = 0;
+    if (millis() - last_report_ms < BENCH_REPORT_INTERVAL_MS) {
+        return;
+    }
+    last_report_ms = millis();
+    HAL_USB* hal_usb = HAL_USB_Device::getInstance();
+    hal_usb->cdc_write(reinterpret_cast<const uint8_t*>(report_.data()), report_.size());
+    hal_usb->cdc_flush();
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "benchmark.h"
+#include <stdio.h>
+
+#ifdef HAL_SIM
+#include <chrono>
+#else
+#include "hardware/structs/systick.h"
+#endif
+
+// 单批目标耗时：主机20ms，RP2040约2M周期 (远小于SysTick 24位回绕周期)
+#ifdef HAL_SIM
+#define BENCHMARK_TARGET_TICKS 20000000ULL
+#else
+#define BENCHMARK_TARGET_TICKS 2000000ULL
+#endif
+#define BENCHMARK_MAX_ITERATIONS (1u << 24)
+
+#ifdef HAL_SIM
+
+void benchmark_timer_init() {}
+
+uint64_t benchmark_ticks() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+const char* benchmark_tick_unit() {
+    return "ns";
+}
+
+#else
+
+static uint32_t systick_last_ = 0;
+static uint64_t systick_accumulated_ = 0;
+
+void benchmark_timer_init() {
+    // SysTick使用处理器时钟，24位递减计数
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;  // ENABLE | CLKSOURCE=处理器时钟
+    systick_last_ = systick_hw->cvr;
+    systick_accumulated_ = 0;
+}
+
+// 两次调用间隔需小于2^24周期，由单批目标耗时保证
+uint64_t benchmark_ticks() {
+    uint32_t now = systick_hw->cvr;
+    systick_accumulated_ += (systick_last_ - now) & 0x00FFFFFF;
+    systick_last_ = now;
+    return systick_accumulated_;
+}
+
+const char* benchmark_tick_unit() {
+    return "cycles";
+}
+
+#endif
+
+bool BenchmarkSuite::add(const BenchmarkCase& bench_case) {
+    if (count_ >= BENCHMARK_MAX_CASES) {
+        return false;
+    }
+    cases_[count_++] = bench_case;
+    return true;
+}
+
+uint64_t BenchmarkSuite::measure(const BenchmarkCase& bench_case, uint32_t iterations, uint32_t& checksum) {
+    uint64_t start = benchmark_ticks();
+    checksum = bench_case.run(iterations);
+    return benchmark_ticks() - start;
+}
+
+void BenchmarkSuite::run_all(print_fn_t print) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-32s %12s %19s %8s", "kernel", "iterations", "per_op", "checksum");
+    print(line);
+
+    for (uint8_t i = 0; i < count_; i++) {
+        const BenchmarkCase& bench_case = cases_[i];
+        uint32_t checksum = 0;
+        if (bench_case.setup) {
+            bench_case.setup();
+        }
+        // 预热
+        measure(bench_case, 16, checksum);
+
+        // 倍增迭代次数直到单批耗时达到目标
+        uint32_t iterations = 1;
+        while (iterations < BENCHMARK_MAX_ITERATIONS &&
+               measure(bench_case, iterations, checksum) < BENCHMARK_TARGET_TICKS / 2) {
+            iterations <<= 1;
+        }
+
+        // 取多次测量的最小值，减小中断与调度干扰
+        uint64_t best = UINT64_MAX;
+        for (uint8_t r = 0; r < BENCHMARK_REPEAT; r++) {
+            uint64_t ticks = measure(bench_case, iterations, checksum);
+            if (ticks < best) best = ticks;
+        }
+
+        // 定点输出两位小数，避免RP2040上的浮点printf
+        uint64_t per_op_x100 = best * 100 / iterations;
+        snprintf(line, sizeof(line), "%-32s %12lu %9lu.%02u %-6s %08lx",
+                 bench_case.name, static_cast<unsigned long>(iterations),
+                 static_cast<unsigned long>(per_op_x100 / 100), static_cast<unsigned>(per_op_x100 % 100),
+                 benchmark_tick_unit(), static_cast<unsigned long>(checksum));
+        print(line);
+    }
+}
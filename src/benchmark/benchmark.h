@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * 固件热点内核微基准
+ * 同一套用例既可在主机上运行 (native环境，计时单位 ns)，
+ * 也可烧录到RP2040运行 (计时单位为CPU周期，基于SysTick)。
+ * 每个用例使用固定输入，先倍增迭代次数直到单批耗时足够长，再取多次测量的最小值。
+ *
+ * 主机:   pio run -e bench_native && .pio/build/bench_native/program
+ * RP2040: pio run -e bench_pico -t upload，结果通过USB CDC周期性输出
+ */
+
+#define BENCHMARK_MAX_CASES 16
+#define BENCHMARK_REPEAT 5
+
+// 单个基准用例：setup 准备固定输入，run 执行 iterations 次内核并返回校验值 (防止结果被优化掉)
+struct BenchmarkCase {
+    const char* name;
+    void (*setup)();
+    uint32_t (*run)(uint32_t iterations);
+};
+
+class BenchmarkSuite {
+public:
+    using print_fn_t = void (*)(const char* line);
+
+    BenchmarkSuite() : count_(0) {}
+
+    bool add(const BenchmarkCase& bench_case);
+
+    // 依次运行所有用例，每个用例输出一行结果
+    void run_all(print_fn_t print);
+
+private:
+    BenchmarkCase cases_[BENCHMARK_MAX_CASES];
+    uint8_t count_;
+
+    static uint64_t measure(const BenchmarkCase& bench_case, uint32_t iterations, uint32_t& checksum);
+};
+
+// 计时源：主机为纳秒，RP2040为CPU周期
+void benchmark_timer_init();
+uint64_t benchmark_ticks();
+const char* benchmark_tick_unit();
+
+// 注册全部固件内核用例 (bench_kernels.cpp)
+void register_firmware_benchmarks(BenchmarkSuite& suite);
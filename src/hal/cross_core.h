@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+#include "hardware/sync.h"
+
+/**
+ * 双核无锁数据交接原语 (仅头文件)
+ * RP2040的两个M0+核心共享SRAM但不保证跨核写入顺序可见，
+ * 因此发布/读取两侧都用 __dmb() 作为硬件内存屏障，同时也阻止编译器重排。
+ *
+ * SpscRing  - 单生产者/单消费者环形队列，用于请求/事件的跨核投递
+ * SeqLock   - 单写者快照，用于多字节状态 (如64位触摸状态) 的跨核发布，读者不会读到撕裂的值
+ *
+ * 约束：每个实例只能有一个写者 (SpscRing另有一个读者)，
+ * 且不能在会抢占写者的同核中断中读取SeqLock (读者会一直重试)。
+ */
+
+// 单生产者/单消费者环形队列，N必须为2的幂
+// head_只由生产者写，tail_只由消费者写，索引自由递增，回绕由无符号减法处理
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    SpscRing() : head_(0), tail_(0) {}
+
+    // 生产者侧：队列满时返回false
+    bool push(const T& item) {
+        const uint32_t head = head_;
+        if (head - tail_ == N) {
+            return false;
+        }
+        buffer_[head & (N - 1)] = item;
+        __dmb();  // 元素写入先于head发布
+        head_ = head + 1;
+        return true;
+    }
+
+    // 消费者侧：队列空时返回false
+    bool pop(T& item) {
+        const uint32_t tail = tail_;
+        if (head_ == tail) {
+            return false;
+        }
+        __dmb();  // 观察到head后再读取元素
+        item = buffer_[tail & (N - 1)];
+        __dmb();  // 元素读取完成后再释放槽位
+        tail_ = tail + 1;
+        return true;
+    }
+
+    // 消费者侧：读取队首元素但不出队，队列空时返回false
+    bool peek(T& item) const {
+        const uint32_t tail = tail_;
+        if (head_ == tail) {
+            return false;
+        }
+        __dmb();
+        item = buffer_[tail & (N - 1)];
+        return true;
+    }
+
+    bool empty() const { return head_ == tail_; }
+    uint32_t size() const { return head_ - tail_; }
+    static constexpr uint32_t capacity() { return N; }
+
+private:
+    T buffer_[N];
+    volatile uint32_t head_;
+    volatile uint32_t tail_;
+};
+
+// 单写者顺序锁快照
+// 写者：序号置为奇数 -> 写数据 -> 序号置为下一个偶数；写入从不阻塞
+// 读者：读取前后序号一致且为偶数时快照有效，否则重试
+template <typename T>
+class SeqLock {
+public:
+    SeqLock() : sequence_(0), value_() {}
+    explicit SeqLock(const T& initial) : sequence_(0), value_(initial) {}
+
+    // 写者侧 (只能有一个写者)
+    void store(const T& value) {
+        const uint32_t sequence = sequence_;
+        sequence_ = sequence + 1;
+        __dmb();
+        value_ = value;
+        __dmb();
+        sequence_ = sequence + 2;
+    }
+
+    // 读者侧：单次尝试，写入进行中时返回false
+    bool try_load(T& out) const {
+        const uint32_t begin = sequence_;
+        if (begin & 1) {
+            return false;
+        }
+        __dmb();
+        out = value_;
+        __dmb();
+        return sequence_ == begin;
+    }
+
+    // 读者侧：重试直到获得一致快照
+    T load() const {
+        T out;
+        while (!try_load(out)) {
+        }
+        return out;
+    }
+
+    // 写者本地读取：写者自身持有最新值，无需同步
+    const T& owner_value() const { return value_; }
+
+    // 每次发布递增2，可用于判断是否有新数据
+    uint32_t sequence() const { return sequence_; }
+
+private:
+    volatile uint32_t sequence_;
+    T value_;
+};
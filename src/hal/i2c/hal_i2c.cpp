@@ -14,7 +14,7 @@ extern "C" {
 HAL_I2C::HAL_I2C(i2c_inst_t* i2c_instance)
     : i2c_instance_(i2c_instance), initialized_(false), sda_pin_(0), scl_pin_(0), 
       dma_status_(DMA_Status::IDLE), dma_tx_channel_(-1), dma_rx_channel_(-1),
-      interrupts_enabled_(false), read_cmd_(I2C_IC_DATA_CMD_CMD_BITS) {
+      interrupts_enabled_(false), last_abort_nack_(false), read_cmd_(I2C_IC_DATA_CMD_CMD_BITS) {
     // 初始化DMA上下文
     dma_context_ = DMA_Context();
     // 初始化命令缓冲区
@@ -151,7 +151,10 @@ int32_t HAL_I2C::write_register(uint8_t address, uint16_t reg, uint8_t* value, u
         data[1] = reg & 0xFF;
     }
     memcpy(data + reg_size, value, length);
-    return i2c_write_blocking(i2c_instance_, address, data, length + reg_size, false) - reg_size;
+    const int32_t result = i2c_write_blocking(i2c_instance_, address, data, length + reg_size, false);
+    // 阻塞接口在地址未应答时返回PICO_ERROR_GENERIC
+    last_abort_nack_ = (result == PICO_ERROR_GENERIC);
+    return result - reg_size;
 }
 
 int32_t HAL_I2C::read_register(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length) {
@@ -176,7 +179,9 @@ int32_t HAL_I2C::read_register(uint8_t address, uint16_t reg, uint8_t* value, ui
     }
     // 子地址写入后发送 STOP，确保 EZI2C 指针锁定
     i2c_write_blocking(i2c_instance_, address, data, reg_size, false);
-    return i2c_read_blocking(i2c_instance_, address, value, length, false);
+    const int32_t result = i2c_read_blocking(i2c_instance_, address, value, length, false);
+    last_abort_nack_ = (result == PICO_ERROR_GENERIC);
+    return result;
 }
 
 bool HAL_I2C::device_exists(uint8_t address) {
@@ -317,6 +322,7 @@ bool HAL_I2C::_setup_dma_write(uint8_t address, const uint8_t* data, size_t leng
     }
     
     dma_status_ = DMA_Status::TX_BUSY;
+    last_abort_nack_ = false;
     
     // 准备I2C命令 - 参考i2c_dma.c的data_cmds设置
     for (size_t i = 0; i < length; ++i) {
@@ -365,6 +371,7 @@ bool HAL_I2C::_setup_dma_read(uint8_t address, uint8_t* buffer, size_t length) {
     }
     
     dma_status_ = DMA_Status::RX_BUSY;
+    last_abort_nack_ = false;
     
     i2c_hw_t *hw = i2c_get_hw(i2c_instance_);
     
@@ -433,6 +440,7 @@ bool HAL_I2C::_setup_dma_write_read(uint8_t address, const uint8_t* wbuf, size_t
     }
     
     dma_status_ = DMA_Status::RX_BUSY;  // 最终状态是读取
+    last_abort_nack_ = false;
     
     i2c_hw_t *hw = i2c_get_hw(i2c_instance_);
     
@@ -517,6 +525,11 @@ void HAL_I2C::_handle_i2c_irq() {
     
     // 处理TX_ABRT中断
     if (intr_stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // 中止原因在清除TX_ABRT时一并清零，需先读取
+        last_abort_nack_ = (hw->tx_abrt_source & (I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS |
+                                                  I2C_IC_TX_ABRT_SOURCE_ABRT_10ADDR1_NOACK_BITS |
+                                                  I2C_IC_TX_ABRT_SOURCE_ABRT_10ADDR2_NOACK_BITS |
+                                                  I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS)) != 0;
         // 清除TX_ABRT中断
         (void)hw->clr_tx_abrt;
         
@@ -88,6 +88,9 @@ public:
     // 检查DMA传输状态
     bool is_busy() const;
     
+    // 最近一次寄存器事务是否因NACK (地址或数据未应答) 而失败；异步事务在失败回调中读取
+    inline bool last_abort_was_nack() const { return last_abort_nack_; }
+    
     // 写入寄存器 REG & 0x8000 时 锁定16位发送 否则根据是否满9位地址判断发送8或16位
     int32_t write_register(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length);
     
@@ -122,6 +125,9 @@ protected:
     // 中断状态跟踪（惰性管理）
     volatile bool interrupts_enabled_;
     
+    // 最近一次TX_ABRT是否由NACK引起
+    volatile bool last_abort_nack_;
+    
     // I2C读命令字
     uint16_t read_cmd_;
     
@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * 主机仿真 - Arduino.h 替身
+ * 与 arduino-pico 内核一致，顺带引入 SDK 常用头文件
+ */
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/watchdog.h"
+#include "hardware/sync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline unsigned long millis(void) { return (unsigned long)(time_us_64() / 1000); }
+static inline unsigned long micros(void) { return (unsigned long)time_us_64(); }
+static inline void delay(unsigned long ms) { sleep_ms((uint32_t)ms); }
+static inline void delayMicroseconds(unsigned int us) { sleep_us(us); }
+static inline void disable_interrupts(void) {}
+static inline void enable_interrupts(void) {}
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+#ifdef __cplusplus
+}
+#endif
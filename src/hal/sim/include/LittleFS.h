@@ -0,0 +1,45 @@
+#pragma once
+
+/**
+ * 主机仿真 - LittleFS 替身
+ * 文件内容保存在进程内存中，进程退出即丢弃，足以覆盖 ConfigManager 的读写路径
+ */
+
+#include "Arduino.h"
+#include <string>
+#include <memory>
+
+class File {
+public:
+    File() : pos_(0), writable_(false) {}
+
+    operator bool() const { return data_ != nullptr; }
+
+    int available();
+    int read();
+    size_t read(uint8_t* buf, size_t size);
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t size);
+    size_t write(const char* buf, size_t size) { return write(reinterpret_cast<const uint8_t*>(buf), size); }
+    size_t size() const;
+    void flush() {}
+    void close();
+
+private:
+    friend class SimLittleFS;
+    std::shared_ptr<std::string> data_;
+    size_t pos_;
+    bool writable_;
+};
+
+class SimLittleFS {
+public:
+    bool begin();
+    bool format();
+    void end();
+    bool exists(const char* path);
+    bool remove(const char* path);
+    File open(const char* path, const char* mode);
+};
+
+extern SimLittleFS LittleFS;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "pico.h"
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+    clk_usb = 7,
+    clk_adc = 8,
+    clk_rtc = 9,
+};
+
+// 仿真按 133MHz 系统时钟计算分频
+static inline uint32_t clock_get_hz(enum clock_index clk_index) {
+    (void)clk_index;
+    return 133000000u;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/dma.h 替身
+ * DMA 完成事件由各仿真外设通过 SimClock 事件队列投递
+ */
+
+#include "pico.h"
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(unsigned int channel);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,4 @@
+#pragma once
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
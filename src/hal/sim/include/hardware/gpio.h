@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/gpio.h 替身
+ * 引脚电平保存在 sim_sio_hw.gpio_in / gpio_out 中
+ */
+
+#include "pico.h"
+#include "hardware/structs/sio.h"
+
+#define NUM_BANK0_GPIOS 30
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_function {
+    GPIO_FUNC_XIP = 0,
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_GPCK = 8,
+    GPIO_FUNC_USB = 9,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL = 0x4u,
+    GPIO_IRQ_EDGE_RISE = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(unsigned int gpio, uint32_t event_mask);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gpio_init(unsigned int gpio);
+void gpio_set_function(unsigned int gpio, enum gpio_function fn);
+void gpio_set_dir(unsigned int gpio, bool out);
+void gpio_put(unsigned int gpio, bool value);
+bool gpio_get(unsigned int gpio);
+void gpio_pull_up(unsigned int gpio);
+void gpio_pull_down(unsigned int gpio);
+void gpio_disable_pulls(unsigned int gpio);
+void gpio_set_irq_enabled(unsigned int gpio, uint32_t event_mask, bool enabled);
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
+void gpio_acknowledge_irq(unsigned int gpio, uint32_t event_mask);
+
+static inline uint32_t gpio_get_all(void) { return sio_hw->gpio_in; }
+static inline void gpio_init_mask(uint32_t mask) { (void)mask; }
+static inline void gpio_set_dir_in_masked(uint32_t mask) { sio_hw->gpio_oe &= ~mask; }
+static inline void gpio_set_dir_out_masked(uint32_t mask) { sio_hw->gpio_oe |= mask; }
+
+#ifdef __cplusplus
+}
+#endif
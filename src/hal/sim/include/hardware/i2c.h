@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/i2c.h 替身
+ * 仅提供实例类型，总线行为由 src/hal/sim/sim_hal_i2c.cpp 实现
+ */
+
+#include "pico.h"
+
+typedef struct i2c_inst {
+    uint8_t hw_index;
+} i2c_inst_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern i2c_inst_t sim_i2c0_inst;
+extern i2c_inst_t sim_i2c1_inst;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define i2c0 (&sim_i2c0_inst)
+#define i2c1 (&sim_i2c1_inst)
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/irq.h 替身
+ */
+
+#include "pico.h"
+
+typedef void (*irq_handler_t)(void);
+
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define IO_IRQ_BANK0 13
+#define SPI0_IRQ 18
+#define SPI1_IRQ 19
+#define UART0_IRQ 20
+#define UART1_IRQ 21
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+
+static inline void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler) { (void)num; (void)handler; }
+static inline void irq_set_enabled(unsigned int num, bool enabled) { (void)num; (void)enabled; }
+static inline void irq_set_priority(unsigned int num, uint8_t priority) { (void)num; (void)priority; }
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/pio.h 替身
+ * 仅提供程序与状态机配置类型，状态机行为由 sim_hal_pio.cpp 实现
+ */
+
+#include "pico.h"
+
+typedef struct pio_program {
+    const uint16_t* instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct {
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+} pio_sm_config;
+
+typedef struct pio_hw {
+    uint8_t hw_index;
+} pio_hw_t;
+
+typedef pio_hw_t* PIO;
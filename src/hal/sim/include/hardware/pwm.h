@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/pwm.h 替身 (仅背光使用)
+ */
+
+#include "pico.h"
+
+static inline unsigned int pwm_gpio_to_slice_num(unsigned int gpio) { return (gpio >> 1u) & 7u; }
+static inline unsigned int pwm_gpio_to_channel(unsigned int gpio) { return gpio & 1u; }
+static inline void pwm_set_wrap(unsigned int slice_num, uint16_t wrap) { (void)slice_num; (void)wrap; }
+static inline void pwm_set_chan_level(unsigned int slice_num, unsigned int chan, uint16_t level) { (void)slice_num; (void)chan; (void)level; }
+static inline void pwm_set_gpio_level(unsigned int gpio, uint16_t level) { (void)gpio; (void)level; }
+static inline void pwm_set_enabled(unsigned int slice_num, bool enabled) { (void)slice_num; (void)enabled; }
+static inline void pwm_set_clkdiv(unsigned int slice_num, float divider) { (void)slice_num; (void)divider; }
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/spi.h 替身
+ */
+
+#include "pico.h"
+
+typedef struct spi_inst {
+    uint8_t hw_index;
+} spi_inst_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern spi_inst_t sim_spi0_inst;
+extern spi_inst_t sim_spi1_inst;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define spi0 (&sim_spi0_inst)
+#define spi1 (&sim_spi1_inst)
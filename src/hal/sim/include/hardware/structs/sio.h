@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * 主机仿真 - SIO 寄存器块替身
+ * gpio_in 由 SimGPIO 写入，业务代码照常读取 sio_hw->gpio_in
+ */
+
+#include "pico.h"
+
+typedef struct {
+    volatile uint32_t cpuid;
+    volatile uint32_t gpio_in;
+    volatile uint32_t gpio_hi_in;
+    volatile uint32_t gpio_out;
+    volatile uint32_t gpio_oe;
+} sio_hw_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern sio_hw_t sim_sio_hw;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define sio_hw (&sim_sio_hw)
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * 主机仿真 - hardware/uart.h 替身
+ */
+
+#include "pico.h"
+
+typedef struct uart_inst {
+    uint8_t hw_index;
+} uart_inst_t;
+
+typedef enum {
+    UART_PARITY_NONE,
+    UART_PARITY_EVEN,
+    UART_PARITY_ODD
+} uart_parity_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uart_inst_t sim_uart0_inst;
+extern uart_inst_t sim_uart1_inst;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define uart0 (&sim_uart0_inst)
+#define uart1 (&sim_uart1_inst)
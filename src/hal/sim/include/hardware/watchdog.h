@@ -0,0 +1,8 @@
+#pragma once
+
+#include "pico.h"
+
+static inline void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) { (void)delay_ms; (void)pause_on_debug; }
+static inline void watchdog_update(void) {}
+static inline void watchdog_disable(void) {}
+static inline void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms) { (void)pc; (void)sp; (void)delay_ms; }
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * 主机仿真 - pico.h 替身
+ * 汇总 SDK 平台宏，所有仿真头文件都经由此处获得这些定义
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef __force_inline
+#define __force_inline inline __attribute__((always_inline))
+#endif
+#ifndef __not_in_flash_func
+#define __not_in_flash_func(func) func
+#endif
+#ifndef __time_critical_func
+#define __time_critical_func(func) func
+#endif
+#ifndef __no_inline_not_in_flash_func
+#define __no_inline_not_in_flash_func(func) func
+#endif
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+typedef unsigned int uint;
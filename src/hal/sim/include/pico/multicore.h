@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * 主机仿真 - pico/multicore.h 替身
+ * 仿真中两个核心由单线程交替调度，锁定操作为空
+ */
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void multicore_lockout_victim_init(void) {}
+static inline void multicore_lockout_start_blocking(void) {}
+static inline void multicore_lockout_end_blocking(void) {}
+static inline bool multicore_lockout_start_timeout_us(uint64_t us) { (void)us; return true; }
+static inline bool multicore_lockout_end_timeout_us(uint64_t us) { (void)us; return true; }
+
+#ifdef __cplusplus
+}
+#endif
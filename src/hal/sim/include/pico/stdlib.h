@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * 主机仿真 - pico/stdlib.h 替身
+ * 仅提供固件实际用到的 SDK 子集，时间由 SimClock 虚拟时钟驱动
+ */
+
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 忙等循环体 - 仿真中推进虚拟时钟1us，保证超时循环能够退出
+void tight_loop_contents(void);
+
+// 当前核心号 - 仿真中由 SimClock 的核心上下文决定
+uint32_t get_core_num(void);
+
+static inline void __wfe(void) { tight_loop_contents(); }
+static inline void __sev(void) {}
+static inline void __wfi(void) { tight_loop_contents(); }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __dsb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __isb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __compiler_memory_barrier(void) { __asm__ volatile("" ::: "memory"); }
+
+static inline void stdio_init_all(void) {}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * 主机仿真 - pico/time.h 替身
+ * 所有时间读取都来自 SimClock 虚拟时钟，sleep 直接推进虚拟时钟
+ */
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t absolute_time_t;
+
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us_32(uint32_t us);
+void busy_wait_us(uint64_t us);
+void busy_wait_ms(uint32_t ms);
+
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline uint32_t us_to_ms(uint64_t us) { return (uint32_t)(us / 1000); }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + (uint64_t)ms * 1000; }
+// 仿真中没有中断/事件唤醒，等待直接把虚拟时钟推进到超时时间
+static inline bool best_effort_wfe_or_timeout(absolute_time_t timeout) {
+    const uint64_t now = time_us_64();
+    if (timeout > now) sleep_us(timeout - now);
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * 主机仿真 - TinyUSB 替身
+ * HID报告与CDC数据由 sim_hal_usb.cpp 记录，供主机侧分析
+ */
+
+#include "pico.h"
+
+typedef enum {
+    HID_REPORT_TYPE_INVALID = 0,
+    HID_REPORT_TYPE_INPUT,
+    HID_REPORT_TYPE_OUTPUT,
+    HID_REPORT_TYPE_FEATURE
+} hid_report_type_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool tud_hid_report(uint8_t report_id, void const* report, uint16_t len);
+bool tud_hid_ready(void);
+bool tud_mounted(void);
+bool tud_ready(void);
+void tud_task(void);
+
+#ifdef __cplusplus
+}
+#endif
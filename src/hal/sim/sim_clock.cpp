@@ -0,0 +1,179 @@
+#include "sim_hal.h"
+#include <pico/stdlib.h>
+#include <pico/time.h>
+#include <vector>
+#include <algorithm>
+
+/**
+ * 虚拟时钟实现
+ * 时间只在 advance/sleep/忙等 时前进，事件按 (到期时间, 挂载顺序) 派发，保证结果可复现
+ */
+
+namespace {
+
+struct SimEvent {
+    uint64_t due_us;
+    uint32_t id;
+    SimClock::event_callback_t callback;
+};
+
+// 小顶堆比较：到期时间早的优先，同一时刻按挂载顺序
+struct SimEventLater {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        if (a.due_us != b.due_us) return a.due_us > b.due_us;
+        return a.id > b.id;
+    }
+};
+
+static uint64_t g_now_us = 0;
+static uint32_t g_next_event_id = 1;
+static std::vector<SimEvent> g_events;
+static std::vector<uint32_t> g_cancelled;
+static uint8_t g_current_core = 0;
+static uint32_t g_busy_wait_step_us = 1;
+
+static bool take_cancelled(uint32_t id) {
+    auto it = std::find(g_cancelled.begin(), g_cancelled.end(), id);
+    if (it == g_cancelled.end()) return false;
+    g_cancelled.erase(it);
+    return true;
+}
+
+// 派发到期时间不晚于 limit_us 的一个事件，时钟跳到事件时间
+static bool dispatch_one(uint64_t limit_us) {
+    if (g_events.empty() || g_events.front().due_us > limit_us) {
+        return false;
+    }
+    std::pop_heap(g_events.begin(), g_events.end(), SimEventLater());
+    SimEvent event = std::move(g_events.back());
+    g_events.pop_back();
+
+    if (take_cancelled(event.id)) {
+        return true;
+    }
+    if (event.due_us > g_now_us) {
+        g_now_us = event.due_us;
+    }
+    // 回调中允许再次挂载事件或推进时钟 (模拟中断嵌套)
+    if (event.callback) {
+        event.callback();
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t SimClock::now_us() {
+    return g_now_us;
+}
+
+void SimClock::advance_to(uint64_t target_us) {
+    if (target_us < g_now_us) {
+        target_us = g_now_us;
+    }
+    while (dispatch_one(target_us)) {
+    }
+    if (target_us > g_now_us) {
+        g_now_us = target_us;
+    }
+}
+
+void SimClock::advance_us(uint64_t us) {
+    advance_to(g_now_us + us);
+}
+
+bool SimClock::run_pending() {
+    bool dispatched = false;
+    while (dispatch_one(g_now_us)) {
+        dispatched = true;
+    }
+    return dispatched;
+}
+
+uint32_t SimClock::schedule_at(uint64_t due_us, event_callback_t callback) {
+    uint32_t id = g_next_event_id++;
+    g_events.push_back(SimEvent{due_us, id, std::move(callback)});
+    std::push_heap(g_events.begin(), g_events.end(), SimEventLater());
+    return id;
+}
+
+uint32_t SimClock::schedule_after(uint64_t delay_us, event_callback_t callback) {
+    return schedule_at(g_now_us + delay_us, std::move(callback));
+}
+
+void SimClock::cancel(uint32_t event_id) {
+    for (const SimEvent& event : g_events) {
+        if (event.id == event_id) {
+            g_cancelled.push_back(event_id);
+            return;
+        }
+    }
+}
+
+uint64_t SimClock::next_event_us() {
+    return g_events.empty() ? UINT64_MAX : g_events.front().due_us;
+}
+
+void SimClock::set_core(uint8_t core) {
+    g_current_core = core & 0x01;
+}
+
+uint8_t SimClock::current_core() {
+    return g_current_core;
+}
+
+void SimClock::set_busy_wait_step_us(uint32_t step_us) {
+    g_busy_wait_step_us = step_us ? step_us : 1;
+}
+
+uint32_t SimClock::busy_wait_step_us() {
+    return g_busy_wait_step_us;
+}
+
+void SimClock::reset() {
+    g_events.clear();
+    g_cancelled.clear();
+    g_now_us = 0;
+    g_next_event_id = 1;
+}
+
+// pico SDK 时间原语
+extern "C" {
+
+uint32_t time_us_32(void) {
+    return static_cast<uint32_t>(g_now_us);
+}
+
+uint64_t time_us_64(void) {
+    return g_now_us;
+}
+
+void sleep_us(uint64_t us) {
+    SimClock::advance_us(us);
+}
+
+void sleep_ms(uint32_t ms) {
+    SimClock::advance_us(static_cast<uint64_t>(ms) * 1000);
+}
+
+void busy_wait_us_32(uint32_t us) {
+    SimClock::advance_us(us);
+}
+
+void busy_wait_us(uint64_t us) {
+    SimClock::advance_us(us);
+}
+
+void busy_wait_ms(uint32_t ms) {
+    SimClock::advance_us(static_cast<uint64_t>(ms) * 1000);
+}
+
+void tight_loop_contents(void) {
+    SimClock::advance_us(g_busy_wait_step_us);
+}
+
+uint32_t get_core_num(void) {
+    return g_current_core;
+}
+
+} // extern "C"
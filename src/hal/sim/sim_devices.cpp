@@ -0,0 +1,386 @@
+#include "sim_devices.h"
+#include <cstring>
+
+// MCP23S17 寄存器地址 (BANK=0)
+#define SIM_MCP_IODIRA  0x00
+#define SIM_MCP_IODIRB  0x01
+#define SIM_MCP_IPOLA   0x02
+#define SIM_MCP_IPOLB   0x03
+#define SIM_MCP_GPINTENA 0x04
+#define SIM_MCP_DEFVALA 0x06
+#define SIM_MCP_INTCONA 0x08
+#define SIM_MCP_IOCON   0x0A
+#define SIM_MCP_IOCON2  0x0B
+#define SIM_MCP_INTFA   0x0E
+#define SIM_MCP_INTCAPA 0x10
+#define SIM_MCP_GPIOA   0x12
+#define SIM_MCP_GPIOB   0x13
+#define SIM_MCP_OLATA   0x14
+#define SIM_MCP_OLATB   0x15
+#define SIM_MCP_IOCON_SEQOP 0x20
+#define SIM_MCP_IOCON_MIRROR 0x40
+
+// PSoC 寄存器地址
+#define SIM_PSOC_SCAN_RATE    0x00
+#define SIM_PSOC_TOUCH_STATUS 0x01
+#define SIM_PSOC_REG_COUNT    0x1B
+
+SimMCP23S17::SimMCP23S17() : inputs_(0xFFFF), int_pin_(0xFF), frame_pos_(0), opcode_(0), pointer_(0) {
+    memset(regs_, 0, sizeof(regs_));
+    regs_[SIM_MCP_IODIRA] = 0xFF;   // 上电默认全部输入
+    regs_[SIM_MCP_IODIRB] = 0xFF;
+}
+
+void SimMCP23S17::on_select() {
+    frame_pos_ = 0;
+}
+
+void SimMCP23S17::set_inputs(uint16_t levels) {
+    const uint16_t previous = inputs_;
+    inputs_ = levels;
+    for (uint8_t port = 0; port < 2; port++) {
+        const uint8_t before = static_cast<uint8_t>(previous >> (port * 8));
+        const uint8_t now = static_cast<uint8_t>(levels >> (port * 8));
+        const uint8_t enabled = regs_[SIM_MCP_GPINTENA + port] & regs_[SIM_MCP_IODIRA + port];
+        const uint8_t intcon = regs_[SIM_MCP_INTCONA + port];
+        // INTCON=0：与上次电平比较；INTCON=1：与DEFVAL比较
+        const uint8_t fire = enabled & ((~intcon & (before ^ now)) | (intcon & (now ^ regs_[SIM_MCP_DEFVALA + port])));
+        if (fire && regs_[SIM_MCP_INTFA + port] == 0) {
+            regs_[SIM_MCP_INTCAPA + port] = read_reg(SIM_MCP_GPIOA + port);
+        }
+        regs_[SIM_MCP_INTFA + port] |= fire;
+    }
+    update_int_pin();
+}
+
+void SimMCP23S17::connect_int_pin(uint8_t pin) {
+    int_pin_ = pin;
+    update_int_pin();
+}
+
+void SimMCP23S17::update_int_pin() {
+    if (int_pin_ == 0xFF) {
+        return;
+    }
+    const bool mirror = regs_[SIM_MCP_IOCON] & SIM_MCP_IOCON_MIRROR;
+    const bool asserted = regs_[SIM_MCP_INTFA] || (mirror && regs_[SIM_MCP_INTFA + 1]);
+    SimGPIO::set_input(int_pin_, !asserted);
+}
+
+uint16_t SimMCP23S17::get_outputs() const {
+    return static_cast<uint16_t>(regs_[SIM_MCP_OLATA] | (regs_[SIM_MCP_OLATB] << 8));
+}
+
+uint8_t SimMCP23S17::read_reg(uint8_t reg) const {
+    if (reg == SIM_MCP_GPIOA || reg == SIM_MCP_GPIOB) {
+        uint8_t port = reg - SIM_MCP_GPIOA;
+        uint8_t dir = regs_[SIM_MCP_IODIRA + port];
+        uint8_t pol = regs_[SIM_MCP_IPOLA + port];
+        uint8_t in = static_cast<uint8_t>(inputs_ >> (port * 8));
+        uint8_t out = regs_[SIM_MCP_OLATA + port];
+        return static_cast<uint8_t>(((in ^ pol) & dir) | (out & ~dir));
+    }
+    return reg < sizeof(regs_) ? regs_[reg] : 0;
+}
+
+void SimMCP23S17::on_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t tx = tx_data ? tx_data[i] : 0x00;
+        uint8_t rx = 0xFF;
+        if (frame_pos_ == 0) {
+            opcode_ = tx;
+        } else if (frame_pos_ == 1) {
+            pointer_ = tx;
+        } else {
+            bool read = opcode_ & 0x01;
+            if (read) {
+                rx = read_reg(pointer_);
+                // 读取GPIO或INTCAP清除对应端口的中断
+                if (pointer_ == SIM_MCP_GPIOA || pointer_ == SIM_MCP_GPIOB) {
+                    regs_[SIM_MCP_INTFA + pointer_ - SIM_MCP_GPIOA] = 0;
+                    update_int_pin();
+                } else if (pointer_ == SIM_MCP_INTCAPA || pointer_ == SIM_MCP_INTCAPA + 1) {
+                    regs_[SIM_MCP_INTFA + pointer_ - SIM_MCP_INTCAPA] = 0;
+                    update_int_pin();
+                }
+            } else if (pointer_ < sizeof(regs_)) {
+                if (pointer_ == SIM_MCP_IOCON || pointer_ == SIM_MCP_IOCON2) {
+                    regs_[SIM_MCP_IOCON] = regs_[SIM_MCP_IOCON2] = tx;
+                } else if (pointer_ == SIM_MCP_GPIOA || pointer_ == SIM_MCP_GPIOB) {
+                    regs_[pointer_ + 2] = tx;   // 写GPIO等同写OLAT
+                } else {
+                    regs_[pointer_] = tx;
+                }
+            }
+            if (!(regs_[SIM_MCP_IOCON] & SIM_MCP_IOCON_SEQOP)) {
+                pointer_ = (pointer_ + 1) % sizeof(regs_);
+            }
+        }
+        if (frame_pos_ < 2) frame_pos_++;
+        if (rx_data) rx_data[i] = rx;
+    }
+}
+
+SimPSoC::SimPSoC() : touch_mask_(0), pointer_(0) {
+    memset(regs_, 0, sizeof(regs_));
+    regs_[SIM_PSOC_SCAN_RATE] = 1000;
+}
+
+bool SimPSoC::on_write(const uint8_t* data, size_t length) {
+    if (length == 0) {
+        return true;
+    }
+    pointer_ = data[0];
+    for (size_t i = 1; i + 1 < length && pointer_ < SIM_PSOC_REG_COUNT; i += 2) {
+        if (pointer_ != SIM_PSOC_SCAN_RATE && pointer_ != SIM_PSOC_TOUCH_STATUS) {
+            regs_[pointer_] = static_cast<uint16_t>((data[i] << 8) | data[i + 1]);
+        }
+        pointer_++;
+    }
+    return true;
+}
+
+bool SimPSoC::on_read(uint8_t* buffer, size_t length) {
+    uint8_t reg = pointer_;
+    for (size_t i = 0; i < length; i += 2) {
+        uint16_t value = 0;
+        if (reg == SIM_PSOC_TOUCH_STATUS) {
+            value = touch_mask_;
+        } else if (reg < SIM_PSOC_REG_COUNT) {
+            value = regs_[reg];
+        }
+        buffer[i] = static_cast<uint8_t>(value >> 8);
+        if (i + 1 < length) buffer[i + 1] = static_cast<uint8_t>(value & 0xFF);
+        reg++;
+    }
+    return true;
+}
+
+// AD7147 寄存器地址
+#define SIM_AD7147_PWR_CONTROL      0x000
+#define SIM_AD7147_AMB_COMP_CTRL0   0x002
+#define SIM_AD7147_LOW_INT_EN       0x005
+#define SIM_AD7147_HIGH_INT_EN      0x006
+#define SIM_AD7147_COMPLETE_INT_EN  0x007
+#define SIM_AD7147_LOW_INT_STATUS   0x008
+#define SIM_AD7147_HIGH_INT_STATUS  0x009
+#define SIM_AD7147_COMPLETE_INT_STATUS 0x00A
+#define SIM_AD7147_CDC_RESULT_S0    0x00B
+#define SIM_AD7147_DEVICE_ID        0x017
+#define SIM_AD7147_STAGE_BANK       0x080
+#define SIM_AD7147_STAGE_BANK_END   (SIM_AD7147_STAGE_BANK + 12 * 8)
+#define SIM_AD7147_DEVICE_ID_VALUE  0x1472
+
+// AD7147 模拟前端参数
+#define SIM_AD7147_CDC_MID          0x8000
+#define SIM_AD7147_CODES_PER_PF     4096    // ±8pF 满量程
+#define SIM_AD7147_AFE_LSB_FF       320     // AFE偏移 1LSB = 0.32pF
+#define SIM_AD7147_PARASITIC_FF     7800    // CIN0默认寄生电容，往后每个电极递增 SIM_AD7147_PARASITIC_STEP_FF
+#define SIM_AD7147_PARASITIC_STEP_FF 150
+#define SIM_AD7147_STAGE_TIME_US    768     // 抽取64时单阶段转换时间，抽取128/256依次翻倍
+#define SIM_AD7147_LP_DELAY_US      200000  // 低功耗模式序列间隔单位
+
+SimAD7147::SimAD7147()
+    : pointer_(0), int_pin_(0xFF), int_asserted_(false), noise_amplitude_(0), noise_state_(0x7147),
+      conversion_event_(0), last_read_sequence_(0), stats_{} {
+    memset(regs_, 0, sizeof(regs_));
+    memset(stage_regs_, 0, sizeof(stage_regs_));
+    memset(electrode_ff_, 0, sizeof(electrode_ff_));
+    memset(cdc_, 0, sizeof(cdc_));
+    for (uint8_t cin = 0; cin < 13; cin++) {
+        parasitic_ff_[cin] = SIM_AD7147_PARASITIC_FF + cin * SIM_AD7147_PARASITIC_STEP_FF;
+    }
+    regs_[SIM_AD7147_DEVICE_ID] = SIM_AD7147_DEVICE_ID_VALUE;
+}
+
+void SimAD7147::set_parasitic_ff(uint8_t cin, int32_t parasitic_ff) {
+    if (cin < 13) parasitic_ff_[cin] = parasitic_ff;
+}
+
+void SimAD7147::set_electrode_ff(uint8_t cin, int32_t delta_ff) {
+    if (cin < 13) electrode_ff_[cin] = delta_ff;
+}
+
+void SimAD7147::set_touch_mask(uint16_t cin_mask, int32_t touch_ff) {
+    for (uint8_t cin = 0; cin < 13; cin++) {
+        electrode_ff_[cin] = (cin_mask & (1u << cin)) ? touch_ff : 0;
+    }
+}
+
+void SimAD7147::connect_int_pin(uint8_t pin) {
+    int_pin_ = pin;
+    update_int_pin();
+}
+
+void SimAD7147::update_int_pin() {
+    if (int_pin_ == 0xFF) {
+        return;
+    }
+    const bool active_high = regs_[SIM_AD7147_PWR_CONTROL] & (1u << 11);
+    SimGPIO::set_input(int_pin_, int_asserted_ == active_high);
+}
+
+uint32_t SimAD7147::sequence_time_us() const {
+    const uint16_t pwr = regs_[SIM_AD7147_PWR_CONTROL];
+    const uint8_t stages = ((pwr >> 4) & 0x0F) + 1;
+    const uint8_t decimation = (pwr >> 8) & 0x03;   // 0=256 1=128 2/3=64
+    const uint32_t stage_us = SIM_AD7147_STAGE_TIME_US << (decimation >= 2 ? 0 : 2 - decimation);
+    return stages * stage_us;
+}
+
+// 电源模式/序列长度/抽取改变或转换复位后从阶段0重新开始；上电后首次写入PWR_CONTROL才开始转换
+void SimAD7147::restart_conversion() {
+    if (conversion_event_) {
+        SimClock::cancel(conversion_event_);
+        conversion_event_ = 0;
+    }
+    const uint8_t power_mode = regs_[SIM_AD7147_PWR_CONTROL] & 0x03;
+    if (power_mode == 0x01 || power_mode == 0x03) {
+        return;   // 关断
+    }
+    uint32_t delay_us = sequence_time_us();
+    if (power_mode == 0x02) {
+        delay_us += SIM_AD7147_LP_DELAY_US * (((regs_[SIM_AD7147_PWR_CONTROL] >> 2) & 0x03) + 1);
+    }
+    conversion_event_ = SimClock::schedule_after(delay_us, [this]() {
+        conversion_event_ = 0;
+        complete_sequence();
+        restart_conversion();
+    });
+}
+
+int32_t SimAD7147::stage_cdc(uint8_t stage) {
+    const uint16_t* bank = &stage_regs_[stage * 8];
+    const uint16_t connection_6_0 = bank[0];
+    const uint16_t connection_12_7 = bank[1];
+    const uint16_t afe = bank[2];
+
+    // 每个CIN两位：01接负输入，10接正输入 (00悬空/11偏置不参与测量)
+    int32_t capacitance_ff = 0;
+    for (uint8_t cin = 0; cin < 13; cin++) {
+        const uint8_t code = cin < 7 ? (connection_6_0 >> (cin * 2)) & 0x03 : (connection_12_7 >> ((cin - 7) * 2)) & 0x03;
+        const int32_t electrode_ff = parasitic_ff_[cin] + electrode_ff_[cin];
+        if (code == 0x01) capacitance_ff -= electrode_ff;
+        else if (code == 0x02) capacitance_ff += electrode_ff;
+    }
+
+    // 正AFE偏移抵消正输入电容 (交换后改为抬高CDC)，负AFE偏移抵消负输入电容；CONNECTION[12:7]的位14/15可分别禁用
+    int32_t afe_steps = 0;
+    if (!(connection_12_7 & 0x8000)) {
+        const int32_t pos = (afe >> 8) & 0x3F;
+        afe_steps += (afe & 0x8000) ? pos : -pos;
+    }
+    if (!(connection_12_7 & 0x4000)) {
+        const int32_t neg = afe & 0x3F;
+        afe_steps += (afe & 0x0080) ? -neg : neg;
+    }
+    capacitance_ff += afe_steps * SIM_AD7147_AFE_LSB_FF;
+
+    int32_t noise = 0;
+    if (noise_amplitude_) {
+        noise_state_ = noise_state_ * 1664525u + 1013904223u;
+        noise = static_cast<int32_t>((noise_state_ >> 16) % (2u * noise_amplitude_ + 1)) - noise_amplitude_;
+    }
+    const int32_t cdc = SIM_AD7147_CDC_MID + capacitance_ff * SIM_AD7147_CODES_PER_PF / 1000 + noise;
+    return cdc < 0 ? 0 : (cdc > 0xFFFF ? 0xFFFF : cdc);
+}
+
+void SimAD7147::complete_sequence() {
+    const uint8_t stages = ((regs_[SIM_AD7147_PWR_CONTROL] >> 4) & 0x0F) + 1;
+    uint16_t low = 0;
+    uint16_t high = 0;
+    for (uint8_t stage = 0; stage < stages && stage < 12; stage++) {
+        cdc_[stage] = static_cast<uint16_t>(stage_cdc(stage));
+        regs_[SIM_AD7147_CDC_RESULT_S0 + stage] = cdc_[stage];
+        if (cdc_[stage] > stage_regs_[stage * 8 + 6]) high |= 1u << stage;
+        if (cdc_[stage] < stage_regs_[stage * 8 + 7]) low |= 1u << stage;
+    }
+    const uint16_t complete = static_cast<uint16_t>((1u << (stages < 12 ? stages : 12)) - 1);
+    regs_[SIM_AD7147_LOW_INT_STATUS] = low;
+    regs_[SIM_AD7147_HIGH_INT_STATUS] = high;
+    regs_[SIM_AD7147_COMPLETE_INT_STATUS] |= complete;
+    stats_.sequences++;
+
+    const uint16_t pending = (low & regs_[SIM_AD7147_LOW_INT_EN]) | (high & regs_[SIM_AD7147_HIGH_INT_EN]) |
+                             (complete & regs_[SIM_AD7147_COMPLETE_INT_EN]);
+    if (pending & 0x0FFF) {
+        int_asserted_ = true;
+        update_int_pin();
+    }
+}
+
+uint16_t SimAD7147::read_reg(uint16_t reg) {
+    if (reg >= SIM_AD7147_STAGE_BANK && reg < SIM_AD7147_STAGE_BANK_END) {
+        return stage_regs_[reg - SIM_AD7147_STAGE_BANK];
+    }
+    if (reg >= sizeof(regs_) / sizeof(regs_[0])) {
+        return 0;
+    }
+    const uint16_t value = regs_[reg];
+    if (reg == SIM_AD7147_HIGH_INT_STATUS) {
+        stats_.status_reads++;
+        if (last_read_sequence_ == stats_.sequences) stats_.stale_reads++;
+        last_read_sequence_ = stats_.sequences;
+    } else if (reg == SIM_AD7147_COMPLETE_INT_STATUS) {
+        regs_[reg] = 0;
+    }
+    if (reg >= SIM_AD7147_LOW_INT_STATUS && reg <= SIM_AD7147_COMPLETE_INT_STATUS && int_asserted_) {
+        int_asserted_ = false;
+        update_int_pin();
+    }
+    return value;
+}
+
+void SimAD7147::write_reg(uint16_t reg, uint16_t value) {
+    if (reg >= SIM_AD7147_STAGE_BANK && reg < SIM_AD7147_STAGE_BANK_END) {
+        stage_regs_[reg - SIM_AD7147_STAGE_BANK] = value;
+        stats_.config_writes++;
+        return;
+    }
+    if (reg > SIM_AD7147_COMPLETE_INT_EN) {
+        return;   // 状态/结果/ID只读
+    }
+    const uint16_t previous = regs_[reg];
+    regs_[reg] = value;
+    if (reg == SIM_AD7147_PWR_CONTROL) {
+        if (value & (1u << 10)) {
+            // 软件复位：寄存器回到上电值
+            memset(regs_, 0, sizeof(regs_));
+            memset(stage_regs_, 0, sizeof(stage_regs_));
+            regs_[SIM_AD7147_DEVICE_ID] = SIM_AD7147_DEVICE_ID_VALUE;
+            int_asserted_ = false;
+            update_int_pin();
+            restart_conversion();
+        } else if (!conversion_event_ || ((previous ^ value) & 0x03FF)) {
+            restart_conversion();
+        }
+        update_int_pin();
+    } else if (reg == SIM_AD7147_AMB_COMP_CTRL0 && (value & 0x8000)) {
+        regs_[reg] &= 0x7FFF;
+        restart_conversion();
+    }
+}
+
+bool SimAD7147::on_write(const uint8_t* data, size_t length) {
+    if (length < 2) {
+        return true;   // 地址探测
+    }
+    pointer_ = static_cast<uint16_t>(((data[0] << 8) | data[1]) & 0x03FF);
+    for (size_t i = 2; i + 1 < length; i += 2) {
+        write_reg(pointer_++, static_cast<uint16_t>((data[i] << 8) | data[i + 1]));
+    }
+    return true;
+}
+
+bool SimAD7147::on_read(uint8_t* buffer, size_t length) {
+    const uint16_t first = pointer_;
+    for (size_t i = 0; i < length; i += 2) {
+        const uint16_t value = read_reg(pointer_++);
+        buffer[i] = static_cast<uint8_t>(value >> 8);
+        if (i + 1 < length) buffer[i + 1] = static_cast<uint8_t>(value & 0xFF);
+    }
+    if (first <= SIM_AD7147_CDC_RESULT_S0 + 11 && pointer_ > SIM_AD7147_CDC_RESULT_S0) {
+        stats_.cdc_reads++;
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "sim_hal.h"
+
+/**
+ * 主机仿真 - 外设寄存器模型
+ * 只实现固件实际访问到的寄存器行为，用于让真实协议层代码在仿真总线上完成初始化与采样
+ */
+
+// MCP23S17 SPI GPIO扩展器 (BANK=0 寄存器布局，地址自增)
+// 支持输入变化/比较中断：INTF/INTCAP锁存，读取对应端口的GPIO或INTCAP清除；
+// INT输出为低电平有效推挽 (不模拟INTPOL/ODR)，MIRROR=1时任一端口触发，否则只反映端口A
+class SimMCP23S17 : public SimSPIDevice {
+public:
+    SimMCP23S17();
+
+    void on_select() override;
+    void on_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override;
+
+    // 设置外部输入电平 (bit0-7=GPA, bit8-15=GPB)
+    void set_inputs(uint16_t levels);
+    uint16_t get_outputs() const;
+
+    // 把INT输出接到MCU引脚 (通过SimGPIO注入电平，可触发MCU边沿中断)
+    void connect_int_pin(uint8_t pin);
+
+private:
+    uint8_t regs_[0x16];
+    uint16_t inputs_;
+    uint8_t int_pin_;
+    uint8_t frame_pos_;
+    uint8_t opcode_;
+    uint8_t pointer_;
+
+    uint8_t read_reg(uint8_t reg) const;
+    void update_int_pin();
+};
+
+// PSoC I2C从机触摸模块 (16位大端寄存器)
+class SimPSoC : public SimI2CDevice {
+public:
+    SimPSoC();
+
+    bool on_write(const uint8_t* data, size_t length) override;
+    bool on_read(uint8_t* buffer, size_t length) override;
+
+    // 设置当前触摸状态 (bit0-11对应CAP0-CAPB)
+    void set_touch_mask(uint16_t mask) { touch_mask_ = mask & 0x0FFF; }
+    uint16_t get_touch_mask() const { return touch_mask_; }
+
+private:
+    uint16_t regs_[0x1B];
+    uint16_t touch_mask_;
+    uint8_t pointer_;
+};
+
+// AD7147 电容触摸控制器 (16位寄存器地址与数据，大端，地址自增)
+// 行为模型：寄存器文件 + 全功率连续转换时序 + 按阶段连接寄存器解码CIN电极后由脚本电容生成CDC +
+// 阈值比较 + 中断状态与INT输出。电容以fF为单位，CDC = 中点 + (AFE偏移 + 正输入电容 - 负输入电容) * 码/fF。
+// 简化：不模拟环境补偿与自适应阈值，高/低阈值比较点固定取阶段的OFFSET_HIGH_CLAMP/OFFSET_LOW_CLAMP
+// (驱动校准即以CDC越过该点为不触发判据)；高/低状态为最近一次转换的比较结果，完成状态锁存至读取；
+// INT在序列结束且有使能的状态位时拉低 (INT_POL=1时拉高)，读取0x008-0x00A任一状态寄存器释放
+class SimAD7147 : public SimI2CDevice {
+public:
+    SimAD7147();
+
+    bool on_write(const uint8_t* data, size_t length) override;
+    bool on_read(uint8_t* buffer, size_t length) override;
+
+    // 设置电极CINx的外部电容变化 (fF，触摸为正)，下一次转换生效
+    void set_electrode_ff(uint8_t cin, int32_t delta_ff);
+    // 按掩码设置触摸电极 (bit0-12对应CIN0-CIN12)，touch_ff为单个手指带来的电容变化
+    void set_touch_mask(uint16_t cin_mask, int32_t touch_ff);
+    // 电极寄生电容 (fF)，默认CIN0为7.8pF依次递增0.15pF，AFE偏移为0时CDC饱和，需校准后才能正常检测
+    void set_parasitic_ff(uint8_t cin, int32_t parasitic_ff);
+    // CDC噪声幅度 (码，均匀分布±amplitude，固定种子保证可复现)
+    void set_noise(uint16_t amplitude) { noise_amplitude_ = amplitude; }
+
+    // 把INT输出接到MCU引脚
+    void connect_int_pin(uint8_t pin);
+
+    // 统计
+    struct Statistics {
+        uint32_t sequences;        // 完成的转换序列数
+        uint32_t status_reads;     // 读取高阈值状态寄存器的次数 (即采样次数)
+        uint32_t stale_reads;      // 两次读取之间没有新转换的采样 (重复数据)
+        uint32_t cdc_reads;        // 读取CDC结果寄存器的事务数
+        uint32_t config_writes;    // 写入阶段配置寄存器的字数
+    };
+    const Statistics& get_statistics() const { return stats_; }
+    // 单个序列的转换时间 (us)
+    uint32_t sequence_time_us() const;
+    uint16_t get_cdc(uint8_t stage) const { return stage < 12 ? cdc_[stage] : 0; }
+
+private:
+    uint16_t regs_[0x18];          // 0x000-0x017 控制/状态/CDC结果/设备ID
+    uint16_t stage_regs_[12 * 8];  // 0x080-0x0DF 阶段配置
+    int32_t parasitic_ff_[13];
+    int32_t electrode_ff_[13];
+    uint16_t cdc_[12];
+    uint16_t pointer_;
+    uint8_t int_pin_;
+    bool int_asserted_;
+    uint16_t noise_amplitude_;
+    uint32_t noise_state_;
+    uint32_t conversion_event_;
+    uint32_t last_read_sequence_;
+    Statistics stats_;
+
+    uint16_t read_reg(uint16_t reg);
+    void write_reg(uint16_t reg, uint16_t value);
+    void restart_conversion();
+    void complete_sequence();
+    int32_t stage_cdc(uint8_t stage);
+    void update_int_pin();
+};
@@ -0,0 +1,79 @@
+#include "../global_irq.h"
+#include <hardware/dma.h>
+#include <string.h>
+
+/**
+ * 全局DMA中断管理 - 主机仿真版本
+ * 接口与 global_irq.c 相同；仿真外设在传输完成事件中调用 global_irq_trigger_dma_callback
+ */
+
+// DMA通道最大数量（与RP2040一致）
+#define MAX_DMA_CHANNELS 12
+
+static dma_channel_info_t dma_channels[MAX_DMA_CHANNELS];
+static uint16_t dma_claimed_mask = 0;
+static bool global_irq_initialized = false;
+
+void global_irq_init(void) {
+    if (global_irq_initialized) {
+        return;
+    }
+    memset(dma_channels, 0, sizeof(dma_channels));
+    global_irq_initialized = true;
+}
+
+void global_irq_deinit(void) {
+    memset(dma_channels, 0, sizeof(dma_channels));
+    global_irq_initialized = false;
+}
+
+bool global_irq_register_dma_callback(uint8_t channel, dma_callback_func_t callback) {
+    if (channel >= MAX_DMA_CHANNELS || !callback) {
+        return false;
+    }
+    dma_channels[channel].callback = callback;
+    dma_channels[channel].user_data = NULL;
+    dma_channels[channel].active = true;
+    return true;
+}
+
+void global_irq_unregister_dma_callback(uint8_t channel) {
+    if (channel >= MAX_DMA_CHANNELS) {
+        return;
+    }
+    dma_channels[channel].callback = NULL;
+    dma_channels[channel].active = false;
+}
+
+bool global_irq_is_dma_callback_registered(uint8_t channel) {
+    if (channel >= MAX_DMA_CHANNELS) {
+        return false;
+    }
+    return dma_channels[channel].active && dma_channels[channel].callback;
+}
+
+void global_irq_trigger_dma_callback(uint8_t channel, bool success) {
+    if (channel >= MAX_DMA_CHANNELS) {
+        return;
+    }
+    if (dma_channels[channel].active && dma_channels[channel].callback) {
+        dma_channels[channel].callback(success);
+    }
+}
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    for (int channel = 0; channel < MAX_DMA_CHANNELS; channel++) {
+        if (!(dma_claimed_mask & (1u << channel))) {
+            dma_claimed_mask |= (uint16_t)(1u << channel);
+            return channel;
+        }
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(unsigned int channel) {
+    if (channel < MAX_DMA_CHANNELS) {
+        dma_claimed_mask &= (uint16_t)~(1u << channel);
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include "../i2c/hal_i2c.h"
+
+/**
+ * HAL层 - 主机仿真后端控制接口
+ * 仿真后端以链接替换方式实现 HAL_I2C/HAL_UART/HAL_SPI/HAL_PIO/HAL_USB 与 pico 时间/GPIO 原语，
+ * 协议层与服务层代码无需修改即可在 Linux 上运行。
+ * 所有时间来自 SimClock 虚拟时钟，外设的DMA/中断完成以事件形式挂在虚拟时钟上按时派发，
+ * 因此同一输入在任何主机上都得到完全相同的时序结果。
+ */
+
+// 虚拟时钟与事件调度
+class SimClock {
+public:
+    using event_callback_t = std::function<void()>;
+
+    // 当前虚拟时间 (us)
+    static uint64_t now_us();
+
+    // 推进虚拟时钟并按时间顺序派发期间到期的事件
+    static void advance_us(uint64_t us);
+    static void advance_to(uint64_t target_us);
+
+    // 派发所有已到期的事件，返回是否派发过事件
+    static bool run_pending();
+
+    // 在指定虚拟时间挂载事件，返回事件ID
+    static uint32_t schedule_at(uint64_t due_us, event_callback_t callback);
+    static uint32_t schedule_after(uint64_t delay_us, event_callback_t callback);
+    static void cancel(uint32_t event_id);
+
+    // 最近一个待派发事件的时间，无事件时返回 UINT64_MAX
+    static uint64_t next_event_us();
+
+    // 当前执行上下文所在核心，供 get_core_num() 返回
+    static void set_core(uint8_t core);
+    static uint8_t current_core();
+
+    // 忙等(tight_loop_contents)每次推进的虚拟时间，默认1us
+    static void set_busy_wait_step_us(uint32_t step_us);
+    static uint32_t busy_wait_step_us();
+
+    // 清空事件并将时钟归零
+    static void reset();
+};
+
+// GPIO 仿真 - 外部输入电平注入，支持边沿中断回调
+class SimGPIO {
+public:
+    // 设置单个输入引脚电平，会按使能的边沿触发GPIO中断回调
+    static void set_input(uint8_t pin, bool level);
+    // 批量设置输入电平 (bit对应GPIO编号)
+    static void set_inputs(uint32_t levels, uint32_t mask = 0x3FFFFFFF);
+    // 读取MCU输出寄存器
+    static uint32_t outputs();
+};
+
+// I2C 从设备模型接口
+class SimI2CDevice {
+public:
+    virtual ~SimI2CDevice() = default;
+
+    // 主机写入阶段 (包含寄存器地址字节)，返回false表示NACK
+    virtual bool on_write(const uint8_t* data, size_t length) = 0;
+
+    // 主机读取阶段，返回false表示NACK
+    virtual bool on_read(uint8_t* buffer, size_t length) = 0;
+};
+
+// I2C 总线仿真 - 设备挂载与总线时序
+class SimI2C {
+public:
+    static void attach(I2C_Bus bus, uint8_t address, SimI2CDevice* device);
+    static void detach(I2C_Bus bus, uint8_t address);
+    static SimI2CDevice* find(I2C_Bus bus, uint8_t address);
+
+    // 按当前总线频率计算一次事务耗时 (地址+数据字节，每字节9位)
+    static uint32_t transaction_time_us(I2C_Bus bus, size_t write_length, size_t read_length);
+
+    // 总线统计
+    struct Statistics {
+        uint32_t transactions;
+        uint32_t async_transactions;
+        uint32_t nacks;
+        uint64_t busy_time_us;
+    };
+    static Statistics get_statistics(I2C_Bus bus);
+    static void reset_statistics();
+};
+
+// SPI 从设备模型接口
+class SimSPIDevice {
+public:
+    virtual ~SimSPIDevice() = default;
+
+    // 片选拉低 (开始帧)
+    virtual void on_select() {}
+    // 片选释放 (结束帧)
+    virtual void on_deselect() {}
+    // 全双工传输，tx_data 为空时发送0x00，rx_data 为空时丢弃读回数据
+    virtual void on_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) = 0;
+};
+
+// SPI 总线仿真 - 以片选引脚区分设备
+class SimSPI {
+public:
+    static void attach(uint8_t spi_index, uint8_t cs_pin, SimSPIDevice* device);
+    static void detach(uint8_t spi_index, uint8_t cs_pin);
+
+    // 由GPIO仿真在输出电平变化时调用，用于产生片选帧边界
+    static void on_cs_changed(uint8_t pin);
+};
+
+// UART 仿真 - TX抓取与RX注入
+class SimUART {
+public:
+    // TX观察者：在DMA开始发送时调用，参数为数据、长度、发送开始时间、发送完成时间
+    using tx_observer_t = std::function<void(const uint8_t* data, size_t length, uint64_t start_us, uint64_t end_us)>;
+
+    static void set_tx_observer(uint8_t uart_index, tx_observer_t observer);
+
+    // 以当前波特率逐字节注入接收数据
+    static void inject_rx(uint8_t uart_index, const uint8_t* data, size_t length);
+
+    // 单字节发送耗时 (8N1 = 10位)
+    static uint32_t byte_time_us(uint8_t uart_index);
+
+    // 已发送字节统计
+    static uint64_t tx_byte_count(uint8_t uart_index);
+};
+
+// USB 仿真 - CDC与HID报告
+class SimUSB {
+public:
+    using cdc_observer_t = std::function<void(const uint8_t* data, size_t length)>;
+    using hid_observer_t = std::function<void(uint8_t report_id, const uint8_t* data, size_t length, uint64_t timestamp_us)>;
+
+    // CDC输出观察者，未设置时输出到标准输出
+    static void set_cdc_observer(cdc_observer_t observer);
+    static void set_hid_observer(hid_observer_t observer);
+
+    // 模拟主机向CDC端口写入数据
+    static void inject_cdc(const uint8_t* data, size_t length);
+
+    // 模拟USB连接状态
+    static void set_mounted(bool mounted);
+
+    static uint32_t hid_report_count();
+};
+
+// PIO 仿真 - 统计写入状态机FIFO的数据
+class SimPIO {
+public:
+    static uint64_t tx_word_count(uint8_t pio_index);
+};
+
+// 文件系统仿真 - 主机文件与仿真LittleFS之间的导入导出
+class SimFS {
+public:
+    // 将主机文件内容写入仿真LittleFS，文件系统未挂载时也可调用 (在ConfigManager初始化前预置配置)
+    static bool import_host_file(const char* host_path, const char* fs_path);
+    // 将仿真LittleFS中的文件写出到主机
+    static bool export_host_file(const char* fs_path, const char* host_path);
+};
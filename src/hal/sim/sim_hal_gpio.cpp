@@ -0,0 +1,145 @@
+#include "sim_hal.h"
+#include <hardware/gpio.h>
+#include <hardware/structs/sio.h>
+
+/**
+ * GPIO 仿真
+ * 输出引脚电平回读到 gpio_in，与RP2040的SIO行为一致；上拉引脚在未驱动时读为高
+ */
+
+extern "C" {
+sio_hw_t sim_sio_hw = {};
+}
+
+namespace {
+
+static uint32_t g_pull_up_mask = 0;
+static uint32_t g_external_levels = 0;     // 外部注入的电平
+static uint32_t g_external_driven = 0;     // 被外部驱动的引脚
+static uint32_t g_irq_rise_mask = 0;
+static uint32_t g_irq_fall_mask = 0;
+static gpio_irq_callback_t g_irq_callback = nullptr;
+
+// 根据方向/输出/外部驱动/上拉重新计算输入寄存器，并对变化的引脚触发边沿中断
+static void refresh_inputs() {
+    uint32_t previous = sim_sio_hw.gpio_in;
+    uint32_t oe = sim_sio_hw.gpio_oe;
+    uint32_t levels = (sim_sio_hw.gpio_out & oe)
+                    | (g_external_levels & g_external_driven & ~oe)
+                    | (g_pull_up_mask & ~g_external_driven & ~oe);
+    levels &= 0x3FFFFFFF;
+    sim_sio_hw.gpio_in = levels;
+
+    uint32_t changed = previous ^ levels;
+    if (!changed || !g_irq_callback) {
+        return;
+    }
+    uint32_t rise = changed & levels & g_irq_rise_mask;
+    uint32_t fall = changed & ~levels & g_irq_fall_mask;
+    uint32_t pending = rise | fall;
+    while (pending) {
+        uint32_t pin = __builtin_ctz(pending);
+        pending &= pending - 1;
+        uint32_t events = ((rise >> pin) & 1u ? static_cast<uint32_t>(GPIO_IRQ_EDGE_RISE) : 0u)
+                        | ((fall >> pin) & 1u ? static_cast<uint32_t>(GPIO_IRQ_EDGE_FALL) : 0u);
+        g_irq_callback(pin, events);
+    }
+}
+
+} // namespace
+
+void SimGPIO::set_input(uint8_t pin, bool level) {
+    if (pin >= NUM_BANK0_GPIOS) return;
+    uint32_t bit = 1u << pin;
+    g_external_driven |= bit;
+    g_external_levels = level ? (g_external_levels | bit) : (g_external_levels & ~bit);
+    refresh_inputs();
+}
+
+void SimGPIO::set_inputs(uint32_t levels, uint32_t mask) {
+    mask &= 0x3FFFFFFF;
+    g_external_driven |= mask;
+    g_external_levels = (g_external_levels & ~mask) | (levels & mask);
+    refresh_inputs();
+}
+
+uint32_t SimGPIO::outputs() {
+    return sim_sio_hw.gpio_out;
+}
+
+extern "C" {
+
+void gpio_init(unsigned int gpio) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    uint32_t bit = 1u << gpio;
+    sim_sio_hw.gpio_oe &= ~bit;
+    sim_sio_hw.gpio_out &= ~bit;
+    refresh_inputs();
+}
+
+void gpio_set_function(unsigned int gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    uint32_t bit = 1u << gpio;
+    sim_sio_hw.gpio_oe = out ? (sim_sio_hw.gpio_oe | bit) : (sim_sio_hw.gpio_oe & ~bit);
+    refresh_inputs();
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    uint32_t bit = 1u << gpio;
+    uint32_t previous = sim_sio_hw.gpio_out;
+    sim_sio_hw.gpio_out = value ? (sim_sio_hw.gpio_out | bit) : (sim_sio_hw.gpio_out & ~bit);
+    refresh_inputs();
+    if (previous != sim_sio_hw.gpio_out) {
+        SimSPI::on_cs_changed(static_cast<uint8_t>(gpio));
+    }
+}
+
+bool gpio_get(unsigned int gpio) {
+    if (gpio >= NUM_BANK0_GPIOS) return false;
+    return (sim_sio_hw.gpio_in >> gpio) & 1u;
+}
+
+void gpio_pull_up(unsigned int gpio) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    g_pull_up_mask |= 1u << gpio;
+    refresh_inputs();
+}
+
+void gpio_pull_down(unsigned int gpio) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    g_pull_up_mask &= ~(1u << gpio);
+    refresh_inputs();
+}
+
+void gpio_disable_pulls(unsigned int gpio) {
+    gpio_pull_down(gpio);
+}
+
+void gpio_set_irq_enabled(unsigned int gpio, uint32_t event_mask, bool enabled) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    uint32_t bit = 1u << gpio;
+    if (event_mask & GPIO_IRQ_EDGE_RISE) {
+        g_irq_rise_mask = enabled ? (g_irq_rise_mask | bit) : (g_irq_rise_mask & ~bit);
+    }
+    if (event_mask & GPIO_IRQ_EDGE_FALL) {
+        g_irq_fall_mask = enabled ? (g_irq_fall_mask | bit) : (g_irq_fall_mask & ~bit);
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    g_irq_callback = callback;
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+}
+
+void gpio_acknowledge_irq(unsigned int gpio, uint32_t event_mask) {
+    (void)gpio;
+    (void)event_mask;
+}
+
+} // extern "C"
@@ -0,0 +1,381 @@
+#include "sim_hal.h"
+#include "../i2c/hal_i2c.h"
+#include <pico/stdlib.h>
+#include <cstring>
+#include <map>
+
+/**
+ * HAL_I2C - 主机仿真实现
+ * 同步接口立即完成事务并按总线时序推进虚拟时钟；
+ * 异步接口占用总线，在事务结束时刻以事件形式执行设备读写并回调，等价于DMA+STOP_DET中断
+ */
+
+extern "C" {
+i2c_inst_t sim_i2c0_inst = {0};
+i2c_inst_t sim_i2c1_inst = {1};
+}
+
+namespace {
+
+struct SimI2CBusState {
+    uint32_t frequency = 400000;
+    std::map<uint8_t, SimI2CDevice*> devices;
+    SimI2C::Statistics statistics = {};
+};
+
+static SimI2CBusState g_i2c_bus[2];
+
+static inline uint8_t bus_index(const i2c_inst_t* inst) {
+    return inst ? (inst->hw_index & 0x01) : 0;
+}
+
+// 执行一次完整事务：写阶段(可选) + 读阶段(可选)，任一阶段NACK即失败
+static bool run_transaction(uint8_t bus, uint8_t address, const uint8_t* wbuf, size_t wlen, uint8_t* rbuf, size_t rlen) {
+    SimI2CBusState& state = g_i2c_bus[bus];
+    state.statistics.transactions++;
+    auto it = state.devices.find(address);
+    if (it == state.devices.end() || !it->second) {
+        state.statistics.nacks++;
+        return false;
+    }
+    if (wlen && !it->second->on_write(wbuf, wlen)) {
+        state.statistics.nacks++;
+        return false;
+    }
+    if (rlen && !it->second->on_read(rbuf, rlen)) {
+        state.statistics.nacks++;
+        return false;
+    }
+    return true;
+}
+
+// 同步事务占用总线的时间直接计入虚拟时钟
+static inline void consume_bus_time(uint8_t bus, size_t wlen, size_t rlen) {
+    uint32_t cost = SimI2C::transaction_time_us(static_cast<I2C_Bus>(bus), wlen, rlen);
+    g_i2c_bus[bus].statistics.busy_time_us += cost;
+    SimClock::advance_us(cost);
+}
+
+} // namespace
+
+void SimI2C::attach(I2C_Bus bus, uint8_t address, SimI2CDevice* device) {
+    g_i2c_bus[static_cast<uint8_t>(bus) & 0x01].devices[address & 0x7F] = device;
+}
+
+void SimI2C::detach(I2C_Bus bus, uint8_t address) {
+    g_i2c_bus[static_cast<uint8_t>(bus) & 0x01].devices.erase(address & 0x7F);
+}
+
+SimI2CDevice* SimI2C::find(I2C_Bus bus, uint8_t address) {
+    SimI2CBusState& state = g_i2c_bus[static_cast<uint8_t>(bus) & 0x01];
+    auto it = state.devices.find(address & 0x7F);
+    return it == state.devices.end() ? nullptr : it->second;
+}
+
+uint32_t SimI2C::transaction_time_us(I2C_Bus bus, size_t write_length, size_t read_length) {
+    uint32_t frequency = g_i2c_bus[static_cast<uint8_t>(bus) & 0x01].frequency;
+    // START + 地址字节 + 写数据，读阶段另有 RESTART + 地址字节，末尾 STOP；每字节含ACK共9位
+    uint32_t bits = 1 + 9 * (1 + write_length) + 1;
+    if (read_length) {
+        bits += 1 + 9 * (1 + read_length);
+    }
+    return (bits * 1000000u + frequency - 1) / frequency;
+}
+
+SimI2C::Statistics SimI2C::get_statistics(I2C_Bus bus) {
+    return g_i2c_bus[static_cast<uint8_t>(bus) & 0x01].statistics;
+}
+
+void SimI2C::reset_statistics() {
+    g_i2c_bus[0].statistics = {};
+    g_i2c_bus[1].statistics = {};
+}
+
+// HAL_I2C 基类实现
+HAL_I2C::HAL_I2C(i2c_inst_t* i2c_instance)
+    : i2c_instance_(i2c_instance), initialized_(false), sda_pin_(0), scl_pin_(0),
+      dma_status_(DMA_Status::IDLE), dma_tx_channel_(-1), dma_rx_channel_(-1),
+      interrupts_enabled_(false), last_abort_nack_(false), read_cmd_(0) {
+    dma_context_ = DMA_Context();
+    memset(data_cmds_, 0, sizeof(data_cmds_));
+}
+
+bool HAL_I2C::init(uint8_t sda_pin, uint8_t scl_pin, uint32_t frequency) {
+    if (initialized_) {
+        return true;
+    }
+    sda_pin_ = sda_pin;
+    scl_pin_ = scl_pin;
+    g_i2c_bus[bus_index(i2c_instance_)].frequency = frequency ? frequency : 100000;
+    dma_status_ = DMA_Status::IDLE;
+    initialized_ = true;
+    return true;
+}
+
+void HAL_I2C::deinit() {
+    if (!initialized_) return;
+    dma_status_ = DMA_Status::IDLE;
+    initialized_ = false;
+}
+
+void HAL_I2C::unlock_bus(uint8_t sda_pin, uint8_t scl_pin, uint32_t pulse_delay_us) {
+    (void)sda_pin;
+    (void)scl_pin;
+    (void)pulse_delay_us;
+}
+
+bool HAL_I2C::write(uint8_t address, const uint8_t* data, size_t length) {
+    if (!initialized_ || !_wait_for_bus_idle(10)) return false;
+    uint8_t bus = bus_index(i2c_instance_);
+    consume_bus_time(bus, length, 0);
+    return run_transaction(bus, address, data, length, nullptr, 0);
+}
+
+bool HAL_I2C::read(uint8_t address, uint8_t* buffer, size_t length) {
+    if (!initialized_ || !_wait_for_bus_idle(10)) return false;
+    uint8_t bus = bus_index(i2c_instance_);
+    consume_bus_time(bus, 0, length);
+    return run_transaction(bus, address, nullptr, 0, buffer, length);
+}
+
+int32_t HAL_I2C::write_register(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length) {
+    if (!initialized_ || !_wait_for_bus_idle(10)) return -1;
+
+    uint8_t reg_size = reg & 0xFF00 ? 2 : reg & 0x8000 ? 2 : 1;
+    uint8_t data[2 + 256];
+    data[0] = reg & 0xFF;
+    if (reg_size == 2) {
+        data[0] = (reg >> 8) & 0x7F;
+        data[1] = reg & 0xFF;
+    }
+    memcpy(data + reg_size, value, length);
+
+    uint8_t bus = bus_index(i2c_instance_);
+    consume_bus_time(bus, reg_size + length, 0);
+    last_abort_nack_ = !run_transaction(bus, address, data, reg_size + length, nullptr, 0);
+    return last_abort_nack_ ? -1 : length;
+}
+
+int32_t HAL_I2C::read_register(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length) {
+    if (!initialized_ || !_wait_for_bus_idle(10)) return -1;
+
+    uint8_t reg_size = reg & 0xFF00 ? 2 : reg & 0x8000 ? 2 : 1;
+    uint8_t data[2];
+    data[0] = (uint8_t)(reg & 0xFF);
+    if (reg_size == 2) {
+        data[0] = (reg >> 8) & 0x7F;
+        data[1] = reg & 0xFF;
+    }
+
+    uint8_t bus = bus_index(i2c_instance_);
+    consume_bus_time(bus, reg_size, length);
+    last_abort_nack_ = !run_transaction(bus, address, data, reg_size, value, length);
+    return last_abort_nack_ ? -1 : length;
+}
+
+bool HAL_I2C::device_exists(uint8_t address) {
+    if (!initialized_) return false;
+    uint8_t bus = bus_index(i2c_instance_);
+    consume_bus_time(bus, 0, 1);
+    return g_i2c_bus[bus].devices.count(address & 0x7F) != 0;
+}
+
+std::vector<uint8_t> HAL_I2C::scan_devices() {
+    std::vector<uint8_t> found_devices;
+    if (!initialized_) return found_devices;
+    for (uint8_t addr = 0x08; addr <= 0x77; addr++) {
+        if (device_exists(addr)) {
+            found_devices.push_back(addr);
+        }
+    }
+    return found_devices;
+}
+
+bool HAL_I2C::read_async(uint8_t address, uint8_t* buffer, size_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_status_ != DMA_Status::IDLE || !buffer || length == 0) {
+        return false;
+    }
+    dma_context_.device_addr = address;
+    dma_context_.buffer = buffer;
+    dma_context_.length = length;
+    dma_context_.is_write = false;
+    dma_context_.callback = callback;
+    dma_context_.is_register_op = false;
+    return _setup_dma_read(address, buffer, length);
+}
+
+bool HAL_I2C::write_async(uint8_t address, const uint8_t* data, size_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_status_ != DMA_Status::IDLE || !data || length == 0) {
+        return false;
+    }
+    dma_context_.device_addr = address;
+    dma_context_.buffer = const_cast<uint8_t*>(data);
+    dma_context_.length = length;
+    dma_context_.is_write = true;
+    dma_context_.callback = callback;
+    dma_context_.is_register_op = false;
+    return _setup_dma_write(address, data, length);
+}
+
+bool HAL_I2C::read_register_async(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_status_ != DMA_Status::IDLE || !value || length == 0 || !callback) {
+        return false;
+    }
+    uint8_t reg_size = (reg & 0xFF00) ? 2 : (reg & 0x8000) ? 2 : 1;
+
+    dma_context_.device_addr = address;
+    dma_context_.buffer = value;
+    dma_context_.length = length;
+    dma_context_.is_write = false;
+    dma_context_.callback = callback;
+    dma_context_.is_register_op = true;
+    dma_context_.reg_addr = reg;
+    dma_context_.reg_size = reg_size;
+    dma_context_.reg_buffer = reg_write_buffer_;
+
+    if (reg_size == 2) {
+        reg_write_buffer_[0] = (reg >> 8) & 0x7F;
+        reg_write_buffer_[1] = reg & 0xFF;
+    } else {
+        reg_write_buffer_[0] = reg & 0xFF;
+    }
+    return _setup_dma_write_read(address, reg_write_buffer_, reg_size, value, length);
+}
+
+bool HAL_I2C::write_register_async(uint8_t address, uint16_t reg, uint8_t* value, uint8_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_status_ != DMA_Status::IDLE || !value || length == 0 || !callback) {
+        return false;
+    }
+    uint8_t reg_size = (reg & 0xFF00) ? 2 : (reg & 0x8000) ? 2 : 1;
+    if (reg_size + length > sizeof(reg_write_buffer_)) {
+        return false;
+    }
+
+    dma_context_.device_addr = address;
+    dma_context_.buffer = value;
+    dma_context_.length = length;
+    dma_context_.is_write = true;
+    dma_context_.callback = callback;
+    dma_context_.is_register_op = true;
+    dma_context_.reg_addr = reg;
+    dma_context_.reg_size = reg_size;
+    dma_context_.reg_buffer = reg_write_buffer_;
+
+    if (reg_size == 2) {
+        reg_write_buffer_[0] = (reg >> 8) & 0x7F;
+        reg_write_buffer_[1] = reg & 0xFF;
+    } else {
+        reg_write_buffer_[0] = reg & 0xFF;
+    }
+    memcpy(reg_write_buffer_ + reg_size, value, length);
+    return _setup_dma_write(address, reg_write_buffer_, reg_size + length);
+}
+
+bool HAL_I2C::is_busy() const {
+    return dma_status_ != DMA_Status::IDLE;
+}
+
+// 异步事务统一入口：总线在事务时长内保持忙，到期后执行设备读写并回调
+inline bool HAL_I2C::_setup_dma_write_read(uint8_t address, const uint8_t* wbuf, size_t wlen, uint8_t* rbuf, size_t rlen) {
+    if ((wlen + rlen) == 0 || (wlen + rlen) > 256) {
+        return false;
+    }
+    dma_status_ = rlen ? DMA_Status::RX_BUSY : DMA_Status::TX_BUSY;
+    last_abort_nack_ = false;
+
+    uint8_t bus = bus_index(i2c_instance_);
+    uint32_t cost = SimI2C::transaction_time_us(static_cast<I2C_Bus>(bus), wlen, rlen);
+    g_i2c_bus[bus].statistics.async_transactions++;
+    g_i2c_bus[bus].statistics.busy_time_us += cost;
+
+    // 写数据在发起时已拷贝到 reg_write_buffer_/调用方缓冲区，事件中直接引用
+    SimClock::schedule_after(cost, [this, bus, address, wbuf, wlen, rbuf, rlen]() {
+        bool success = run_transaction(bus, address, wbuf, wlen, rbuf, rlen);
+        if (!success) {
+            // 仿真中事务失败只来自设备未应答
+            last_abort_nack_ = true;
+            dma_status_ = DMA_Status::ERROR;
+        }
+        if (dma_context_.callback) {
+            dma_context_.callback(success);
+        }
+        dma_status_ = DMA_Status::IDLE;
+    });
+    return true;
+}
+
+inline bool HAL_I2C::_setup_dma_write(uint8_t address, const uint8_t* data, size_t length) {
+    if (dma_status_ != DMA_Status::IDLE) {
+        return false;
+    }
+    return _setup_dma_write_read(address, data, length, nullptr, 0);
+}
+
+inline bool HAL_I2C::_setup_dma_read(uint8_t address, uint8_t* buffer, size_t length) {
+    if (dma_status_ != DMA_Status::IDLE) {
+        return false;
+    }
+    return _setup_dma_write_read(address, nullptr, 0, buffer, length);
+}
+
+// 等待异步事务完成：推进虚拟时钟直至完成事件派发
+inline bool HAL_I2C::_wait_for_bus_idle(uint32_t timeout_ms) {
+    if (!initialized_) return false;
+    uint32_t start_time = time_us_32();
+    while (dma_status_ != DMA_Status::IDLE) {
+        if (time_us_32() - start_time >= timeout_ms * 1000) {
+            return false;
+        }
+        sleep_us(10);
+    }
+    return true;
+}
+
+void HAL_I2C::_handle_i2c_irq() {
+}
+
+void HAL_I2C::_enable_i2c_interrupts() {
+    interrupts_enabled_ = true;
+}
+
+void HAL_I2C::_disable_i2c_interrupts() {
+    interrupts_enabled_ = false;
+}
+
+// HAL_I2C0 单例
+HAL_I2C0* HAL_I2C0::instance_ = nullptr;
+
+HAL_I2C0* HAL_I2C0::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_I2C0();
+    }
+    return instance_;
+}
+
+HAL_I2C0::HAL_I2C0() : HAL_I2C(i2c0) {}
+
+HAL_I2C0::~HAL_I2C0() {
+    deinit();
+}
+
+// HAL_I2C1 单例
+HAL_I2C1* HAL_I2C1::instance_ = nullptr;
+
+HAL_I2C1* HAL_I2C1::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_I2C1();
+    }
+    return instance_;
+}
+
+HAL_I2C1::HAL_I2C1() : HAL_I2C(i2c1) {}
+
+HAL_I2C1::~HAL_I2C1() {
+    deinit();
+}
+
+void i2c0_irq_handler() {
+}
+
+void i2c1_irq_handler() {
+}
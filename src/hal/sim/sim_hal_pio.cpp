@@ -0,0 +1,204 @@
+#include "sim_hal.h"
+#include "../pio/hal_pio.h"
+#include <cstring>
+
+/**
+ * HAL_PIO - 主机仿真实现
+ * 不执行PIO程序，只记录状态机占用与写入TX FIFO的字数；FIFO视为永不满
+ */
+
+namespace {
+
+static uint64_t g_pio_tx_words[2] = {0, 0};
+
+} // namespace
+
+uint64_t SimPIO::tx_word_count(uint8_t pio_index) {
+    return g_pio_tx_words[pio_index & 0x01];
+}
+
+// HAL_PIO0 实现
+HAL_PIO0* HAL_PIO0::instance_ = nullptr;
+
+HAL_PIO0* HAL_PIO0::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_PIO0();
+    }
+    return instance_;
+}
+
+HAL_PIO0::HAL_PIO0() : initialized_(false), gpio_pin_(0) {
+    memset(configs_, 0, sizeof(configs_));
+    memset(sm_claimed_, 0, sizeof(sm_claimed_));
+}
+
+HAL_PIO0::~HAL_PIO0() {
+    deinit();
+}
+
+bool HAL_PIO0::init(uint8_t gpio_pin) {
+    gpio_pin_ = gpio_pin;
+    initialized_ = true;
+    return true;
+}
+
+void HAL_PIO0::deinit() {
+    memset(sm_claimed_, 0, sizeof(sm_claimed_));
+    initialized_ = false;
+}
+
+bool HAL_PIO0::load_program(const pio_program_t* program, uint8_t* offset) {
+    if (!initialized_ || !program || !offset) return false;
+    *offset = 0;
+    return true;
+}
+
+void HAL_PIO0::unload_program(const pio_program_t* program, uint8_t offset) {
+    (void)program;
+    (void)offset;
+}
+
+bool HAL_PIO0::claim_sm(uint8_t* sm) {
+    if (!initialized_ || !sm) return false;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!sm_claimed_[i]) {
+            sm_claimed_[i] = true;
+            *sm = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void HAL_PIO0::unclaim_sm(uint8_t sm) {
+    if (sm < 4) sm_claimed_[sm] = false;
+}
+
+bool HAL_PIO0::sm_configure(uint8_t sm, const PIOStateMachineConfig& config) {
+    (void)config;
+    return initialized_ && sm < 4 && sm_claimed_[sm];
+}
+
+void HAL_PIO0::sm_set_enabled(uint8_t sm, bool enabled) {
+    (void)sm;
+    (void)enabled;
+}
+
+void HAL_PIO0::sm_put_blocking(uint8_t sm, uint32_t data) {
+    (void)sm;
+    (void)data;
+    g_pio_tx_words[0]++;
+}
+
+bool HAL_PIO0::sm_put_nonblocking(uint8_t sm, uint32_t data) {
+    sm_put_blocking(sm, data);
+    return true;
+}
+
+uint32_t HAL_PIO0::sm_get_blocking(uint8_t sm) {
+    (void)sm;
+    return 0;
+}
+
+bool HAL_PIO0::sm_is_tx_fifo_full(uint8_t sm) {
+    (void)sm;
+    return false;
+}
+
+bool HAL_PIO0::sm_is_rx_fifo_empty(uint8_t sm) {
+    (void)sm;
+    return true;
+}
+
+// HAL_PIO1 实现
+HAL_PIO1* HAL_PIO1::instance_ = nullptr;
+
+HAL_PIO1* HAL_PIO1::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_PIO1();
+    }
+    return instance_;
+}
+
+HAL_PIO1::HAL_PIO1() : initialized_(false), gpio_pin_(0) {
+    memset(configs_, 0, sizeof(configs_));
+    memset(sm_claimed_, 0, sizeof(sm_claimed_));
+}
+
+HAL_PIO1::~HAL_PIO1() {
+    deinit();
+}
+
+bool HAL_PIO1::init(uint8_t gpio_pin) {
+    gpio_pin_ = gpio_pin;
+    initialized_ = true;
+    return true;
+}
+
+void HAL_PIO1::deinit() {
+    memset(sm_claimed_, 0, sizeof(sm_claimed_));
+    initialized_ = false;
+}
+
+bool HAL_PIO1::load_program(const pio_program_t* program, uint8_t* offset) {
+    if (!initialized_ || !program || !offset) return false;
+    *offset = 0;
+    return true;
+}
+
+void HAL_PIO1::unload_program(const pio_program_t* program, uint8_t offset) {
+    (void)program;
+    (void)offset;
+}
+
+bool HAL_PIO1::claim_sm(uint8_t* sm) {
+    if (!initialized_ || !sm) return false;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!sm_claimed_[i]) {
+            sm_claimed_[i] = true;
+            *sm = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void HAL_PIO1::unclaim_sm(uint8_t sm) {
+    if (sm < 4) sm_claimed_[sm] = false;
+}
+
+bool HAL_PIO1::sm_configure(uint8_t sm, const PIOStateMachineConfig& config) {
+    (void)config;
+    return initialized_ && sm < 4 && sm_claimed_[sm];
+}
+
+void HAL_PIO1::sm_set_enabled(uint8_t sm, bool enabled) {
+    (void)sm;
+    (void)enabled;
+}
+
+void HAL_PIO1::sm_put_blocking(uint8_t sm, uint32_t data) {
+    (void)sm;
+    (void)data;
+    g_pio_tx_words[1]++;
+}
+
+bool HAL_PIO1::sm_put_nonblocking(uint8_t sm, uint32_t data) {
+    sm_put_blocking(sm, data);
+    return true;
+}
+
+uint32_t HAL_PIO1::sm_get_blocking(uint8_t sm) {
+    (void)sm;
+    return 0;
+}
+
+bool HAL_PIO1::sm_is_tx_fifo_full(uint8_t sm) {
+    (void)sm;
+    return false;
+}
+
+bool HAL_PIO1::sm_is_rx_fifo_empty(uint8_t sm) {
+    (void)sm;
+    return true;
+}
@@ -0,0 +1,338 @@
+#include "sim_hal.h"
+#include "../spi/hal_spi.h"
+#include <pico/stdlib.h>
+#include <hardware/spi.h>
+#include <cstring>
+#include <map>
+
+/**
+ * HAL_SPI - 主机仿真实现
+ * 片选由协议层通过 gpio_put 控制，仿真根据 CS 引脚电平把传输路由到对应的 SimSPIDevice；
+ * DMA传输按 8位/时钟频率 计算耗时，到期后回调
+ */
+
+namespace {
+
+struct SimSPIBusState {
+    uint32_t frequency = 1000000;
+    std::map<uint8_t, SimSPIDevice*> devices;   // CS引脚 -> 设备
+    std::map<uint8_t, bool> selected;           // CS引脚 -> 当前是否选中
+};
+
+static SimSPIBusState g_spi_bus[2];
+
+static inline uint32_t transfer_time_us(uint8_t index, size_t length) {
+    uint32_t frequency = g_spi_bus[index].frequency ? g_spi_bus[index].frequency : 1000000;
+    return static_cast<uint32_t>((static_cast<uint64_t>(length) * 8u * 1000000u + frequency - 1) / frequency);
+}
+
+// 找到当前被选中的设备 (CS为低电平)
+static SimSPIDevice* active_device(uint8_t index) {
+    SimSPIBusState& bus = g_spi_bus[index];
+    for (auto& entry : bus.devices) {
+        uint8_t cs_pin = entry.first;
+        bool selected = ((sio_hw->gpio_out >> cs_pin) & 1u) == 0;
+        bool& was_selected = bus.selected[cs_pin];
+        if (selected && !was_selected) {
+            entry.second->on_select();
+        } else if (!selected && was_selected) {
+            entry.second->on_deselect();
+        }
+        was_selected = selected;
+        if (selected) {
+            return entry.second;
+        }
+    }
+    return nullptr;
+}
+
+static size_t bus_transfer(uint8_t index, const uint8_t* tx_data, uint8_t* rx_data, size_t length) {
+    SimSPIDevice* device = active_device(index);
+    if (device) {
+        device->on_transfer(tx_data, rx_data, length);
+    } else if (rx_data) {
+        memset(rx_data, 0xFF, length);   // 无设备时MISO上拉
+    }
+    SimClock::advance_us(transfer_time_us(index, length));
+    return length;
+}
+
+} // namespace
+
+void SimSPI::attach(uint8_t spi_index, uint8_t cs_pin, SimSPIDevice* device) {
+    g_spi_bus[spi_index & 0x01].devices[cs_pin] = device;
+    g_spi_bus[spi_index & 0x01].selected[cs_pin] = false;
+}
+
+void SimSPI::detach(uint8_t spi_index, uint8_t cs_pin) {
+    g_spi_bus[spi_index & 0x01].devices.erase(cs_pin);
+    g_spi_bus[spi_index & 0x01].selected.erase(cs_pin);
+}
+
+void SimSPI::on_cs_changed(uint8_t pin) {
+    for (uint8_t index = 0; index < 2; index++) {
+        if (g_spi_bus[index].devices.count(pin)) {
+            active_device(index);
+        }
+    }
+}
+
+extern "C" {
+spi_inst_t sim_spi0_inst = {0};
+spi_inst_t sim_spi1_inst = {1};
+}
+
+// HAL_SPI0 实现
+HAL_SPI0* HAL_SPI0::instance_ = nullptr;
+
+HAL_SPI0* HAL_SPI0::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_SPI0();
+    }
+    return instance_;
+}
+
+HAL_SPI0::HAL_SPI0()
+    : initialized_(false), sck_pin_(0), mosi_pin_(0), miso_pin_(0), cs_pin_(255), cs_active_low_(true),
+      frequency_(1000000), dma_tx_channel_(-1), dma_rx_channel_(-1), dma_busy_(false),
+      dma_irq_initialized_(false), tx_head_(0), tx_tail_(0), tx_dma_active_(false),
+      rx_head_(0), rx_tail_(0) {
+}
+
+HAL_SPI0::~HAL_SPI0() {
+    deinit();
+}
+
+bool HAL_SPI0::init(uint8_t sck_pin, uint8_t mosi_pin, uint8_t miso_pin, uint32_t frequency) {
+    sck_pin_ = sck_pin;
+    mosi_pin_ = mosi_pin;
+    miso_pin_ = miso_pin;
+    set_frequency(frequency);
+    initialized_ = true;
+    return true;
+}
+
+void HAL_SPI0::deinit() {
+    initialized_ = false;
+    dma_busy_ = false;
+}
+
+bool HAL_SPI0::write_dma(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return write_async(data, length, callback);
+}
+
+bool HAL_SPI0::read_dma(uint8_t* buffer, size_t length, dma_callback_t callback) {
+    return read_async(buffer, length, callback);
+}
+
+bool HAL_SPI0::write_async(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return transfer_async(data, nullptr, length, callback);
+}
+
+bool HAL_SPI0::read_async(uint8_t* buffer, size_t length, dma_callback_t callback) {
+    return transfer_async(nullptr, buffer, length, callback);
+}
+
+bool HAL_SPI0::transfer_async(const uint8_t* tx_data, uint8_t* rx_data, size_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_busy_ || length == 0) {
+        return false;
+    }
+    dma_busy_ = true;
+    dma_callback_ = callback;
+    SimSPIDevice* device = active_device(0);
+    if (device) {
+        device->on_transfer(tx_data, rx_data, length);
+    } else if (rx_data) {
+        memset(rx_data, 0xFF, length);
+    }
+    SimClock::schedule_after(transfer_time_us(0, length), [this]() {
+        dma_busy_ = false;
+        if (dma_callback_) {
+            dma_callback_(true);
+        }
+    });
+    return true;
+}
+
+bool HAL_SPI0::start_dma_transfer(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return write_async(data, length, callback);
+}
+
+bool HAL_SPI0::continue_dma_transfer(const uint8_t* data, size_t length) {
+    return write_async(data, length, dma_callback_);
+}
+
+size_t HAL_SPI0::write(const uint8_t* data, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(0, data, nullptr, length);
+}
+
+size_t HAL_SPI0::read(uint8_t* buffer, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(0, nullptr, buffer, length);
+}
+
+size_t HAL_SPI0::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(0, tx_data, rx_data, length);
+}
+
+bool HAL_SPI0::is_busy() const {
+    return dma_busy_;
+}
+
+void HAL_SPI0::set_cs_pin(uint8_t cs_pin, bool active_low) {
+    cs_pin_ = cs_pin;
+    cs_active_low_ = active_low;
+}
+
+void HAL_SPI0::cs_select() {
+    if (cs_pin_ != 255) gpio_put(cs_pin_, cs_active_low_ ? 0 : 1);
+}
+
+void HAL_SPI0::cs_deselect() {
+    if (cs_pin_ != 255) gpio_put(cs_pin_, cs_active_low_ ? 1 : 0);
+}
+
+void HAL_SPI0::set_format(uint8_t data_bits, uint8_t cpol, uint8_t cpha, uint8_t bit_order) {
+    (void)data_bits;
+    (void)cpol;
+    (void)cpha;
+    (void)bit_order;
+}
+
+void HAL_SPI0::set_frequency(uint32_t frequency) {
+    frequency_ = frequency;
+    g_spi_bus[0].frequency = frequency;
+}
+
+// HAL_SPI1 实现
+HAL_SPI1* HAL_SPI1::instance_ = nullptr;
+
+HAL_SPI1* HAL_SPI1::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_SPI1();
+    }
+    return instance_;
+}
+
+HAL_SPI1::HAL_SPI1()
+    : initialized_(false), sck_pin_(0), mosi_pin_(0), miso_pin_(0), cs_pin_(255), cs_active_low_(true),
+      frequency_(1000000), dma_tx_channel_(-1), dma_rx_channel_(-1), dma_busy_(false),
+      dma_irq_initialized_(false) {
+}
+
+HAL_SPI1::~HAL_SPI1() {
+    deinit();
+}
+
+bool HAL_SPI1::init(uint8_t sck_pin, uint8_t mosi_pin, uint8_t miso_pin, uint32_t frequency) {
+    sck_pin_ = sck_pin;
+    mosi_pin_ = mosi_pin;
+    miso_pin_ = miso_pin;
+    set_frequency(frequency);
+    initialized_ = true;
+    return true;
+}
+
+void HAL_SPI1::deinit() {
+    initialized_ = false;
+    dma_busy_ = false;
+}
+
+bool HAL_SPI1::write_dma(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return write_async(data, length, callback);
+}
+
+bool HAL_SPI1::read_dma(uint8_t* buffer, size_t length, dma_callback_t callback) {
+    return read_async(buffer, length, callback);
+}
+
+bool HAL_SPI1::write_async(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return transfer_async(data, nullptr, length, callback);
+}
+
+bool HAL_SPI1::read_async(uint8_t* buffer, size_t length, dma_callback_t callback) {
+    return transfer_async(nullptr, buffer, length, callback);
+}
+
+bool HAL_SPI1::transfer_async(const uint8_t* tx_data, uint8_t* rx_data, size_t length, dma_callback_t callback) {
+    if (!initialized_ || dma_busy_ || length == 0) {
+        return false;
+    }
+    dma_busy_ = true;
+    dma_callback_ = callback;
+    SimSPIDevice* device = active_device(1);
+    if (device) {
+        device->on_transfer(tx_data, rx_data, length);
+    } else if (rx_data) {
+        memset(rx_data, 0xFF, length);
+    }
+    SimClock::schedule_after(transfer_time_us(1, length), [this]() {
+        dma_busy_ = false;
+        if (dma_callback_) {
+            dma_callback_(true);
+        }
+    });
+    return true;
+}
+
+bool HAL_SPI1::start_dma_transfer(const uint8_t* data, size_t length, dma_callback_t callback) {
+    return write_async(data, length, callback);
+}
+
+bool HAL_SPI1::continue_dma_transfer(const uint8_t* data, size_t length) {
+    return write_async(data, length, dma_callback_);
+}
+
+size_t HAL_SPI1::write(const uint8_t* data, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(1, data, nullptr, length);
+}
+
+size_t HAL_SPI1::read(uint8_t* buffer, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(1, nullptr, buffer, length);
+}
+
+size_t HAL_SPI1::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) {
+    if (!initialized_) return 0;
+    return bus_transfer(1, tx_data, rx_data, length);
+}
+
+bool HAL_SPI1::is_busy() const {
+    return dma_busy_;
+}
+
+void HAL_SPI1::set_cs_pin(uint8_t cs_pin, bool active_low) {
+    cs_pin_ = cs_pin;
+    cs_active_low_ = active_low;
+}
+
+void HAL_SPI1::cs_select() {
+    if (cs_pin_ != 255) gpio_put(cs_pin_, cs_active_low_ ? 0 : 1);
+}
+
+void HAL_SPI1::cs_deselect() {
+    if (cs_pin_ != 255) gpio_put(cs_pin_, cs_active_low_ ? 1 : 0);
+}
+
+void HAL_SPI1::set_format(uint8_t data_bits, uint8_t cpol, uint8_t cpha, uint8_t bit_order) {
+    (void)data_bits;
+    (void)cpol;
+    (void)cpha;
+    (void)bit_order;
+}
+
+void HAL_SPI1::set_frequency(uint32_t frequency) {
+    frequency_ = frequency;
+    g_spi_bus[1].frequency = frequency;
+}
+
+std::string HAL_SPI1::get_name() const {
+    return "SPI1";
+}
+
+bool HAL_SPI1::is_ready() const {
+    return initialized_;
+}
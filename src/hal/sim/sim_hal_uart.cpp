@@ -0,0 +1,428 @@
+#include "sim_hal.h"
+#include "../uart/hal_uart.h"
+#include <pico/stdlib.h>
+#include <cstring>
+#include <deque>
+
+/**
+ * HAL_UART - 主机仿真实现
+ * TX：与真实DMA一致为单缓冲，发送期间 write_to_tx_buffer 返回0；发送时长按8N1与当前波特率计算，
+ *     到期后经 global_irq 派发DMA完成回调
+ * RX：注入的数据按字节时间逐个到达，到达事件中执行与真实中断相同的入队逻辑
+ */
+
+extern "C" {
+uart_inst_t sim_uart0_inst = {0};
+uart_inst_t sim_uart1_inst = {1};
+}
+
+void uart0_tx_dma_callback(bool success);
+void uart1_tx_dma_callback(bool success);
+
+namespace {
+
+struct SimUARTPort {
+    uint32_t baudrate = 115200;
+    SimUART::tx_observer_t tx_observer;
+    std::deque<uint8_t> rx_fifo;            // 已到达但尚未被中断取走的数据
+    std::function<void()> rx_irq;           // 由HAL实例在init时注册
+    uint64_t rx_line_free_us = 0;           // RX线路下一个空闲时刻
+    uint64_t tx_bytes = 0;
+};
+
+static SimUARTPort g_uart_port[2];
+
+static inline uint32_t byte_time(uint8_t index) {
+    uint32_t baud = g_uart_port[index].baudrate ? g_uart_port[index].baudrate : 9600;
+    return (10u * 1000000u + baud - 1) / baud;
+}
+
+// 发起一次TX DMA：记录观察者并挂载完成事件
+static void start_tx(uint8_t index, int32_t dma_channel, const char* data, size_t length) {
+    SimUARTPort& port = g_uart_port[index];
+    uint64_t start = SimClock::now_us();
+    uint64_t end = start + static_cast<uint64_t>(byte_time(index)) * length;
+    port.tx_bytes += length;
+    if (port.tx_observer) {
+        port.tx_observer(reinterpret_cast<const uint8_t*>(data), length, start, end);
+    }
+    SimClock::schedule_at(end, [dma_channel]() {
+        global_irq_trigger_dma_callback(static_cast<uint8_t>(dma_channel), true);
+    });
+}
+
+// RX中断公共逻辑：与 hal_uart.cpp 的 handle_rx_irq 一致
+template <typename RxBufferT>
+static void drain_rx(uint8_t index, RxBufferT& rx_buffer, size_t buffer_size, const std::function<void(uint8_t)>& rx_callback) {
+    SimUARTPort& port = g_uart_port[index];
+    while (!port.rx_fifo.empty()) {
+        uint8_t ch = port.rx_fifo.front();
+        port.rx_fifo.pop_front();
+        if (rx_buffer.data_count < buffer_size) {
+            *rx_buffer.write_ptr = ch;
+            rx_buffer.write_ptr++;
+            if (rx_buffer.write_ptr >= rx_buffer.buffer + buffer_size) {
+                rx_buffer.write_ptr = rx_buffer.buffer;
+            }
+            rx_buffer.data_count++;
+        }
+        if (rx_callback) {
+            rx_callback(ch);
+        }
+    }
+}
+
+template <typename RxBufferT>
+static size_t read_rx(RxBufferT& rx_buffer, size_t buffer_size, uint8_t* buffer, size_t length) {
+    size_t to_read = (length > rx_buffer.data_count) ? rx_buffer.data_count : length;
+    for (size_t i = 0; i < to_read; i++) {
+        buffer[i] = *rx_buffer.read_ptr;
+        rx_buffer.read_ptr++;
+        if (rx_buffer.read_ptr >= rx_buffer.buffer + buffer_size) {
+            rx_buffer.read_ptr = rx_buffer.buffer;
+        }
+    }
+    rx_buffer.data_count -= to_read;
+    return to_read;
+}
+
+} // namespace
+
+void SimUART::set_tx_observer(uint8_t uart_index, tx_observer_t observer) {
+    g_uart_port[uart_index & 0x01].tx_observer = std::move(observer);
+}
+
+void SimUART::inject_rx(uint8_t uart_index, const uint8_t* data, size_t length) {
+    uint8_t index = uart_index & 0x01;
+    SimUARTPort& port = g_uart_port[index];
+    uint64_t t = std::max(port.rx_line_free_us, SimClock::now_us());
+    for (size_t i = 0; i < length; i++) {
+        t += byte_time(index);
+        uint8_t ch = data[i];
+        SimClock::schedule_at(t, [index, ch]() {
+            SimUARTPort& p = g_uart_port[index];
+            p.rx_fifo.push_back(ch);
+            if (p.rx_irq) {
+                p.rx_irq();
+            }
+        });
+    }
+    port.rx_line_free_us = t;
+}
+
+uint32_t SimUART::byte_time_us(uint8_t uart_index) {
+    return byte_time(uart_index & 0x01);
+}
+
+uint64_t SimUART::tx_byte_count(uint8_t uart_index) {
+    return g_uart_port[uart_index & 0x01].tx_bytes;
+}
+
+// HAL_UART0 静态成员
+HAL_UART0* HAL_UART0::instance_ = nullptr;
+uint8_t HAL_UART0::RxBuffer::buffer[HAL_UART0::RxBuffer::BUFFER_SIZE];
+uint8_t* HAL_UART0::RxBuffer::write_ptr = HAL_UART0::RxBuffer::buffer;
+uint8_t* HAL_UART0::RxBuffer::read_ptr = HAL_UART0::RxBuffer::buffer;
+size_t HAL_UART0::RxBuffer::data_count = 0;
+char HAL_UART0::TxBuffer::data_buffer[HAL_UART0::TxBuffer::BUFFER_SIZE];
+HAL_UART0::DmaControlBlock HAL_UART0::TxBuffer::control_buffer[HAL_UART0::TxBuffer::BUFFER_SIZE + 1];
+
+// HAL_UART1 静态成员
+HAL_UART1* HAL_UART1::instance_ = nullptr;
+uint8_t HAL_UART1::RxBuffer::buffer[HAL_UART1::RxBuffer::BUFFER_SIZE];
+uint8_t* HAL_UART1::RxBuffer::write_ptr = HAL_UART1::RxBuffer::buffer;
+uint8_t* HAL_UART1::RxBuffer::read_ptr = HAL_UART1::RxBuffer::buffer;
+size_t HAL_UART1::RxBuffer::data_count = 0;
+char HAL_UART1::TxBuffer::data_buffer[HAL_UART1::TxBuffer::BUFFER_SIZE];
+HAL_UART1::DmaControlBlock HAL_UART1::TxBuffer::control_buffer[HAL_UART1::TxBuffer::BUFFER_SIZE + 1];
+
+// HAL_UART0 实现
+HAL_UART0* HAL_UART0::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_UART0();
+    }
+    return instance_;
+}
+
+HAL_UART0::HAL_UART0()
+    : initialized_(false), tx_pin_(0), rx_pin_(0), baudrate_(115200),
+      dma_busy_(false), last_tx_start_us_(0), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
+}
+
+HAL_UART0::~HAL_UART0() {
+    deinit();
+    instance_ = nullptr;
+}
+
+bool HAL_UART0::init(uint8_t tx_pin, uint8_t rx_pin, uint32_t baudrate, bool /*flow_control*/, uint8_t /*cts_pin*/, uint8_t /*rts_pin*/) {
+    if (initialized_) {
+        deinit();
+    }
+    tx_pin_ = tx_pin;
+    rx_pin_ = rx_pin;
+    baudrate_ = baudrate;
+    g_uart_port[0].baudrate = baudrate;
+    g_uart_port[0].rx_irq = [this]() { handle_rx_irq(); };
+
+    rx_buffer_.write_ptr = rx_buffer_.buffer;
+    rx_buffer_.read_ptr = rx_buffer_.buffer;
+    rx_buffer_.data_count = 0;
+
+    dma_tx_channel_ = dma_claim_unused_channel(true);
+    dma_ctrl_channel_ = dma_claim_unused_channel(true);
+    bool tx_registered = global_irq_register_dma_callback(dma_tx_channel_, uart0_tx_dma_callback);
+
+    initialized_ = tx_registered && dma_tx_channel_ >= 0 && dma_ctrl_channel_ >= 0;
+    return initialized_;
+}
+
+void HAL_UART0::deinit() {
+    if (initialized_) {
+        g_uart_port[0].rx_irq = nullptr;
+        if (dma_tx_channel_ >= 0) {
+            global_irq_unregister_dma_callback(dma_tx_channel_);
+            dma_channel_unclaim(dma_tx_channel_);
+            dma_tx_channel_ = -1;
+        }
+        if (dma_ctrl_channel_ >= 0) {
+            dma_channel_unclaim(dma_ctrl_channel_);
+            dma_ctrl_channel_ = -1;
+        }
+        initialized_ = false;
+    }
+}
+
+inline size_t HAL_UART0::write_to_tx_buffer(const uint8_t* data, size_t length) {
+    if (!initialized_ || !data || length == 0 || dma_busy_) {
+        return 0;
+    }
+    size_t to_write = (length > TxBuffer::BUFFER_SIZE) ? TxBuffer::BUFFER_SIZE : length;
+    memcpy(tx_buffer_.data_buffer, data, to_write);
+    trigger_tx_dma(to_write);
+    return to_write;
+}
+
+inline size_t HAL_UART0::read_from_rx_buffer(uint8_t* buffer, size_t length) {
+    if (!initialized_ || !buffer) {
+        return 0;
+    }
+    return read_rx(rx_buffer_, RxBuffer::BUFFER_SIZE, buffer, length);
+}
+
+inline size_t HAL_UART0::get_tx_buffer_free_space() const {
+    return dma_busy_ ? 0 : TxBuffer::BUFFER_SIZE;
+}
+
+inline size_t HAL_UART0::get_rx_buffer_data_count() const {
+    return rx_buffer_.data_count;
+}
+
+bool HAL_UART0::is_busy() const {
+    return dma_busy_;
+}
+
+size_t HAL_UART0::available() {
+    if (!initialized_) return 0;
+    return rx_buffer_.data_count;
+}
+
+void HAL_UART0::flush_rx() {
+    rx_buffer_.write_ptr = rx_buffer_.buffer;
+    rx_buffer_.read_ptr = rx_buffer_.buffer;
+    rx_buffer_.data_count = 0;
+}
+
+void HAL_UART0::flush_tx() {
+    // 等待DMA发送完成
+    while (initialized_ && dma_busy_) {
+        tight_loop_contents();
+    }
+}
+
+void HAL_UART0::set_rx_callback(std::function<void(uint8_t)> callback) {
+    rx_callback_ = callback;
+}
+
+bool HAL_UART0::set_baudrate(uint32_t baudrate) {
+    if (!initialized_) {
+        return false;
+    }
+    baudrate_ = baudrate;
+    g_uart_port[0].baudrate = baudrate;
+    return true;
+}
+
+void HAL_UART0::irq_handler() {
+    if (instance_) {
+        instance_->handle_rx_irq();
+    }
+}
+
+void HAL_UART0::handle_rx_irq() {
+    drain_rx(0, rx_buffer_, RxBuffer::BUFFER_SIZE, rx_callback_);
+}
+
+inline void HAL_UART0::trigger_tx_dma(size_t length) {
+    if (!initialized_ || dma_busy_ || length == 0) {
+        return;
+    }
+    dma_busy_ = true;
+    last_tx_start_us_ = time_us_32();
+    start_tx(0, dma_tx_channel_, tx_buffer_.data_buffer, length);
+}
+
+void uart0_tx_dma_callback(bool success) {
+    HAL_UART0* instance = HAL_UART0::getInstance();
+    if (!instance || instance->dma_tx_channel_ < 0) {
+        return;
+    }
+    instance->dma_busy_ = false;
+    if (instance->dma_callback_) {
+        instance->dma_callback_(success);
+    }
+}
+
+// HAL_UART1 实现
+HAL_UART1* HAL_UART1::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_UART1();
+    }
+    return instance_;
+}
+
+HAL_UART1::HAL_UART1()
+    : initialized_(false), tx_pin_(0), rx_pin_(0), baudrate_(115200),
+      dma_busy_(false), last_tx_start_us_(0), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
+}
+
+HAL_UART1::~HAL_UART1() {
+    deinit();
+    instance_ = nullptr;
+}
+
+bool HAL_UART1::init(uint8_t tx_pin, uint8_t rx_pin, uint32_t baudrate, bool /*flow_control*/, uint8_t /*cts_pin*/, uint8_t /*rts_pin*/) {
+    if (initialized_) {
+        deinit();
+    }
+    tx_pin_ = tx_pin;
+    rx_pin_ = rx_pin;
+    baudrate_ = baudrate;
+    g_uart_port[1].baudrate = baudrate;
+    g_uart_port[1].rx_irq = [this]() { handle_rx_irq(); };
+
+    rx_buffer_.write_ptr = rx_buffer_.buffer;
+    rx_buffer_.read_ptr = rx_buffer_.buffer;
+    rx_buffer_.data_count = 0;
+
+    dma_tx_channel_ = dma_claim_unused_channel(true);
+    dma_ctrl_channel_ = dma_claim_unused_channel(true);
+    bool tx_registered = global_irq_register_dma_callback(dma_tx_channel_, uart1_tx_dma_callback);
+
+    initialized_ = tx_registered && dma_tx_channel_ >= 0 && dma_ctrl_channel_ >= 0;
+    return initialized_;
+}
+
+void HAL_UART1::deinit() {
+    if (initialized_) {
+        g_uart_port[1].rx_irq = nullptr;
+        if (dma_tx_channel_ >= 0) {
+            global_irq_unregister_dma_callback(dma_tx_channel_);
+            dma_channel_unclaim(dma_tx_channel_);
+            dma_tx_channel_ = -1;
+        }
+        if (dma_ctrl_channel_ >= 0) {
+            dma_channel_unclaim(dma_ctrl_channel_);
+            dma_ctrl_channel_ = -1;
+        }
+        initialized_ = false;
+    }
+}
+
+inline size_t HAL_UART1::write_to_tx_buffer(const uint8_t* data, size_t length) {
+    if (!initialized_ || !data || length == 0 || dma_busy_) {
+        return 0;
+    }
+    size_t to_write = (length > TxBuffer::BUFFER_SIZE) ? TxBuffer::BUFFER_SIZE : length;
+    memcpy(tx_buffer_.data_buffer, data, to_write);
+    trigger_tx_dma(to_write);
+    return to_write;
+}
+
+inline size_t HAL_UART1::read_from_rx_buffer(uint8_t* buffer, size_t length) {
+    if (!initialized_ || !buffer) {
+        return 0;
+    }
+    return read_rx(rx_buffer_, RxBuffer::BUFFER_SIZE, buffer, length);
+}
+
+inline size_t HAL_UART1::get_tx_buffer_free_space() const {
+    return dma_busy_ ? 0 : TxBuffer::BUFFER_SIZE;
+}
+
+inline size_t HAL_UART1::get_rx_buffer_data_count() const {
+    return rx_buffer_.data_count;
+}
+
+bool HAL_UART1::is_busy() const {
+    return dma_busy_;
+}
+
+size_t HAL_UART1::available() {
+    if (!initialized_) return 0;
+    return rx_buffer_.data_count;
+}
+
+void HAL_UART1::flush_rx() {
+    rx_buffer_.write_ptr = rx_buffer_.buffer;
+    rx_buffer_.read_ptr = rx_buffer_.buffer;
+    rx_buffer_.data_count = 0;
+}
+
+void HAL_UART1::flush_tx() {
+    while (initialized_ && dma_busy_) {
+        tight_loop_contents();
+    }
+}
+
+void HAL_UART1::set_rx_callback(std::function<void(uint8_t)> callback) {
+    rx_callback_ = callback;
+}
+
+bool HAL_UART1::set_baudrate(uint32_t baudrate) {
+    if (!initialized_) {
+        return false;
+    }
+    baudrate_ = baudrate;
+    g_uart_port[1].baudrate = baudrate;
+    return true;
+}
+
+void HAL_UART1::irq_handler() {
+    if (instance_) {
+        instance_->handle_rx_irq();
+    }
+}
+
+void HAL_UART1::handle_rx_irq() {
+    drain_rx(1, rx_buffer_, RxBuffer::BUFFER_SIZE, rx_callback_);
+}
+
+inline void HAL_UART1::trigger_tx_dma(size_t length) {
+    if (!initialized_ || dma_busy_ || length == 0) {
+        return;
+    }
+    dma_busy_ = true;
+    last_tx_start_us_ = time_us_32();
+    start_tx(1, dma_tx_channel_, tx_buffer_.data_buffer, length);
+}
+
+void uart1_tx_dma_callback(bool success) {
+    HAL_UART1* instance = HAL_UART1::getInstance();
+    if (!instance || instance->dma_tx_channel_ < 0) {
+        return;
+    }
+    instance->dma_busy_ = false;
+    if (instance->dma_callback_) {
+        instance->dma_callback_(success);
+    }
+}
@@ -0,0 +1,175 @@
+#include "sim_hal.h"
+#include "../usb/hal_usb.h"
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+/**
+ * HAL_USB - 主机仿真实现
+ * HID报告交给观察者 (带虚拟时间戳)，CDC输出默认写到标准输出，CDC输入由 SimUSB::inject_cdc 注入
+ */
+
+namespace {
+
+static bool g_mounted = true;
+static uint32_t g_hid_report_count = 0;
+static SimUSB::cdc_observer_t g_cdc_observer;
+static SimUSB::hid_observer_t g_hid_observer;
+static std::deque<uint8_t> g_cdc_host_fifo;   // 主机已发出、设备尚未取走的CDC数据
+
+} // namespace
+
+void SimUSB::set_cdc_observer(cdc_observer_t observer) {
+    g_cdc_observer = observer;
+}
+
+void SimUSB::set_hid_observer(hid_observer_t observer) {
+    g_hid_observer = observer;
+}
+
+void SimUSB::set_mounted(bool mounted) {
+    g_mounted = mounted;
+}
+
+uint32_t SimUSB::hid_report_count() {
+    return g_hid_report_count;
+}
+
+extern "C" {
+
+bool tud_hid_report(uint8_t report_id, void const* report, uint16_t len) {
+    if (!g_mounted) {
+        return false;
+    }
+    g_hid_report_count++;
+    if (g_hid_observer) {
+        g_hid_observer(report_id, static_cast<const uint8_t*>(report), len, SimClock::now_us());
+    }
+    return true;
+}
+
+bool tud_hid_ready(void) {
+    return g_mounted;
+}
+
+bool tud_mounted(void) {
+    return g_mounted;
+}
+
+bool tud_ready(void) {
+    return g_mounted;
+}
+
+void tud_task(void) {
+}
+
+} // extern "C"
+
+// HAL_USB_Device 实现
+HAL_USB_Device* HAL_USB_Device::instance_ = nullptr;
+
+HAL_USB_Device* HAL_USB_Device::getInstance() {
+    if (instance_ == nullptr) {
+        instance_ = new HAL_USB_Device();
+    }
+    return instance_;
+}
+
+HAL_USB_Device::HAL_USB_Device()
+    : initialized_(false), connected_(false), cdc_rx_head_(0), cdc_rx_tail_(0) {
+}
+
+HAL_USB_Device::~HAL_USB_Device() {
+    deinit();
+    if (instance_ == this) {
+        instance_ = nullptr;
+    }
+}
+
+bool HAL_USB_Device::init() {
+    initialized_ = true;
+    return true;
+}
+
+void HAL_USB_Device::deinit() {
+    initialized_ = false;
+    connected_ = false;
+}
+
+bool HAL_USB_Device::is_connected() const {
+    return initialized_ && tud_mounted();
+}
+
+bool HAL_USB_Device::is_ready() const {
+    return initialized_ && tud_ready();
+}
+
+bool HAL_USB_Device::cdc_write(const uint8_t* data, size_t length) {
+    if (!is_ready() || !data || length == 0) {
+        return length == 0;
+    }
+    if (g_cdc_observer) {
+        g_cdc_observer(data, length);
+    } else {
+        fwrite(data, 1, length, stdout);
+    }
+    return true;
+}
+
+size_t HAL_USB_Device::cdc_read(uint8_t* buffer, size_t max_length) {
+    if (!initialized_) return 0;
+
+    size_t count = 0;
+    while (count < max_length && cdc_rx_head_ != cdc_rx_tail_) {
+        buffer[count++] = cdc_rx_buffer_[cdc_rx_tail_];
+        cdc_rx_tail_ = (cdc_rx_tail_ + 1) % CDC_BUFFER_SIZE;
+    }
+    return count;
+}
+
+size_t HAL_USB_Device::cdc_available() const {
+    if (cdc_rx_head_ >= cdc_rx_tail_) {
+        return cdc_rx_head_ - cdc_rx_tail_;
+    } else {
+        return CDC_BUFFER_SIZE - cdc_rx_tail_ + cdc_rx_head_;
+    }
+}
+
+size_t HAL_USB_Device::cdc_write_available() const {
+    // 主机端总是及时取走数据
+    return is_ready() ? 256 : 0;
+}
+
+void HAL_USB_Device::cdc_flush() {
+    if (!g_cdc_observer) {
+        fflush(stdout);
+    }
+}
+
+void HAL_USB_Device::handle_cdc_rx() {
+    // 存储到环形缓冲区，满时保留在主机侧FIFO
+    while (!g_cdc_host_fifo.empty()) {
+        size_t next_head = (cdc_rx_head_ + 1) % CDC_BUFFER_SIZE;
+        if (next_head == cdc_rx_tail_) {
+            break;
+        }
+        cdc_rx_buffer_[cdc_rx_head_] = g_cdc_host_fifo.front();
+        g_cdc_host_fifo.pop_front();
+        cdc_rx_head_ = next_head;
+    }
+}
+
+void HAL_USB_Device::handle_hid_requests() {
+}
+
+void HAL_USB_Device::tud_cdc_rx_cb(uint8_t itf) {
+    (void)itf;
+    if (instance_) {
+        instance_->handle_cdc_rx();
+    }
+}
+
+void SimUSB::inject_cdc(const uint8_t* data, size_t length) {
+    g_cdc_host_fifo.insert(g_cdc_host_fifo.end(), data, data + length);
+    HAL_USB_Device::tud_cdc_rx_cb(0);
+}
@@ -0,0 +1,125 @@
+#include <LittleFS.h>
+#include <map>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "sim_hal.h"
+
+/**
+ * LittleFS 仿真 - 进程内文件表
+ */
+
+SimLittleFS LittleFS;
+
+namespace {
+
+static std::map<std::string, std::shared_ptr<std::string>> g_files;
+static bool g_mounted = false;
+
+} // namespace
+
+int File::available() {
+    if (!data_) return 0;
+    return static_cast<int>(data_->size() - pos_);
+}
+
+int File::read() {
+    if (!data_ || pos_ >= data_->size()) return -1;
+    return static_cast<uint8_t>((*data_)[pos_++]);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!data_ || !buf) return 0;
+    size_t count = std::min(size, data_->size() - pos_);
+    memcpy(buf, data_->data() + pos_, count);
+    pos_ += count;
+    return count;
+}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!data_ || !writable_ || !buf) return 0;
+    data_->append(reinterpret_cast<const char*>(buf), size);
+    pos_ = data_->size();
+    return size;
+}
+
+size_t File::size() const {
+    return data_ ? data_->size() : 0;
+}
+
+void File::close() {
+    data_.reset();
+    pos_ = 0;
+    writable_ = false;
+}
+
+bool SimLittleFS::begin() {
+    g_mounted = true;
+    return true;
+}
+
+bool SimLittleFS::format() {
+    g_files.clear();
+    return true;
+}
+
+void SimLittleFS::end() {
+    g_mounted = false;
+}
+
+bool SimLittleFS::exists(const char* path) {
+    return g_mounted && path && g_files.count(path) != 0;
+}
+
+bool SimLittleFS::remove(const char* path) {
+    return g_mounted && path && g_files.erase(path) != 0;
+}
+
+File SimLittleFS::open(const char* path, const char* mode) {
+    File file;
+    if (!g_mounted || !path || !mode) {
+        return file;
+    }
+    auto it = g_files.find(path);
+    if (mode[0] == 'r') {
+        if (it == g_files.end()) {
+            return file;
+        }
+        file.data_ = it->second;
+        file.pos_ = 0;
+        file.writable_ = false;
+    } else {
+        // "w" 截断重写, "a" 追加
+        if (it == g_files.end() || mode[0] == 'w') {
+            g_files[path] = std::make_shared<std::string>();
+        }
+        file.data_ = g_files[path];
+        file.pos_ = file.data_->size();
+        file.writable_ = true;
+    }
+    return file;
+}
+
+bool SimFS::import_host_file(const char* host_path, const char* fs_path) {
+    if (!host_path || !fs_path) return false;
+    std::ifstream in(host_path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream content;
+    content << in.rdbuf();
+    g_files[fs_path] = std::make_shared<std::string>(content.str());
+    return true;
+}
+
+bool SimFS::export_host_file(const char* fs_path, const char* host_path) {
+    if (!fs_path || !host_path) return false;
+    auto it = g_files.find(fs_path);
+    if (it == g_files.end()) return false;
+    std::ofstream out(host_path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(it->second->data(), static_cast<std::streamsize>(it->second->size()));
+    return static_cast<bool>(out);
+}
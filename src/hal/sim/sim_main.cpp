@@ -0,0 +1,760 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "sim_hal.h"
+#include "sim_devices.h"
+#include "sim_replay.h"
+
+// HAL层包含
+#include "../i2c/hal_i2c.h"
+#include "../uart/hal_uart.h"
+#include "../spi/hal_spi.h"
+#include "../pio/hal_pio.h"
+#include "../usb/hal_usb.h"
+#include "../timer_wheel.h"
+
+extern "C" {
+#include "../global_irq.h"
+}
+
+// 协议层包含
+#include "../../protocol/touch_sensor/touch_sensor.h"
+#include "../../protocol/touch_sensor/ad7147/ad7147.h"
+#include "../../protocol/mcp23s17/mcp23s17.h"
+#include "../../protocol/neopixel/neopixel.h"
+#include "../../protocol/mai2serial/mai2serial.h"
+#include "../../protocol/mai2light/mai2light.h"
+#include "../../protocol/usb_serial_logs/usb_serial_logs.h"
+#include "../../protocol/hid/hid.h"
+
+// 服务层包含
+#include "../../service/config_manager/config_manager.h"
+#include "../../service/input_manager/input_manager.h"
+#include "../../service/light_manager/light_manager.h"
+
+/**
+ * 主机仿真入口
+ * 按 main.cpp 的初始化顺序搭建 HAL/协议/服务层，两个核心的任务在同一线程中交替执行，
+ * 每轮循环推进固定的虚拟时间。触摸由挂在I2C0上的 SimPSoC 模型按固定节奏产生，
+ * 指定 --replay 时改为回放触摸轨迹并输出串口链路的延迟报告；
+ * 指定 --ad7147 时改挂 SimAD7147 寄存器模型按电极逐个点按，--ad7147-calibrate 时模型为未调校的电极，先跑一次自动校准。
+ *
+ * 用法: sim [--duration-ms N] [--loop-us N] [--verbose]
+ *           [--config config.bin] [--record trace.bin] [--replay trace.bin] [--packets]
+ *           [--delay-ms N] [--aggregation-ms N] [--rate-limit-hz N] [--send-on-change 0|1] [--extra-sends N]
+ *           [--gpio-irq 0|1] [--button-tap-us N] [--button-bounce N] [--debounce none|eager|defer] [--debounce-us N]
+ *           [--partial-frame-ms N] [--silent-module N] [--cdc "command"]
+ *           [--ad7147] [--ad7147-calibrate] [--ad7147-int-pin N] [--ad7147-disable CH] [--ad7147-noise N]
+ *           [--ad7147-software] [--ad7147-release-ms N]
+ * 指定 --button-tap-us 时按固定节奏交替点按MCP GPA0与MCU按键引脚，输出点按到HID键盘报文的延迟；
+ * --button-bounce 在每个边沿后追加N次触点抖动，统计抖动造成的重复按下报文；
+ * --partial-frame-ms 开启部分帧组帧并设置新鲜度上限，--silent-module 让回放中的第N个模块停止上报；
+ * --cdc 在运行结束前经USB CDC发送一行诊断命令 (如 "touchstat")，输出随CDC日志打印 (需 --verbose)；
+ * --ad7147 输出 (校准收敛时间、) 转换序列/采样吞吐与重复读取，并逐次核对点按的电极是否出现在对应区域
+ * (通道N映射到A1起第N个区域)，--ad7147-disable 关闭一个通道以覆盖阶段到通道的重映射，
+ * --ad7147-int-pin 把模型INT接到MCU引脚并切换为就绪中断采样，--ad7147-software 改用固件软件检测，
+ * --ad7147-release-ms 让松开时电极电容在N毫秒内线性回落 (模拟滑动时手指逐渐离开)，输出松开到串口状态清除的延迟
+ */
+
+// 引脚定义 (与 main.cpp 保持一致)
+#define I2C0_SDA_PIN 4
+#define I2C0_SCL_PIN 5
+#define I2C1_SDA_PIN 6
+#define I2C1_SCL_PIN 7
+#define SPI1_MISO_PIN 28
+#define SPI1_MOSI_PIN 27
+#define SPI1_SCK_PIN 26
+#define MCP23S17_CS_PIN 29
+#define SPI1_FREQ 10000000
+#define UART0_TX_PIN 12
+#define UART0_RX_PIN 13
+#define UART1_TX_PIN 8
+#define UART1_RX_PIN 9
+#define NEOPIXEL_PIN 11
+#define NEOPIXEL_LEDS_NUM 32
+// 仿真板把MCP23S17 INT接到空闲引脚，用于验证中断输入路径 (main.cpp默认未连接)
+#define SIM_MCP23S17_INT_PIN 10
+#define SIM_BUTTON_PIN 14
+#define SIM_BUTTON_PERIOD_US 10000
+#define SIM_BUTTON_BOUNCE_US 150
+
+// 仿真触摸模块
+#define SIM_PSOC_ADDR 0x08
+#define SIM_TOUCH_PERIOD_US 20000
+#define SIM_AD7147_ADDR 0x2C
+#define SIM_AD7147_TOUCH_PERIOD_US 100000  // 大于默认触摸响应延迟 (50ms)，周期结束时串口状态应已跟上
+#define SIM_AD7147_TOUCH_FF 1500
+#define SIM_AD7147_TRIMMED_FF 5500   // 不校准时的电极寄生电容：AFE偏移为0时CDC高于阈值约0x3B0
+
+// 回放结束后继续运行的时间，保证延迟缓冲中的状态全部发出
+#define SIM_REPLAY_TAIL_US 200000
+
+struct SimOptions {
+    uint32_t duration_ms = 10000;
+    uint32_t loop_us = 10;
+    bool verbose = false;
+    const char* config_path = nullptr;
+    const char* record_path = nullptr;
+    const char* replay_path = nullptr;
+    bool print_packets = false;
+    // 串口链路参数，-1 表示沿用配置
+    int32_t delay_ms = -1;
+    int32_t aggregation_ms = -1;
+    int32_t rate_limit_hz = -1;
+    int32_t send_on_change = -1;
+    int32_t extra_sends = -1;
+    int32_t gpio_irq = -1;
+    uint32_t button_tap_us = 0;
+    uint32_t button_bounce = 0;
+    int32_t debounce_mode = -1;
+    uint32_t debounce_us = GPIO_DEFAULT_DEBOUNCE_US;
+    int32_t partial_frame_ms = -1;
+    int32_t silent_module = -1;
+    const char* cdc_command = nullptr;
+    bool ad7147 = false;
+    bool ad7147_calibrate = false;
+    int32_t ad7147_int_pin = -1;
+    int32_t ad7147_disable = -1;
+    uint32_t ad7147_noise = 16;
+    bool ad7147_software = false;
+    uint32_t ad7147_release_ms = 0;
+};
+
+static bool print_usage(const char* program) {
+    fprintf(stderr, "usage: %s [--duration-ms N] [--loop-us N] [--verbose]\n"
+                    "          [--config config.bin] [--record trace.bin] [--replay trace.bin] [--packets]\n"
+                    "          [--delay-ms N] [--aggregation-ms N] [--rate-limit-hz N] [--send-on-change 0|1] [--extra-sends N]\n"
+                    "          [--gpio-irq 0|1] [--button-tap-us N] [--button-bounce N] [--debounce none|eager|defer] [--debounce-us N]\n"
+                    "          [--partial-frame-ms N] [--silent-module N] [--cdc \"command\"]\n"
+                    "          [--ad7147] [--ad7147-calibrate] [--ad7147-int-pin N] [--ad7147-disable CH] [--ad7147-noise N]\n"
+                    "          [--ad7147-software] [--ad7147-release-ms N]\n",
+            program);
+    return false;
+}
+
+static bool parse_options(int argc, char** argv, SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            options.duration_ms = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--loop-us") == 0 && i + 1 < argc) {
+            options.loop_us = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            options.config_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--packets") == 0) {
+            options.print_packets = true;
+        } else if (strcmp(argv[i], "--delay-ms") == 0 && i + 1 < argc) {
+            options.delay_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--aggregation-ms") == 0 && i + 1 < argc) {
+            options.aggregation_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rate-limit-hz") == 0 && i + 1 < argc) {
+            options.rate_limit_hz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--send-on-change") == 0 && i + 1 < argc) {
+            options.send_on_change = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--extra-sends") == 0 && i + 1 < argc) {
+            options.extra_sends = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gpio-irq") == 0 && i + 1 < argc) {
+            options.gpio_irq = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--button-tap-us") == 0 && i + 1 < argc) {
+            options.button_tap_us = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--button-bounce") == 0 && i + 1 < argc) {
+            options.button_bounce = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--debounce") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "none") == 0) options.debounce_mode = static_cast<int32_t>(GPIODebounceMode::NONE);
+            else if (strcmp(mode, "eager") == 0) options.debounce_mode = static_cast<int32_t>(GPIODebounceMode::EAGER);
+            else if (strcmp(mode, "defer") == 0) options.debounce_mode = static_cast<int32_t>(GPIODebounceMode::DEFER);
+            else return print_usage(argv[0]);
+        } else if (strcmp(argv[i], "--debounce-us") == 0 && i + 1 < argc) {
+            options.debounce_us = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--partial-frame-ms") == 0 && i + 1 < argc) {
+            options.partial_frame_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--silent-module") == 0 && i + 1 < argc) {
+            options.silent_module = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cdc") == 0 && i + 1 < argc) {
+            options.cdc_command = argv[++i];
+        } else if (strcmp(argv[i], "--ad7147") == 0) {
+            options.ad7147 = true;
+        } else if (strcmp(argv[i], "--ad7147-calibrate") == 0) {
+            options.ad7147 = true;
+            options.ad7147_calibrate = true;
+        } else if (strcmp(argv[i], "--ad7147-int-pin") == 0 && i + 1 < argc) {
+            options.ad7147_int_pin = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ad7147-disable") == 0 && i + 1 < argc) {
+            options.ad7147_disable = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ad7147-noise") == 0 && i + 1 < argc) {
+            options.ad7147_noise = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--ad7147-software") == 0) {
+            options.ad7147 = true;
+            options.ad7147_software = true;
+        } else if (strcmp(argv[i], "--ad7147-release-ms") == 0 && i + 1 < argc) {
+            options.ad7147 = true;
+            options.ad7147_release_ms = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else {
+            return print_usage(argv[0]);
+        }
+    }
+    if (options.loop_us == 0) options.loop_us = 1;
+    return true;
+}
+
+// 命令行指定的串口链路参数覆盖配置
+static void apply_serial_options(InputManager* input_manager, const SimOptions& options) {
+    if (options.delay_ms >= 0) input_manager->setTouchResponseDelay(static_cast<uint8_t>(options.delay_ms));
+    if (options.aggregation_ms >= 0) input_manager->setDataAggregationDelay(static_cast<uint8_t>(options.aggregation_ms));
+    if (options.rate_limit_hz == 0) {
+        input_manager->setRateLimitEnabled(false);
+    } else if (options.rate_limit_hz > 0) {
+        input_manager->setRateLimitFrequency(static_cast<uint16_t>(options.rate_limit_hz));
+        input_manager->setRateLimitEnabled(true);
+    }
+    if (options.send_on_change >= 0) input_manager->setSendOnlyOnChange(options.send_on_change != 0);
+    if (options.extra_sends >= 0) input_manager->setExtraSendCount(static_cast<uint8_t>(options.extra_sends));
+    if (options.gpio_irq >= 0) input_manager->setGPIOIRQMode(options.gpio_irq != 0);
+    if (options.partial_frame_ms == 0) {
+        input_manager->setPartialFrameEnabled(false);
+    } else if (options.partial_frame_ms > 0) {
+        input_manager->setFrameStaleness(static_cast<uint8_t>(options.partial_frame_ms));
+        input_manager->setPartialFrameEnabled(true);
+    }
+}
+
+// 按键点按统计：点按开始时间 -> 第一份带按键的HID键盘报文
+struct SimButtonStats {
+    uint32_t taps = 0;
+    uint32_t presses = 0;
+    uint32_t duplicates = 0;   // 同一次点按内重复出现的按下报文 (触点抖动未被滤除)
+    bool key_down = false;
+    uint64_t tap_start_us = 0;
+    bool waiting = false;
+    LatencyHistogram latency;
+};
+
+static void set_button(SimMCP23S17* mcp, bool use_mcp, bool pressed) {
+    if (use_mcp) {
+        mcp->set_inputs(pressed ? 0xFFFE : 0xFFFF);
+    } else {
+        SimGPIO::set_input(SIM_BUTTON_PIN, !pressed);
+    }
+}
+
+// 触点抖动：边沿之后每隔SIM_BUTTON_BOUNCE_US反弹一次再回到目标电平，共bounce次
+static void schedule_button_bounce(SimMCP23S17* mcp, bool use_mcp, bool pressed, uint32_t bounce) {
+    if (bounce == 0) return;
+    SimClock::schedule_after(SIM_BUTTON_BOUNCE_US, [mcp, use_mcp, pressed, bounce]() {
+        set_button(mcp, use_mcp, !pressed);
+        SimClock::schedule_after(SIM_BUTTON_BOUNCE_US / 3, [mcp, use_mcp, pressed, bounce]() {
+            set_button(mcp, use_mcp, pressed);
+            schedule_button_bounce(mcp, use_mcp, pressed, bounce - 1);
+        });
+    });
+}
+
+// 按键脚本：每个周期交替点按MCP GPA0与MCU按键引脚 (低电平按下)，按住tap_us后松开
+static void schedule_button_script(SimMCP23S17* mcp, SimButtonStats* stats, uint32_t tap_us, uint32_t bounce, uint32_t step) {
+    SimClock::schedule_after(SIM_BUTTON_PERIOD_US, [mcp, stats, tap_us, bounce, step]() {
+        const bool use_mcp = (step & 1) == 0;
+        set_button(mcp, use_mcp, true);
+        schedule_button_bounce(mcp, use_mcp, true, bounce);
+        stats->taps++;
+        stats->tap_start_us = SimClock::now_us();
+        stats->waiting = true;
+        SimClock::schedule_after(tap_us, [mcp, use_mcp, bounce]() {
+            set_button(mcp, use_mcp, false);
+            schedule_button_bounce(mcp, use_mcp, false, bounce);
+        });
+        schedule_button_script(mcp, stats, tap_us, bounce, step + 1);
+    });
+}
+
+// 触摸脚本：每个周期按顺序点亮一个通道，偶数周期松开
+static void schedule_touch_script(SimPSoC* psoc, uint32_t step) {
+    SimClock::schedule_after(SIM_TOUCH_PERIOD_US, [psoc, step]() {
+        psoc->set_touch_mask((step & 1) ? 0 : static_cast<uint16_t>(1u << ((step >> 1) % 12)));
+        schedule_touch_script(psoc, step + 1);
+    });
+}
+
+// AD7147模型统计：校准收敛时间与点按映射核对
+struct SimAD7147Stats {
+    uint64_t calibration_start_us = 0;
+    uint64_t calibration_end_us = 0;
+    bool calibration_seen = false;
+    uint64_t touch_start_us = 0;
+    uint32_t touch_sequences = 0;     // 开始点按脚本时模型已完成的序列数
+    uint32_t touch_status_reads = 0;
+    uint32_t checks = 0;
+    uint32_t mapping_errors = 0;
+    uint64_t serial_state = 0;        // 最近一个串口触摸包的区域状态 (bit = 区域-1)
+    uint32_t press_edges = 0;         // 串口状态中区域由0变1的次数 (与点按次数比较，多出的为抖动)
+    uint32_t touches = 0;
+    uint64_t release_start_us = 0;    // 开始松开的时间，release_bit为正在等待清除的区域
+    uint64_t release_bit = 0;
+    uint32_t releases = 0;
+    uint64_t release_latency_sum_us = 0;
+    uint64_t release_latency_max_us = 0;
+    uint8_t packet[7] = {0};
+    int8_t packet_pos = -1;
+
+    void on_uart_tx(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] == MAI2SERIAL_TOUCH_START_BYTE) {
+                packet_pos = 0;
+            } else if (packet_pos < 0) {
+                continue;
+            } else if (packet_pos == 7 && data[i] == MAI2SERIAL_TOUCH_END_BYTE) {
+                uint64_t state = 0;
+                for (uint8_t k = 0; k < 7; k++) state |= static_cast<uint64_t>(packet[k] & 0x1F) << (k * 5);
+                press_edges += __builtin_popcountll(state & ~serial_state);
+                serial_state = state;
+                packet_pos = -1;
+                if (release_bit && !(serial_state & release_bit)) {
+                    const uint64_t latency = SimClock::now_us() - release_start_us;
+                    release_latency_sum_us += latency;
+                    if (latency > release_latency_max_us) release_latency_max_us = latency;
+                    releases++;
+                    release_bit = 0;
+                }
+            } else if (packet_pos < 7) {
+                packet[packet_pos++] = data[i];
+            } else {
+                packet_pos = -1;
+            }
+        }
+    }
+};
+
+// 松开时电极电容逐毫秒线性回落
+static void schedule_ad7147_release_ramp(SimAD7147* ad7147, uint8_t cin, uint32_t elapsed_ms, uint32_t ramp_ms) {
+    SimClock::schedule_after(1000, [ad7147, cin, elapsed_ms, ramp_ms]() {
+        const uint32_t elapsed = elapsed_ms + 1;
+        const int32_t touch_ff = elapsed >= ramp_ms ? 0 : static_cast<int32_t>(SIM_AD7147_TOUCH_FF * (ramp_ms - elapsed) / ramp_ms);
+        ad7147->set_touch_mask(touch_ff ? static_cast<uint16_t>(1u << cin) : 0, touch_ff);
+        if (elapsed < ramp_ms) schedule_ad7147_release_ramp(ad7147, cin, elapsed, ramp_ms);
+    });
+}
+
+// AD7147触摸脚本：每个周期结束时核对串口状态，再按顺序点按下一个电极，偶数周期松开
+// 通道N的阶段连接CIN N，关闭的通道不产生触摸
+static void schedule_ad7147_touch_script(SimAD7147* ad7147, SimAD7147Stats* stats, int32_t disabled, uint32_t release_ms, uint64_t expected, uint32_t step) {
+    SimClock::schedule_after(SIM_AD7147_TOUCH_PERIOD_US, [ad7147, stats, disabled, release_ms, expected, step]() {
+        stats->checks++;
+        if (stats->serial_state != expected) {
+            stats->mapping_errors++;
+            printf("sim: ad7147 mapping mismatch at %lluus expected=0x%llx serial=0x%llx\n",
+                   static_cast<unsigned long long>(SimClock::now_us()),
+                   static_cast<unsigned long long>(expected),
+                   static_cast<unsigned long long>(stats->serial_state));
+        }
+        const uint8_t cin = static_cast<uint8_t>((step >> 1) % 12);
+        const bool touch = (step & 1) == 0;
+        if (touch) {
+            ad7147->set_touch_mask(static_cast<uint16_t>(1u << cin), SIM_AD7147_TOUCH_FF);
+            stats->touches += cin != disabled;
+        } else {
+            if (cin != disabled) {
+                stats->release_start_us = SimClock::now_us();
+                stats->release_bit = 1ull << cin;
+            }
+            if (release_ms) {
+                schedule_ad7147_release_ramp(ad7147, cin, 0, release_ms);
+            } else {
+                ad7147->set_touch_mask(0, SIM_AD7147_TOUCH_FF);
+            }
+        }
+        const uint64_t next = (touch && cin != disabled) ? (1ull << cin) : 0;
+        schedule_ad7147_touch_script(ad7147, stats, disabled, release_ms, next, step + 1);
+    });
+}
+
+// 等待自动校准结束后开始点按
+static void schedule_ad7147_calibration_watch(InputManager* input_manager, SimAD7147* ad7147, SimAD7147Stats* stats, int32_t disabled, uint32_t release_ms) {
+    SimClock::schedule_after(1000, [input_manager, ad7147, stats, disabled, release_ms]() {
+        const bool active = input_manager->isCalibrationInProgress();
+        stats->calibration_seen |= active;
+        if (!stats->calibration_seen || active) {
+            schedule_ad7147_calibration_watch(input_manager, ad7147, stats, disabled, release_ms);
+            return;
+        }
+        stats->calibration_end_us = SimClock::now_us();
+        stats->touch_start_us = SimClock::now_us();
+        stats->touch_sequences = ad7147->get_statistics().sequences;
+        stats->touch_status_reads = ad7147->get_statistics().status_reads;
+        stats->press_edges = 0;           // 校准期间已完成的通道会随手指噪声输出，只统计点按阶段
+        schedule_ad7147_touch_script(ad7147, stats, disabled, release_ms, 0, 0);
+    });
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+
+    static SimTouchReplay replay;
+    if (options.replay_path && !replay.load(options.replay_path)) {
+        return 1;
+    }
+    if (options.config_path && !SimFS::import_host_file(options.config_path, "/config.bin")) {
+        fprintf(stderr, "sim: cannot import config %s\n", options.config_path);
+        return 1;
+    }
+
+    // 统计串口与HID输出
+    uint64_t serial_packets = 0;
+    static SimAD7147Stats ad7147_stats;
+    SimUART::set_tx_observer(0, [&serial_packets, &options](const uint8_t* data, size_t length, uint64_t start_us, uint64_t end_us) {
+        if (length > 0 && data[0] == '(') serial_packets++;
+        if (options.replay_path) replay.on_uart_tx(data, length, start_us, end_us);
+        if (options.ad7147) ad7147_stats.on_uart_tx(data, length);
+    });
+    if (!options.verbose) {
+        SimUSB::set_cdc_observer([](const uint8_t*, size_t) {});
+    }
+    static SimButtonStats button_stats;
+    SimUSB::set_hid_observer([](uint8_t report_id, const uint8_t* data, size_t length, uint64_t timestamp_us) {
+        if (report_id == static_cast<uint8_t>(HID_ReportID::REPORT_ID_TOUCHSCREEN) || length < 8) return;
+        bool key_down = false;
+        for (size_t i = 2; i < length; i++) key_down |= data[i] != 0;
+        if (key_down && button_stats.waiting) {
+            button_stats.waiting = false;
+            button_stats.presses++;
+            button_stats.latency.record(static_cast<uint32_t>(timestamp_us - button_stats.tap_start_us));
+        } else if (key_down && !button_stats.key_down) {
+            button_stats.duplicates++;
+        }
+        button_stats.key_down = key_down;
+    });
+
+    SimClock::set_core(0);
+    global_irq_init();
+
+    // 基础初始化: USB / 日志 / 配置
+    HAL_USB* hal_usb = HAL_USB_Device::getInstance();
+    hal_usb->init();
+    USB_SerialLogs* usb_logs = new USB_SerialLogs(hal_usb);
+    if (!usb_logs->init()) {
+        fprintf(stderr, "sim: USB_SerialLogs init failed\n");
+        return 1;
+    }
+    USB_SerialLogs::set_global_instance(usb_logs);
+
+    ConfigManager* config_manager = ConfigManager::getInstance();
+    if (!config_manager->initialize()) {
+        fprintf(stderr, "sim: ConfigManager init failed\n");
+        return 1;
+    }
+
+    // 外设模型
+    static SimMCP23S17 sim_mcp;
+    static SimPSoC sim_psoc;
+    static SimAD7147 sim_ad7147;
+    SimSPI::attach(1, MCP23S17_CS_PIN, &sim_mcp);
+    sim_mcp.connect_int_pin(SIM_MCP23S17_INT_PIN);
+    if (options.ad7147) {
+        sim_ad7147.set_noise(static_cast<uint16_t>(options.ad7147_noise));
+        for (uint8_t cin = 0; cin < 13 && !options.ad7147_calibrate; cin++) {
+            sim_ad7147.set_parasitic_ff(cin, SIM_AD7147_TRIMMED_FF);
+        }
+        if (options.ad7147_int_pin >= 0) sim_ad7147.connect_int_pin(static_cast<uint8_t>(options.ad7147_int_pin));
+        SimI2C::attach(I2C_Bus::I2C0, SIM_AD7147_ADDR, &sim_ad7147);
+    } else if (!options.replay_path) {
+        SimI2C::attach(I2C_Bus::I2C0, SIM_PSOC_ADDR, &sim_psoc);
+    }
+
+    // HAL层
+    HAL_UART* hal_uart0 = HAL_UART0::getInstance();
+    HAL_UART* hal_uart1 = HAL_UART1::getInstance();
+    HAL_I2C* hal_i2c0 = HAL_I2C0::getInstance();
+    HAL_I2C* hal_i2c1 = HAL_I2C1::getInstance();
+    HAL_PIO* hal_pio1 = HAL_PIO1::getInstance();
+    HAL_SPI* hal_spi1 = HAL_SPI1::getInstance();
+    if (!hal_uart0->init(UART0_TX_PIN, UART0_RX_PIN, 9600) ||
+        !hal_uart1->init(UART1_TX_PIN, UART1_RX_PIN, 9600) ||
+        !hal_i2c0->init(I2C0_SDA_PIN, I2C0_SCL_PIN, 400000) ||
+        !hal_i2c1->init(I2C1_SDA_PIN, I2C1_SCL_PIN, 400000) ||
+        !hal_pio1->init(NEOPIXEL_PIN) ||
+        !hal_spi1->init(SPI1_SCK_PIN, SPI1_MOSI_PIN, SPI1_MISO_PIN, SPI1_FREQ)) {
+        fprintf(stderr, "sim: HAL init failed\n");
+        return 1;
+    }
+
+    // 协议层
+    NeoPixel* neopixel = new NeoPixel(hal_pio1, NEOPIXEL_LEDS_NUM);
+    Mai2Serial* mai2_serial = new Mai2Serial(hal_uart0);
+    Mai2Light* mai2_light = new Mai2Light(hal_uart1);
+    MCP23S17* mcp23s17 = new MCP23S17(hal_spi1, MCP23S17_CS_PIN);
+    HID* hid = HID::getInstance();
+    if (!neopixel->init() || !mai2_serial->init() || !mai2_light->init() ||
+        !mcp23s17->init() || !hid->init(hal_usb)) {
+        fprintf(stderr, "sim: protocol init failed\n");
+        return 1;
+    }
+
+    // 服务层
+    InputManager* input_manager = InputManager::getInstance();
+    InputManager::InitConfig input_config;
+    input_config.mai2_serial = mai2_serial;
+    input_config.hid = hid;
+    input_config.ui_manager = nullptr;
+    input_config.mcp23s17 = mcp23s17;
+    input_config.mcp23s17_int_pin = SIM_MCP23S17_INT_PIN;
+    if (!input_manager->init(input_config)) {
+        fprintf(stderr, "sim: InputManager init failed\n");
+        return 1;
+    }
+    input_manager->addPhysicalKeyboard(MCP_GPIO::GPIOA0, HID_KeyCode::KEY_W, GPIOTriggerLevel::AUTO);
+    input_manager->addPhysicalKeyboard(MCP_GPIO::GPIOA1, HID_KeyCode::KEY_E, GPIOTriggerLevel::AUTO);
+    input_manager->addTouchKeyboardMapping(MAI2_A1_AREA, 1000, HID_KeyCode::KEY_W);
+    if (options.button_tap_us) {
+        // 空闲上拉为高，AUTO识别为低电平有效
+        SimGPIO::set_input(SIM_BUTTON_PIN, true);
+        input_manager->addPhysicalKeyboard(static_cast<MCU_GPIO>(SIM_BUTTON_PIN), HID_KeyCode::KEY_Q, GPIOTriggerLevel::AUTO);
+        if (options.debounce_mode >= 0) {
+            const GPIODebounceMode mode = static_cast<GPIODebounceMode>(options.debounce_mode);
+            const uint16_t debounce_us = static_cast<uint16_t>(options.debounce_us);
+            input_manager->setPhysicalKeyboardDebounce(static_cast<uint8_t>(MCP_GPIO::GPIOA0), mode, debounce_us);
+            input_manager->setPhysicalKeyboardDebounce(SIM_BUTTON_PIN, mode, debounce_us);
+        }
+    }
+
+    LightManager* light_manager = LightManager::getInstance();
+    LightManager::InitConfig light_config;
+    light_config.mai2light = mai2_light;
+    light_config.neopixel = neopixel;
+    if (!light_manager->init(light_config)) {
+        fprintf(stderr, "sim: LightManager init failed\n");
+        return 1;
+    }
+
+    TouchSensorManager touch_sensor_manager;
+    uint8_t total_devices = 0;
+    if (options.replay_path) {
+        // 回放模式：桩传感器替代I2C设备，未提供配置时使用默认区域映射
+        total_devices = replay.register_sensors(input_manager, options.config_path == nullptr);
+    } else {
+        total_devices = touch_sensor_manager.scanAndRegisterAll(hal_i2c0, hal_i2c1, 8);
+        for (uint8_t i = 0; i < total_devices; i++) {
+            TouchSensor* sensor = touch_sensor_manager.getSensor(i);
+            input_manager->registerTouchSensor(sensor);
+            // 12个通道依次映射到A1-A8/B1-B4
+            for (uint8_t ch = 0; ch < 12; ch++) {
+                input_manager->setSerialMapping(sensor->getModuleMask(), ch, static_cast<Mai2_TouchArea>(MAI2_AREA_A1 + ch));
+            }
+            if (options.ad7147 && options.ad7147_disable >= 0) {
+                sensor->setChannelEnabled(static_cast<uint8_t>(options.ad7147_disable), false);
+            }
+            if (options.ad7147 && options.ad7147_int_pin >= 0) {
+                input_manager->setTouchDeviceIntPin(sensor->getModuleMask(), static_cast<uint8_t>(options.ad7147_int_pin));
+            }
+            if (options.ad7147_software && sensor->getDeviceName().compare(0, 6, "AD7147") == 0) {
+                static_cast<AD7147*>(sensor)->setSoftwareDetection(true);
+            }
+        }
+    }
+    apply_serial_options(input_manager, options);
+    input_manager->start();
+    usb_logs->register_command("touchstat", [input_manager](const char* args) {
+        input_manager->requestTouchTelemetryDump(strcmp(args, "reset") == 0);
+    }, "touch sampling telemetry");
+    usb_logs->register_command("latency", [input_manager](const char* args) {
+        input_manager->requestTouchLatencyDump(strcmp(args, "reset") == 0);
+    }, "touch latency statistics");
+    usb_logs->register_command("rawstream", [input_manager, usb_logs](const char* args) {
+        // rawstream off | rawstream <设备掩码hex|all> [阶段掩码hex] [抽取]
+        if (strncmp(args, "off", 3) == 0 || *args == '\0') {
+            input_manager->stopRawStream();
+            return;
+        }
+        uint8_t module = 0;
+        uint16_t stages = 0;
+        uint8_t decimation = 0;
+        if (!TouchRawStream::parse_args(args, module, stages, decimation)) {
+            usb_logs->warningf("usage: %s", TOUCH_RAW_STREAM_USAGE);
+            return;
+        }
+        input_manager->startRawStream(module, stages, decimation);
+    }, "raw CDC binary stream");
+
+    // 主机侧开启串口触摸上报
+    static const uint8_t stat_cmd[] = {'{', 'S', 'T', 'A', 'T', '}'};
+    SimUART::inject_rx(0, stat_cmd, sizeof(stat_cmd));
+    uint64_t run_us = static_cast<uint64_t>(options.duration_ms) * 1000;
+    if (options.replay_path) {
+        // 等待{STAT}接收完成后再开始回放
+        SimClock::advance_us(SimUART::byte_time_us(0) * (sizeof(stat_cmd) + 1));
+        replay.set_silent_module(options.silent_module);
+        replay.schedule(input_manager);
+        run_us = replay.duration_us() + SIM_REPLAY_TAIL_US;
+    } else if (options.ad7147) {
+        if (options.ad7147_calibrate) {
+            ad7147_stats.calibration_start_us = SimClock::now_us();
+            input_manager->calibrateAllSensors();
+            schedule_ad7147_calibration_watch(input_manager, &sim_ad7147, &ad7147_stats, options.ad7147_disable, options.ad7147_release_ms);
+        } else {
+            ad7147_stats.touch_start_us = SimClock::now_us();
+            schedule_ad7147_touch_script(&sim_ad7147, &ad7147_stats, options.ad7147_disable, options.ad7147_release_ms, 0, 0);
+        }
+        if (options.record_path) input_manager->startTouchTrace();
+    } else {
+        schedule_touch_script(&sim_psoc, 0);
+        if (options.record_path) input_manager->startTouchTrace();
+    }
+    if (options.button_tap_us) {
+        schedule_button_script(&sim_mcp, &button_stats, options.button_tap_us, options.button_bounce, 0);
+    }
+
+    if (options.cdc_command) {
+        // 留出一个日志刷新周期让输出落到标准输出
+        static std::string cdc_line;
+        cdc_line = std::string(options.cdc_command) + "\r\n";
+        SimClock::schedule_after(run_us > 200000 ? run_us - 200000 : 0, []() {
+            SimUSB::inject_cdc(reinterpret_cast<const uint8_t*>(cdc_line.data()), cdc_line.size());
+        });
+    }
+
+    // 双核交替主循环
+    uint64_t iterations = 0;
+    const uint64_t end_us = SimClock::now_us() + run_us;
+    auto host_start = std::chrono::steady_clock::now();
+    while (SimClock::now_us() < end_us) {
+        SimClock::set_core(0);
+        input_manager->task0();
+        config_manager->save_config_task();
+        TimerWheel::core().run(time_us_32());
+
+        SimClock::set_core(1);
+        input_manager->task1();
+        usb_logs->task();
+        light_manager->task();
+        TimerWheel::core().run(time_us_32());
+
+        SimClock::advance_us(options.loop_us);
+        iterations++;
+    }
+    auto host_end = std::chrono::steady_clock::now();
+
+    if (options.record_path) {
+        // 停止录制后由task0完成保存
+        input_manager->stopTouchTrace();
+        SimClock::set_core(0);
+        input_manager->task0();
+        if (!SimFS::export_host_file(TOUCH_TRACE_FILE_PATH, options.record_path)) {
+            fprintf(stderr, "sim: touch trace save failed\n");
+            return 1;
+        }
+    }
+    double host_ns = std::chrono::duration<double, std::nano>(host_end - host_start).count();
+
+    printf("sim: devices=%u virtual_ms=%llu iterations=%llu host_ns_per_iteration=%.1f\n",
+           total_devices,
+           static_cast<unsigned long long>(SimClock::now_us() / 1000),
+           static_cast<unsigned long long>(iterations),
+           iterations ? host_ns / iterations : 0.0);
+    printf("sim: serial_packets=%llu uart0_tx_bytes=%llu hid_reports=%u i2c0_transactions=%u\n",
+           static_cast<unsigned long long>(serial_packets),
+           static_cast<unsigned long long>(SimUART::tx_byte_count(0)),
+           SimUSB::hid_report_count(),
+           SimI2C::get_statistics(I2C_Bus::I2C0).transactions);
+    for (uint8_t i = 0; i < static_cast<uint8_t>(TouchLatencyStage::COUNT); i++) {
+        const TouchLatencyStage stage = static_cast<TouchLatencyStage>(i);
+        const LatencyHistogram& histogram = input_manager->getTouchLatencyHistogram(stage);
+        printf("sim: latency %-14s n=%lu p50=%luus p99=%luus max=%luus\n",
+               InputManager::getTouchLatencyStageName(stage),
+               static_cast<unsigned long>(histogram.count()),
+               static_cast<unsigned long>(histogram.percentile(50)),
+               static_cast<unsigned long>(histogram.percentile(99)),
+               static_cast<unsigned long>(histogram.max_us()));
+    }
+    for (uint8_t core = 0; core < 2; core++) {
+        SimClock::set_core(core);
+        const TimerWheelStats& stats = TimerWheel::core().get_stats();
+        printf("sim: timers core%u fired=%lu late avg=%luus max=%luus\n", core,
+               static_cast<unsigned long>(stats.fired),
+               static_cast<unsigned long>(stats.fired ? stats.total_late_us / stats.fired : 0),
+               static_cast<unsigned long>(stats.max_late_us));
+    }
+    printf("sim: i2c frame cost bus0=%luus bus1=%luus\n",
+           static_cast<unsigned long>(input_manager->getI2CBusFrameCost(0)),
+           static_cast<unsigned long>(input_manager->getI2CBusFrameCost(1)));
+    for (uint8_t i = 0; i < total_devices; i++) {
+        const InputManager::TouchDeviceTiming& timing = input_manager->getTouchDeviceTiming(i);
+        printf("sim: device %u cost=%uus ready=%uus samples=%lu not_ready=%lu failed=%lu\n",
+               i, timing.cost_us, timing.ready_us, static_cast<unsigned long>(timing.samples),
+               static_cast<unsigned long>(timing.not_ready_polls), static_cast<unsigned long>(timing.failure_total));
+    }
+    printf("sim: i2c util bus0=%u.%u%% bus1=%u.%u%%\n",
+           input_manager->getI2CBusUtilisation(0) / 10, input_manager->getI2CBusUtilisation(0) % 10,
+           input_manager->getI2CBusUtilisation(1) / 10, input_manager->getI2CBusUtilisation(1) % 10);
+    for (uint8_t i = 0; i < total_devices; i++) {
+        const InputManager::TouchDeviceTelemetry& telemetry = input_manager->getTouchDeviceTelemetry(i);
+        printf("sim: device %u rate=%u/s nack=%lu cost avg=%uus max=%uus last_ok=%lums\n",
+               i, telemetry.samples_per_sec, static_cast<unsigned long>(telemetry.nacks),
+               telemetry.mean_cost_us, telemetry.max_cost_us,
+               static_cast<unsigned long>(input_manager->getTimeSinceLastSample(i)));
+    }
+    if (input_manager->getPartialFrameEnabled()) {
+        const InputManager::TouchFrameStats& frames = input_manager->getTouchFrameStats();
+        printf("sim: frames staleness=%ums full=%lu partial=%lu stale_now=0x%04lx\n",
+               input_manager->getFrameStaleness(),
+               static_cast<unsigned long>(frames.full_frames),
+               static_cast<unsigned long>(frames.partial_frames),
+               static_cast<unsigned long>(input_manager->getStaleDeviceBitmap()));
+    }
+    if (options.button_tap_us) {
+        printf("sim: buttons gpio_irq=%s taps=%u presses=%u duplicates=%u tap->hid p50=%luus p99=%luus max=%luus\n",
+               input_manager->getGPIOIRQMode() ? "on" : "off",
+               button_stats.taps, button_stats.presses, button_stats.duplicates,
+               static_cast<unsigned long>(button_stats.latency.percentile(50)),
+               static_cast<unsigned long>(button_stats.latency.percentile(99)),
+               static_cast<unsigned long>(button_stats.latency.max_us()));
+    }
+    if (options.ad7147) {
+        const SimAD7147::Statistics& ad7147 = sim_ad7147.get_statistics();
+        if (options.ad7147_calibrate && ad7147_stats.calibration_end_us) {
+            printf("sim: ad7147 calibration=%llums abnormal=0x%03lx\n",
+                   static_cast<unsigned long long>((ad7147_stats.calibration_end_us - ad7147_stats.calibration_start_us) / 1000),
+                   total_devices ? static_cast<unsigned long>(touch_sensor_manager.getSensor(0)->getAbnormalChannelMask()) : 0ul);
+        } else if (options.ad7147_calibrate) {
+            printf("sim: ad7147 calibration not finished\n");
+        }
+        printf("sim: ad7147 cdc");
+        for (uint8_t stage = 0; stage < 12; stage++) printf(" %u", sim_ad7147.get_cdc(stage));
+        printf("\n");
+        // 吞吐只统计点按阶段 (校准期间每次采样都带回CDC)
+        const uint64_t touch_us = ad7147_stats.touch_start_us ? SimClock::now_us() - ad7147_stats.touch_start_us : 0;
+        const uint32_t sequences = ad7147.sequences - ad7147_stats.touch_sequences;
+        const uint32_t samples = ad7147.status_reads - ad7147_stats.touch_status_reads;
+        printf("sim: ad7147 sequence=%luus sequences=%lu (%llu/s) samples=%lu (%llu/s) stale=%lu cdc_reads=%lu config_writes=%lu\n",
+               static_cast<unsigned long>(sim_ad7147.sequence_time_us()),
+               static_cast<unsigned long>(sequences),
+               static_cast<unsigned long long>(touch_us ? sequences * 1000000ull / touch_us : 0),
+               static_cast<unsigned long>(samples),
+               static_cast<unsigned long long>(touch_us ? samples * 1000000ull / touch_us : 0),
+               static_cast<unsigned long>(ad7147.stale_reads),
+               static_cast<unsigned long>(ad7147.cdc_reads),
+               static_cast<unsigned long>(ad7147.config_writes));
+        printf("sim: ad7147 touch checks=%lu mapping_errors=%lu touches=%lu press_edges=%lu\n",
+               static_cast<unsigned long>(ad7147_stats.checks),
+               static_cast<unsigned long>(ad7147_stats.mapping_errors),
+               static_cast<unsigned long>(ad7147_stats.touches),
+               static_cast<unsigned long>(ad7147_stats.press_edges));
+        printf("sim: ad7147 detect=%s release ramp=%lums releases=%lu latency avg=%lluus max=%lluus\n",
+               options.ad7147_software ? "software" : "chip",
+               static_cast<unsigned long>(options.ad7147_release_ms),
+               static_cast<unsigned long>(ad7147_stats.releases),
+               static_cast<unsigned long long>(ad7147_stats.releases ? ad7147_stats.release_latency_sum_us / ad7147_stats.releases : 0),
+               static_cast<unsigned long long>(ad7147_stats.release_latency_max_us));
+    }
+    if (options.replay_path) {
+        replay.report(stdout, options.print_packets);
+    }
+    return 0;
+}
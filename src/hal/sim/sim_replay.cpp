@@ -0,0 +1,230 @@
+#include "sim_replay.h"
+#include "sim_hal.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "../../protocol/mai2serial/mai2serial.h"
+#include "../../service/input_manager/input_manager.h"
+#include "../../service/input_manager/touch_trace.h"
+
+SimReplaySensor::SimReplaySensor(uint8_t module_mask) : TouchSensor(24) {
+    module_mask_ = module_mask;
+    supported_channel_count_ = 24;
+}
+
+bool SimTouchReplay::load(const char* host_path) {
+    std::ifstream in(host_path, std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "replay: cannot open %s\n", host_path);
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    TouchTraceReader reader(data.data(), data.size());
+    if (!reader.valid()) {
+        fprintf(stderr, "replay: %s is not a touch trace\n", host_path);
+        return false;
+    }
+
+    records_.clear();
+    modules_.clear();
+    TouchSampleResult result;
+    const uint32_t first_timestamp_us = reader.header().first_timestamp_us;
+    while (reader.next(result)) {
+        result.timestamp_us -= first_timestamp_us;
+        records_.push_back(result);
+        if (std::find(modules_.begin(), modules_.end(), result.module_mask) == modules_.end()) {
+            modules_.push_back(result.module_mask);
+        }
+    }
+    if (!reader.valid()) {
+        fprintf(stderr, "replay: %s truncated after %zu records\n", host_path, records_.size());
+    }
+    if (records_.size() != reader.header().record_count) {
+        fprintf(stderr, "replay: header declares %u records, decoded %zu\n",
+                reader.header().record_count, records_.size());
+    }
+    module_state_.assign(modules_.size(), 0);
+    return !records_.empty();
+}
+
+uint8_t SimTouchReplay::register_sensors(InputManager* input_manager, bool default_mapping) {
+    uint8_t area_idx = 0;
+    for (uint8_t module_mask : modules_) {
+        sensors_.emplace_back(new SimReplaySensor(module_mask));
+        if (!input_manager->registerTouchSensor(sensors_.back().get())) {
+            sensors_.pop_back();
+            continue;
+        }
+        if (!default_mapping) continue;
+
+        // 轨迹中出现过的通道依次映射到区域1-34
+        uint32_t used_channels = 0;
+        for (const TouchSampleResult& record : records_) {
+            if (record.module_mask == module_mask) used_channels |= record.channel_mask;
+        }
+        for (uint8_t ch = 0; ch < 24 && area_idx < 34; ch++) {
+            if (used_channels & (1UL << ch)) {
+                input_manager->setSerialMapping(module_mask, ch, static_cast<Mai2_TouchArea>(MAI2_AREA_A1 + area_idx++));
+            }
+        }
+    }
+    return static_cast<uint8_t>(sensors_.size());
+}
+
+void SimTouchReplay::schedule(InputManager* input_manager) {
+    const uint64_t start_us = SimClock::now_us();
+    const bool silent = silent_module_ >= 0 && static_cast<size_t>(silent_module_) < modules_.size();
+    for (const TouchSampleResult& record : records_) {
+        if (silent && record.module_mask == modules_[silent_module_]) continue;
+        SimClock::schedule_at(start_us + record.timestamp_us, [this, input_manager, record]() {
+            inject(input_manager, record);
+        });
+    }
+}
+
+uint64_t SimTouchReplay::duration_us() const {
+    return records_.empty() ? 0 : records_.back().timestamp_us;
+}
+
+void SimTouchReplay::inject(InputManager* input_manager, const TouchSampleResult& record) {
+    // 采样完成回调在Core0的DMA中断中执行
+    const uint8_t core = SimClock::current_core();
+    SimClock::set_core(0);
+
+    TouchSampleResult result = record;
+    result.timestamp_us = static_cast<uint32_t>(SimClock::now_us());
+    if (result.timestamp_us == 0) result.timestamp_us = 1;  // 0 表示采样失败
+    input_manager->injectTouchSample(result);
+
+    for (size_t i = 0; i < modules_.size(); i++) {
+        if (modules_[i] == record.module_mask) {
+            module_state_[i] = record.channel_mask;
+            break;
+        }
+    }
+    uint64_t state = compute_ideal_state(input_manager);
+    if (state != ideal_state_) {
+        ideal_state_ = state;
+        transitions_.push_back({SimClock::now_us(), state});
+    }
+    SimClock::set_core(core);
+}
+
+uint64_t SimTouchReplay::compute_ideal_state(InputManager* input_manager) const {
+    uint64_t state = 0;
+    for (size_t i = 0; i < modules_.size(); i++) {
+        uint32_t mask = module_state_[i];
+        while (mask) {
+            uint8_t ch = static_cast<uint8_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+            Mai2_TouchArea area = input_manager->getSerialMapping(modules_[i], ch);
+            if (area != MAI2_NO_USED) state |= 1ULL << (area - 1);
+        }
+    }
+    return state;
+}
+
+void SimTouchReplay::on_uart_tx(const uint8_t* data, size_t length, uint64_t start_us, uint64_t end_us) {
+    for (size_t i = 0; i < length; i++) {
+        const uint8_t byte = data[i];
+        if (byte == MAI2SERIAL_TOUCH_START_BYTE) {
+            packet_pos_ = 0;
+            continue;
+        }
+        if (packet_pos_ < 0) continue;
+        if (byte == MAI2SERIAL_TOUCH_END_BYTE && packet_pos_ == 7) {
+            uint64_t state = 0;
+            for (uint8_t k = 0; k < 7; k++) {
+                state |= static_cast<uint64_t>(packet_buffer_[k] & 0x1F) << (k * 5);
+            }
+            // 包的可见时间取结束字节发送完成的时刻
+            uint64_t byte_end_us = start_us + (end_us - start_us) * (i + 1) / length;
+            packets_.push_back({byte_end_us, state});
+            packet_pos_ = -1;
+        } else if (packet_pos_ < 7) {
+            packet_buffer_[packet_pos_++] = byte;
+        } else {
+            packet_pos_ = -1;
+        }
+    }
+}
+
+void SimTouchReplay::report(FILE* out, bool print_packets) const {
+    // 按先进先出把包匹配到状态变化：与已发送状态相同的包为重发；否则命中最早一个已到达、尚未匹配且状态相同的变化，
+    // 排在它之前的未匹配变化计为丢失 (链路按顺序发送，不会先发较晚的变化)。
+    // 延迟超过相邻变化间隔时，同一状态会在队列中出现多次，取最晚者会把包配到错误的变化上
+    std::vector<int64_t> latency(transitions_.size(), -1);
+    size_t next = 0;
+    uint64_t held_state = 0;
+    uint32_t ghost_packets = 0;
+    uint32_t repeat_packets = 0;
+
+    for (const Packet& packet : packets_) {
+        if (packet.state == held_state) {
+            repeat_packets++;
+            continue;
+        }
+        size_t match = SIZE_MAX;
+        for (size_t k = next; k < transitions_.size() && transitions_[k].time_us <= packet.time_us; k++) {
+            if (transitions_[k].state == packet.state) {
+                match = k;
+                break;
+            }
+        }
+        const char* kind;
+        if (match != SIZE_MAX) {
+            latency[match] = static_cast<int64_t>(packet.time_us - transitions_[match].time_us);
+            next = match + 1;
+            held_state = packet.state;
+            kind = "match";
+        } else {
+            ghost_packets++;
+            held_state = packet.state;
+            kind = "ghost";
+        }
+        if (print_packets) {
+            if (match != SIZE_MAX) {
+                fprintf(out, "packet t=%llu state=0x%09llx %s T%zu latency_us=%lld\n",
+                        static_cast<unsigned long long>(packet.time_us),
+                        static_cast<unsigned long long>(packet.state), kind, match,
+                        static_cast<long long>(latency[match]));
+            } else {
+                fprintf(out, "packet t=%llu state=0x%09llx %s\n",
+                        static_cast<unsigned long long>(packet.time_us),
+                        static_cast<unsigned long long>(packet.state), kind);
+            }
+        }
+    }
+
+    std::vector<int64_t> delivered;
+    uint32_t dropped = 0;
+    for (size_t k = 0; k < transitions_.size(); k++) {
+        if (latency[k] >= 0) {
+            delivered.push_back(latency[k]);
+            fprintf(out, "transition T%zu t=%llu state=0x%09llx latency_us=%lld\n", k,
+                    static_cast<unsigned long long>(transitions_[k].time_us),
+                    static_cast<unsigned long long>(transitions_[k].state),
+                    static_cast<long long>(latency[k]));
+        } else {
+            dropped++;
+            fprintf(out, "transition T%zu t=%llu state=0x%09llx dropped\n", k,
+                    static_cast<unsigned long long>(transitions_[k].time_us),
+                    static_cast<unsigned long long>(transitions_[k].state));
+        }
+    }
+
+    std::sort(delivered.begin(), delivered.end());
+    auto percentile = [&delivered](uint32_t p) -> long long {
+        if (delivered.empty()) return 0;
+        size_t idx = (delivered.size() * p + 99) / 100;
+        return delivered[idx ? idx - 1 : 0];
+    };
+    fprintf(out, "replay: records=%zu transitions=%zu delivered=%zu dropped=%u packets=%zu repeat=%u ghost=%u\n",
+            records_.size(), transitions_.size(), delivered.size(), dropped,
+            packets_.size(), repeat_packets, ghost_packets);
+    fprintf(out, "replay: latency_us p50=%lld p99=%lld max=%lld\n",
+            percentile(50), percentile(99), delivered.empty() ? 0LL : static_cast<long long>(delivered.back()));
+}
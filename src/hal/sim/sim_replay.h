@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <vector>
+#include "../../protocol/touch_sensor/touch_sensor.h"
+
+class InputManager;
+
+/**
+ * 触摸轨迹回放
+ * 读取 TouchTraceRecorder 保存的轨迹，以桩传感器替代真实I2C设备注册到 InputManager，
+ * 按轨迹中的相对时序在虚拟时钟上注入采样结果，驱动
+ * storeDelayedSerialState -> processSerialModeWithDelay -> Mai2Serial::send_touch_data 整条链路。
+ * 同时解析UART0发出的触摸包，与按串口映射计算出的理想区域状态逐次比对，
+ * 给出每次状态变化的延迟、丢失的状态变化与输入中从未出现过的状态包 (ghost)。
+ */
+
+// 回放用桩传感器 - 只提供模块掩码，永不被采样
+class SimReplaySensor : public TouchSensor {
+public:
+    explicit SimReplaySensor(uint8_t module_mask);
+
+    void sample(async_touchsampleresult /*callback*/) override {}
+    bool sample_ready() override { return false; }
+    uint32_t getSupportedChannelCount() const override { return 24; }
+    bool init() override { return true; }
+    void deinit() override {}
+    bool isInitialized() const override { return true; }
+};
+
+class SimTouchReplay {
+public:
+    // 从主机文件加载轨迹
+    bool load(const char* host_path);
+
+    // 为轨迹中出现过的模块注册桩传感器，default_mapping=true 时按出现过的通道依次映射到A1-E8
+    uint8_t register_sensors(InputManager* input_manager, bool default_mapping);
+
+    // 模拟第index个模块 (按轨迹中出现顺序) 停止响应：其记录不再注入，也不计入理想状态
+    void set_silent_module(int32_t index) { silent_module_ = index; }
+
+    // 从当前虚拟时间开始按原始时序挂载全部注入事件
+    void schedule(InputManager* input_manager);
+
+    // UART0 发送观察者
+    void on_uart_tx(const uint8_t* data, size_t length, uint64_t start_us, uint64_t end_us);
+
+    // 轨迹时长 (us)
+    uint64_t duration_us() const;
+    uint32_t record_count() const { return static_cast<uint32_t>(records_.size()); }
+
+    void report(FILE* out, bool print_packets) const;
+
+private:
+    struct Transition {
+        uint64_t time_us;     // 输入到达时间
+        uint64_t state;       // 理想区域状态 (bit = 区域-1)
+    };
+    struct Packet {
+        uint64_t time_us;     // 包尾字节发送完成时间
+        uint64_t state;
+    };
+
+    std::vector<TouchSampleResult> records_;            // timestamp_us 为相对首条记录的偏移
+    std::vector<uint8_t> modules_;
+    std::vector<uint32_t> module_state_;
+    std::vector<std::unique_ptr<SimReplaySensor>> sensors_;
+    std::vector<Transition> transitions_;
+    std::vector<Packet> packets_;
+    uint64_t ideal_state_ = 0;
+    int32_t silent_module_ = -1;
+
+    // UART解析状态
+    uint8_t packet_buffer_[8] = {0};
+    int8_t packet_pos_ = -1;
+
+    void inject(InputManager* input_manager, const TouchSampleResult& record);
+    uint64_t compute_ideal_state(InputManager* input_manager) const;
+};
@@ -0,0 +1,263 @@
+#include "timer_wheel.h"
+#include <string.h>
+#include "pico/time.h"
+#include "pico/stdlib.h"
+
+TimerWheel::TimerWheel()
+    : overflow_(nullptr)
+    , current_tick_(0)
+    , current_us_(0)
+    , count_(0)
+    , started_(false)
+{
+    memset(slots_, 0, sizeof(slots_));
+    memset(occupied_, 0, sizeof(occupied_));
+    reset_stats();
+}
+
+TimerWheel& TimerWheel::core() {
+    static TimerWheel wheels[2];
+    return wheels[get_core_num() & 1];
+}
+
+void TimerWheel::schedule_at(WheelTimer& timer, uint32_t deadline_us, wheel_callback_t callback, void* context) {
+    arm(timer, deadline_us, 0, callback, context);
+}
+
+void TimerWheel::schedule_after(WheelTimer& timer, uint32_t delay_us, wheel_callback_t callback, void* context) {
+    arm(timer, time_us_32() + delay_us, 0, callback, context);
+}
+
+void TimerWheel::schedule_periodic(WheelTimer& timer, uint32_t period_us, wheel_callback_t callback, void* context) {
+    arm(timer, time_us_32() + period_us, period_us, callback, context);
+}
+
+void TimerWheel::arm(WheelTimer& timer, uint32_t deadline_us, uint32_t period_us, wheel_callback_t callback, void* context) {
+    if (timer.pending()) {
+        unlink(timer);
+        count_--;
+    }
+    // 首次使用时以当前时间作为刻度起点
+    if (!started_) {
+        current_us_ = time_us_32();
+        started_ = true;
+    }
+    timer.deadline_us = deadline_us;
+    timer.period_us = period_us;
+    timer.callback = callback;
+    timer.context = context;
+    insert(timer);
+    count_++;
+}
+
+void TimerWheel::cancel(WheelTimer& timer) {
+    if (!timer.pending()) {
+        return;
+    }
+    unlink(timer);
+    timer.period_us = 0;
+    count_--;
+}
+
+void TimerWheel::link(WheelTimer& timer, WheelTimer** head, uint8_t slot) {
+    timer.next = *head;
+    if (timer.next) {
+        timer.next->pprev = &timer.next;
+    }
+    *head = &timer;
+    timer.pprev = head;
+    timer.slot = slot;
+    if (slot < OVERFLOW_SLOT) {
+        occupied_[slot >> TIMER_WHEEL_SLOT_BITS] |= 1ULL << (slot & (TIMER_WHEEL_SLOTS - 1));
+    }
+}
+
+void TimerWheel::unlink(WheelTimer& timer) {
+    *timer.pprev = timer.next;
+    if (timer.next) {
+        timer.next->pprev = timer.pprev;
+    }
+    if (timer.slot < OVERFLOW_SLOT && !slots_[timer.slot]) {
+        occupied_[timer.slot >> TIMER_WHEEL_SLOT_BITS] &= ~(1ULL << (timer.slot & (TIMER_WHEEL_SLOTS - 1)));
+    }
+    timer.next = nullptr;
+    timer.pprev = nullptr;
+}
+
+// 按截止时间所在刻度与当前刻度的最高不同位选择层级，保证槽位总在当前位置之后
+void TimerWheel::insert(WheelTimer& timer) {
+    const int32_t delta = static_cast<int32_t>(timer.deadline_us - current_us_);
+    const uint32_t expiry = current_tick_ + (delta > 0 ? (static_cast<uint32_t>(delta) >> TIMER_WHEEL_TICK_SHIFT) : 0);
+    const uint32_t diff = expiry ^ current_tick_;
+    uint8_t slot;
+    if (diff < (1u << TIMER_WHEEL_SLOT_BITS)) {
+        slot = expiry & (TIMER_WHEEL_SLOTS - 1);
+    } else if (diff < (1u << (2 * TIMER_WHEEL_SLOT_BITS))) {
+        slot = TIMER_WHEEL_SLOTS + ((expiry >> TIMER_WHEEL_SLOT_BITS) & (TIMER_WHEEL_SLOTS - 1));
+    } else if (diff < (1u << (3 * TIMER_WHEEL_SLOT_BITS))) {
+        slot = 2 * TIMER_WHEEL_SLOTS + ((expiry >> (2 * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1));
+    } else {
+        link(timer, &overflow_, OVERFLOW_SLOT);
+        return;
+    }
+    link(timer, &slots_[slot], slot);
+}
+
+// 把一个上层槽 (或溢出链表) 的定时器重新按截止时间分配
+void TimerWheel::cascade(uint8_t level, uint8_t index) {
+    WheelTimer** head = (level < TIMER_WHEEL_LEVELS) ? &slots_[level * TIMER_WHEEL_SLOTS + index] : &overflow_;
+    WheelTimer* timer = *head;
+    *head = nullptr;
+    if (level < TIMER_WHEEL_LEVELS) {
+        occupied_[level] &= ~(1ULL << index);
+    }
+    while (timer) {
+        WheelTimer* next = timer->next;
+        timer->next = nullptr;
+        timer->pprev = nullptr;
+        insert(*timer);
+        timer = next;
+    }
+}
+
+// 执行第0级当前槽中已到期的定时器；未到期的 (同一刻度内稍后) 留在槽中
+uint32_t TimerWheel::fire_current(uint32_t now_us) {
+    const uint8_t slot = current_tick_ & (TIMER_WHEEL_SLOTS - 1);
+    if (!slots_[slot]) {
+        return 0;
+    }
+    // 先把整槽摘到本地链表，回调中可以安全地调度/取消任意定时器
+    WheelTimer* local = slots_[slot];
+    slots_[slot] = nullptr;
+    occupied_[0] &= ~(1ULL << slot);
+    local->pprev = &local;
+    for (WheelTimer* t = local; t; t = t->next) {
+        t->slot = DETACHED_SLOT;
+    }
+
+    uint32_t fired = 0;
+    while (local) {
+        WheelTimer& timer = *local;
+        unlink(timer);
+        const int32_t late = static_cast<int32_t>(now_us - timer.deadline_us);
+        if (late < 0) {
+            insert(timer);
+            continue;
+        }
+        stats_.fired++;
+        stats_.last_late_us = static_cast<uint32_t>(late);
+        stats_.total_late_us += static_cast<uint32_t>(late);
+        if (stats_.last_late_us > stats_.max_late_us) {
+            stats_.max_late_us = stats_.last_late_us;
+        }
+        fired++;
+        if (timer.period_us) {
+            // 周期定时器先重新调度，回调中仍可取消
+            timer.deadline_us += timer.period_us;
+            if (static_cast<int32_t>(now_us - timer.deadline_us) >= 0) {
+                timer.deadline_us = now_us + timer.period_us;
+            }
+            insert(timer);
+        } else {
+            count_--;
+        }
+        timer.callback(timer.context);
+    }
+    return fired;
+}
+
+// 当前刻度之后下一个需要处理的刻度：第0级非空槽，或上层非空槽/溢出链表对应的窗口起点
+bool TimerWheel::next_event_tick(uint32_t& tick) const {
+    const uint32_t cur = current_tick_;
+    for (uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        const uint8_t shift = level * TIMER_WHEEL_SLOT_BITS;
+        const uint8_t index = (cur >> shift) & (TIMER_WHEEL_SLOTS - 1);
+        const uint64_t later = (index == TIMER_WHEEL_SLOTS - 1) ? 0 : (occupied_[level] & (~0ULL << (index + 1)));
+        if (later) {
+            const uint32_t window_mask = ~((1u << (shift + TIMER_WHEEL_SLOT_BITS)) - 1);
+            tick = (cur & window_mask) | (static_cast<uint32_t>(__builtin_ctzll(later)) << shift);
+            return true;
+        }
+    }
+    if (overflow_) {
+        tick = (cur | ((1u << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)) + 1;
+        return true;
+    }
+    return false;
+}
+
+uint32_t TimerWheel::run(uint32_t now_us) {
+    if (!started_) {
+        current_us_ = now_us;
+        started_ = true;
+    }
+    const int32_t elapsed = static_cast<int32_t>(now_us - current_us_);
+    const uint32_t target = current_tick_ + (elapsed > 0 ? (static_cast<uint32_t>(elapsed) >> TIMER_WHEEL_TICK_SHIFT) : 0);
+
+    uint32_t fired = fire_current(now_us);
+    while (current_tick_ != target) {
+        // 跳过空刻度：直接前进到下一个有事件的刻度 (不超过目标)
+        uint32_t tick;
+        if (!next_event_tick(tick) || static_cast<int32_t>(tick - target) > 0) {
+            tick = target;
+        }
+        current_us_ += (tick - current_tick_) << TIMER_WHEEL_TICK_SHIFT;
+        current_tick_ = tick;
+
+        // 由高到低下放进入新窗口的槽
+        if ((tick & ((1u << (3 * TIMER_WHEEL_SLOT_BITS)) - 1)) == 0) {
+            cascade(TIMER_WHEEL_LEVELS, 0);
+        }
+        if ((tick & ((1u << (2 * TIMER_WHEEL_SLOT_BITS)) - 1)) == 0) {
+            cascade(2, (tick >> (2 * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1));
+        }
+        if ((tick & (TIMER_WHEEL_SLOTS - 1)) == 0) {
+            cascade(1, (tick >> TIMER_WHEEL_SLOT_BITS) & (TIMER_WHEEL_SLOTS - 1));
+        }
+        fired += fire_current(now_us);
+    }
+    return fired;
+}
+
+bool TimerWheel::next_deadline(uint32_t& deadline_us) const {
+    if (count_ == 0) {
+        return false;
+    }
+    // 当前槽中的定时器按精确截止时间计算
+    const WheelTimer* current = slots_[current_tick_ & (TIMER_WHEEL_SLOTS - 1)];
+    if (current) {
+        deadline_us = current->deadline_us;
+        for (const WheelTimer* t = current->next; t; t = t->next) {
+            if (static_cast<int32_t>(t->deadline_us - deadline_us) < 0) {
+                deadline_us = t->deadline_us;
+            }
+        }
+        return true;
+    }
+    uint32_t tick;
+    if (!next_event_tick(tick)) {
+        return false;
+    }
+    deadline_us = current_us_ + ((tick - current_tick_) << TIMER_WHEEL_TICK_SHIFT);
+    return true;
+}
+
+void TimerWheel::wait_for_next(uint32_t max_wait_us) const {
+    const uint32_t now = time_us_32();
+    uint32_t wait_us = max_wait_us;
+    uint32_t deadline;
+    if (next_deadline(deadline)) {
+        const int32_t remaining = static_cast<int32_t>(deadline - now);
+        if (remaining <= 0) {
+            return;
+        }
+        if (static_cast<uint32_t>(remaining) < wait_us) {
+            wait_us = static_cast<uint32_t>(remaining);
+        }
+    }
+    best_effort_wfe_or_timeout(make_timeout_time_us(wait_us));
+}
+
+void TimerWheel::reset_stats() {
+    memset(&stats_, 0, sizeof(stats_));
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * 分层时间轮 (每个核心一个实例)
+ * 统一管理固件中的超时与周期任务：插入/取消O(1)，可查询下一个截止时间用于空闲睡眠，
+ * 到期回调时统计迟到时间，作为定时精度的唯一观测点。
+ *
+ * 结构：3级 x 64槽，单位刻度64us
+ *   第0级 - 每槽1刻度，覆盖 4.096ms
+ *   第1级 - 每槽64刻度，覆盖 262ms
+ *   第2级 - 每槽4096刻度，覆盖 16.7s
+ *   更远的定时器放入溢出链表，每16.7s重新分配一次
+ * 上层槽在进入对应窗口时下放 (cascade) 到下一级；第0级当前槽按实际截止时间精确判断，
+ * 因此回调迟到只取决于run()的调用间隔，而不受刻度大小影响。
+ *
+ * 约束：定时器只能由所属核心调度/取消，回调在该核心的run()中执行 (非中断上下文)；
+ * 截止时间距当前不能超过2^31us。
+ */
+
+#define TIMER_WHEEL_TICK_SHIFT 6
+#define TIMER_WHEEL_TICK_US (1u << TIMER_WHEEL_TICK_SHIFT)
+#define TIMER_WHEEL_LEVELS 3
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_SLOT_BITS)
+
+typedef void (*wheel_callback_t)(void* context);
+
+// 侵入式定时器节点，由使用者静态分配
+struct WheelTimer {
+    WheelTimer* next;
+    WheelTimer** pprev;        // 指向前驱的next (或槽头)，用于O(1)摘除；nullptr表示未调度
+    uint32_t deadline_us;
+    uint32_t period_us;        // 非0时为周期定时器
+    wheel_callback_t callback;
+    void* context;
+    uint8_t slot;              // 所在槽 (level * 64 + index)，用于维护占用位图
+
+    WheelTimer() : next(nullptr), pprev(nullptr), deadline_us(0), period_us(0), callback(nullptr), context(nullptr), slot(0) {}
+    bool pending() const { return pprev != nullptr; }
+};
+
+// 迟到统计 (回调执行时间 - 截止时间)
+struct TimerWheelStats {
+    uint32_t fired;
+    uint32_t max_late_us;
+    uint32_t last_late_us;
+    uint64_t total_late_us;
+};
+
+class TimerWheel {
+public:
+    TimerWheel();
+
+    // 当前核心的时间轮
+    static TimerWheel& core();
+
+    // 在绝对时间deadline_us触发；已调度的定时器会先被取消
+    void schedule_at(WheelTimer& timer, uint32_t deadline_us, wheel_callback_t callback, void* context = nullptr);
+    void schedule_after(WheelTimer& timer, uint32_t delay_us, wheel_callback_t callback, void* context = nullptr);
+    // 周期定时器：首次在period_us后触发，之后按固定节拍 (不累积漂移，落后一个周期以上时跳过)
+    void schedule_periodic(WheelTimer& timer, uint32_t period_us, wheel_callback_t callback, void* context = nullptr);
+    void cancel(WheelTimer& timer);
+
+    // 推进到now_us并执行所有到期回调，返回执行的回调数
+    uint32_t run(uint32_t now_us);
+
+    // 下一个需要处理的时间点 (到期或下放)，没有定时器时返回false；结果不晚于实际最早截止时间
+    bool next_deadline(uint32_t& deadline_us) const;
+
+    // 空闲等待：睡眠到下一个时间点，最长max_wait_us；任何中断/事件都会提前唤醒
+    void wait_for_next(uint32_t max_wait_us) const;
+
+    uint32_t count() const { return count_; }
+    const TimerWheelStats& get_stats() const { return stats_; }
+    void reset_stats();
+
+private:
+    static constexpr uint8_t OVERFLOW_SLOT = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS;
+    static constexpr uint8_t DETACHED_SLOT = OVERFLOW_SLOT + 1;
+
+    WheelTimer* slots_[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    uint64_t occupied_[TIMER_WHEEL_LEVELS];  // 非空槽位图
+    WheelTimer* overflow_;
+    uint32_t current_tick_;     // 当前刻度 (自由递增)
+    uint32_t current_us_;       // 当前刻度的起始时间
+    uint32_t count_;
+    bool started_;
+    TimerWheelStats stats_;
+
+    void arm(WheelTimer& timer, uint32_t deadline_us, uint32_t period_us, wheel_callback_t callback, void* context);
+    void insert(WheelTimer& timer);
+    void link(WheelTimer& timer, WheelTimer** head, uint8_t slot);
+    void unlink(WheelTimer& timer);
+    void cascade(uint8_t level, uint8_t index);
+    uint32_t fire_current(uint32_t now_us);
+    bool next_event_tick(uint32_t& tick) const;
+};
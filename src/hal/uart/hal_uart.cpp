@@ -41,7 +41,7 @@ HAL_UART0* HAL_UART0::getInstance() {
 
 HAL_UART0::HAL_UART0() 
     : initialized_(false), tx_pin_(0), rx_pin_(0), baudrate_(115200),
-      dma_busy_(false), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
+      dma_busy_(false), last_tx_start_us_(0), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
     // 缓冲区结构体会自动初始化
 }
 
@@ -325,6 +325,7 @@ inline void HAL_UART1::trigger_tx_dma(size_t length) {
     );
 
     // 启动控制通道装载首个控制块
+    last_tx_start_us_ = time_us_32();
     dma_start_channel_mask(1u << dma_ctrl_channel_);
 }
 
@@ -403,6 +404,7 @@ inline void HAL_UART0::trigger_tx_dma(size_t length) {
     );
  
     // 启动控制通道装载首个控制块
+    last_tx_start_us_ = time_us_32();
     dma_start_channel_mask(1u << dma_ctrl_channel_);
 }
 
@@ -433,7 +435,7 @@ HAL_UART1* HAL_UART1::getInstance() {
 
 HAL_UART1::HAL_UART1() 
     : initialized_(false), tx_pin_(0), rx_pin_(0), baudrate_(115200),
-      dma_busy_(false), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
+      dma_busy_(false), last_tx_start_us_(0), dma_tx_channel_(-1), dma_ctrl_channel_(-1) {
     // 缓冲区结构体会自动初始化
 }
 
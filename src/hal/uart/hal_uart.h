@@ -99,6 +99,9 @@ public:
     // 检查DMA传输状态
     virtual bool is_busy() const = 0;
     
+    // 最近一次TX DMA启动时间 (time_us_32)
+    virtual uint32_t get_last_tx_start_us() const = 0;
+    
     // 检查可读数据数量
     virtual size_t available() = 0;
     
@@ -140,6 +143,7 @@ public:
     inline size_t get_tx_buffer_free_space() const override;
     inline size_t get_rx_buffer_data_count() const override;
     bool is_busy() const override;
+    uint32_t get_last_tx_start_us() const override { return last_tx_start_us_; }
 
     size_t available() override;
     void flush_rx() override;
@@ -160,6 +164,7 @@ private:
     uint32_t baudrate_;
     std::function<void(uint8_t)> rx_callback_;
     bool dma_busy_;
+    uint32_t last_tx_start_us_;
     dma_callback_t dma_callback_;
     int32_t dma_tx_channel_;
     int32_t dma_ctrl_channel_;  // DMA控制通道
@@ -205,6 +210,7 @@ public:
     inline size_t get_tx_buffer_free_space() const override;
     inline size_t get_rx_buffer_data_count() const override;
     bool is_busy() const override;
+    uint32_t get_last_tx_start_us() const override { return last_tx_start_us_; }
     size_t available() override;
     void flush_rx() override;
     void flush_tx() override;
@@ -224,6 +230,7 @@ private:
     uint32_t baudrate_;
     std::function<void(uint8_t)> rx_callback_;
     bool dma_busy_;
+    uint32_t last_tx_start_us_;
     dma_callback_t dma_callback_;
     int32_t dma_tx_channel_;
     int32_t dma_ctrl_channel_;  // DMA控制通道
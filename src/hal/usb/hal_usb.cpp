@@ -285,6 +285,11 @@ size_t HAL_USB_Device::cdc_available() const {
     }
 }
 
+size_t HAL_USB_Device::cdc_write_available() const {
+    if (!is_ready()) return 0;
+    return tud_cdc_write_available();
+}
+
 void HAL_USB_Device::cdc_flush() {
     if (initialized_) {
         tud_cdc_write_flush();
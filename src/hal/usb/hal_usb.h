@@ -44,6 +44,7 @@ public:
     virtual bool cdc_write(const uint8_t* data, size_t length) = 0;
     virtual size_t cdc_read(uint8_t* buffer, size_t max_length) = 0;
     virtual size_t cdc_available() const = 0;
+    virtual size_t cdc_write_available() const = 0;  // 发送缓冲剩余空间，写入不超过该值时cdc_write不会等待
     virtual void cdc_flush() = 0;
 
     // 获取实例名称
@@ -64,6 +65,7 @@ public:
     bool cdc_write(const uint8_t* data, size_t length) override;
     size_t cdc_read(uint8_t* buffer, size_t max_length) override;
     size_t cdc_available() const override;
+    size_t cdc_write_available() const override;
     void cdc_flush() override;
     std::string get_name() const override { return USB_DEVICE_NAME; }
     
@@ -86,7 +86,7 @@ enum class HID_KeyCode : uint8_t {
 
 // 遍历所有支持的HID键码
 #define SUPPORTED_KEYS_COUNT 61
-static const HID_KeyCode supported_keys[SUPPORTED_KEYS_COUNT] = {
+static constexpr HID_KeyCode supported_keys[SUPPORTED_KEYS_COUNT] = {
     HID_KeyCode::KEY_A, HID_KeyCode::KEY_B, HID_KeyCode::KEY_C, HID_KeyCode::KEY_D,
     HID_KeyCode::KEY_E, HID_KeyCode::KEY_F, HID_KeyCode::KEY_G, HID_KeyCode::KEY_H,
     HID_KeyCode::KEY_I, HID_KeyCode::KEY_J, HID_KeyCode::KEY_K, HID_KeyCode::KEY_L,
@@ -12,6 +12,7 @@
 #include "hal/spi/hal_spi.h"
 #include "hal/pio/hal_pio.h"
 #include "hal/usb/hal_usb.h"
+#include "hal/timer_wheel.h"
 
 extern "C" {
 #include "hal/global_irq.h"
@@ -64,6 +65,7 @@ extern "C" {
 #define SPI1_MOSI_PIN 27
 #define SPI1_SCK_PIN 26
 #define MCP23S17_CS_PIN 29
+#define MCP23S17_INT_PIN 255  // INTA/INTB (镜像合并) 所接GPIO，255表示未连接：中断模式下MCP输入仍按轮询读取
 #define SPI1_FREQ 10000000
 
 #define UART0_TX_PIN 12
@@ -83,6 +85,9 @@ extern "C" {
 // Watchdog配置
 #define WATCHDOG_TIMEOUT_MS 5000
 #define WATCHDOG_FEED_INTERVAL_MS 1000
+#define HEARTBEAT_INTERVAL_MS 500
+#define ERROR_LOOP_MAX_SLEEP_US 1000  // 错误循环空闲等待上限，保证UI与日志仍能及时处理
+#define CORE_LOOP_MAX_SLEEP_US 100    // 主循环空闲等待上限：I2C/触摸INT/UART/USB中断提前唤醒，仍为轮询的工作最多推迟该时长
 
 // 双核心初始化同步bitmap结构体
 struct CoreInitBitmap {
@@ -175,6 +180,8 @@ static UIManager* ui_manager = nullptr;
 // 系统状态
 static bool system_error = false;
 static uint32_t last_watchdog_feed[2] = {0, 0};
+static WheelTimer heartbeat_timer[2];
+static WheelTimer watchdog_timer[2];
 
 // 函数声明
 bool core0_init_hal_layer();
@@ -194,16 +201,14 @@ void emergency_shutdown();
 
 
 /**
- * 心跳任务
+ * 心跳任务 - 两个核心的时间轮每500ms各回调一次，轮到的核心翻转LED
+ * 任一核心卡住时LED停止交替
  */
-inline void heartbeat_task() {
-    static uint32_t last_heartbeat = 0;
-    static uint8_t next_core = 0;
-    uint32_t current_time = (time_us_32() / 1000);
-    if (current_time - last_heartbeat > 500 && get_core_num() == next_core) {
+static void heartbeat_task(void*) {
+    static volatile uint8_t next_core = 0;
+    if (get_core_num() == next_core) {
         gpio_put(LED_BUILTIN_PIN, next_core);
         next_core = !next_core;
-        last_heartbeat = current_time;
     }
 }
 
@@ -219,6 +224,24 @@ inline void watchdog_feed() {
     }
 }
 
+/**
+ * 看门狗定时回调 - 核心循环停止推进时间轮时不再喂狗
+ */
+static void watchdog_task(void*) {
+    watchdog_update();
+    last_watchdog_feed[get_core_num()] = time_us_32() / 1000;
+}
+
+/**
+ * 在当前核心的时间轮上注册心跳与看门狗周期任务
+ */
+void start_core_timers() {
+    const uint8_t core = get_core_num();
+    TimerWheel& wheel = TimerWheel::core();
+    wheel.schedule_periodic(heartbeat_timer[core], HEARTBEAT_INTERVAL_MS * 1000, heartbeat_task);
+    wheel.schedule_periodic(watchdog_timer[core], WATCHDOG_FEED_INTERVAL_MS * 1000, watchdog_task);
+}
+
 /**
  * 错误处理函数
  */
@@ -236,6 +259,10 @@ void error_handler(const char* error_msg) {
         ui_manager->task(); 
         usb_logs->task();
         watchdog_feed();
+        // 错误状态下没有实时任务，空闲等待代替忙轮询
+        TimerWheel& wheel = TimerWheel::core();
+        wheel.run(time_us_32());
+        wheel.wait_for_next(ERROR_LOOP_MAX_SLEEP_US);
     }
 }
 
@@ -477,6 +504,7 @@ bool init_service_layer() {
     input_config.hid = hid;
     input_config.ui_manager = ui_manager;
     input_config.mcp23s17 = mcp23s17;
+    input_config.mcp23s17_int_pin = MCP23S17_INT_PIN;
     
     if (!input_manager->init(input_config)) {
         error_handler("Failed to initialize InputManager");
@@ -535,6 +563,30 @@ bool init_service_layer() {
     // 启动InputManager - 分配设备到采样阶段
     input_manager->start();
     
+    // USB CDC诊断命令，输出在Core0的task0中完成
+    usb_logs->register_command("touchstat", [](const char* args) {
+        InputManager::getInstance()->requestTouchTelemetryDump(strcmp(args, "reset") == 0);
+    }, "触摸采样遥测 (touchstat reset: 输出后清零)");
+    usb_logs->register_command("latency", [](const char* args) {
+        InputManager::getInstance()->requestTouchLatencyDump(strcmp(args, "reset") == 0);
+    }, "触摸延迟统计 (latency reset: 输出后清零)");
+    usb_logs->register_command("rawstream", [](const char* args) {
+        // rawstream off | rawstream <设备掩码hex|all> [阶段掩码hex] [抽取]
+        InputManager* input = InputManager::getInstance();
+        if (strncmp(args, "off", 3) == 0 || *args == '\0') {
+            input->stopRawStream();
+            return;
+        }
+        uint8_t module = 0;
+        uint16_t stages = 0;
+        uint8_t decimation = 0;
+        if (!TouchRawStream::parse_args(args, module, stages, decimation)) {
+            usb_logs->warningf("用法: %s", TOUCH_RAW_STREAM_USAGE);
+            return;
+        }
+        input->startRawStream(module, stages, decimation);
+    }, "原始CDC二进制流 (" TOUCH_RAW_STREAM_USAGE ")");
+    
     // 标记服务层初始化完成
     init_sync.service_ready = 1;
     return true;
@@ -700,11 +752,13 @@ void deinit_system() {
  * 实现UART0和UART1之间的双向透传
  */
 void core0_task() {
+    start_core_timers();
+    TimerWheel& wheel = TimerWheel::core();
     while (1) {
         input_manager->task0();
         config_manager->save_config_task();  // 处理配置保存请求
-        heartbeat_task();
-        watchdog_feed();
+        wheel.run(time_us_32());             // 心跳、看门狗、保存去抖等定时任务
+        wheel.wait_for_next(CORE_LOOP_MAX_SLEEP_US);
     }
 }
 
@@ -712,13 +766,15 @@ void core0_task() {
  * Core1任务 - InputManager Loop1, UIManager Loop
  */
 void core1_task() {
+    start_core_timers();
+    TimerWheel& wheel = TimerWheel::core();
     while (1) {
         input_manager->task1();
         usb_logs->task();
         ui_manager->task();
         light_manager->task();
-        heartbeat_task();
-        watchdog_feed();
+        wheel.run(time_us_32());             // 心跳、看门狗、触摸键盘长按、屏幕刷新、灯光渐变等定时任务
+        wheel.wait_for_next(CORE_LOOP_MAX_SLEEP_US);
     }
 }
 
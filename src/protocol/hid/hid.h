@@ -93,54 +93,26 @@ union KeyboardBitmap {
         return *this;
     }
 
-    // 设置按键状态
+    // 设置按键状态 (无分支：按位索引定位字与掩码)
     inline void setKey(HID_KeyCode key, bool pressed) {
-        uint8_t bit_index = getBitIndex(key);
-        if (bit_index < 64) {
-            if (pressed) {
-                bitmap_low |= (1ULL << bit_index);
-            } else {
-                bitmap_low &= ~(1ULL << bit_index);
-            }
-        } else if (bit_index < 128) {
-            uint8_t high_bit = bit_index - 64;
-            if (pressed) {
-                bitmap_high |= (1ULL << high_bit);
-            } else {
-                bitmap_high &= ~(1ULL << high_bit);
-            }
-        }
+        const uint8_t bit_index = getBitIndex(key);
+        const uint64_t mask = 1ULL << (bit_index & 63);
+        uint64_t& word = bitmap[bit_index >> 6];
+        word = (word & ~mask) | ((static_cast<uint64_t>(0) - pressed) & mask);
     }
     
     // volatile版本的setKey方法
     inline void setKey(HID_KeyCode key, bool pressed) volatile {
-        uint8_t bit_index = getBitIndex(key);
-        if (bit_index < 64) {
-            if (pressed) {
-                bitmap_low |= (1ULL << bit_index);
-            } else {
-                bitmap_low &= ~(1ULL << bit_index);
-            }
-        } else if (bit_index < 128) {
-            uint8_t high_bit = bit_index - 64;
-            if (pressed) {
-                bitmap_high |= (1ULL << high_bit);
-            } else {
-                bitmap_high &= ~(1ULL << high_bit);
-            }
-        }
+        const uint8_t bit_index = getBitIndex(key);
+        const uint64_t mask = 1ULL << (bit_index & 63);
+        volatile uint64_t& word = bitmap[bit_index >> 6];
+        word = (word & ~mask) | ((static_cast<uint64_t>(0) - pressed) & mask);
     }
     
     // 获取按键状态
     inline bool getKey(HID_KeyCode key) const {
-        uint8_t bit_index = getBitIndex(key);
-        if (bit_index < 64) {
-            return (bitmap_low & (1ULL << bit_index)) != 0;
-        } else if (bit_index < 128) {
-            uint8_t high_bit = bit_index - 64;
-            return (bitmap_high & (1ULL << high_bit)) != 0;
-        }
-        return false;
+        const uint8_t bit_index = getBitIndex(key);
+        return (bitmap[bit_index >> 6] >> (bit_index & 63)) & 1;
     }
     
     // 清空所有按键
@@ -160,17 +132,31 @@ union KeyboardBitmap {
         return reinterpret_cast<const uint8_t*>(bitmap);
     }
     
-    // 获取HID_KeyCode对应的位索引 - 基于supported_keys数组的索引
-    inline uint8_t getBitIndex(HID_KeyCode key) const volatile {
-        // 遍历supported_keys数组找到对应的索引
+    // 获取HID_KeyCode对应的位索引 - supported_keys中的下标+1，不支持的键码返回0（KEY_NONE的位置）
+    static inline uint8_t getBitIndex(HID_KeyCode key);
+
+    // 位索引对应的HID_KeyCode (bit_index 1..SUPPORTED_KEYS_COUNT)
+    static inline HID_KeyCode getKeyAt(uint8_t bit_index) {
+        return supported_keys[bit_index - 1];
+    }
+};
+
+// HID键码 -> 位索引查找表，编译期由supported_keys生成
+struct KeyboardBitIndexTable {
+    uint8_t index[256];
+
+    constexpr KeyboardBitIndexTable() : index{} {
         for (uint8_t i = 0; i < SUPPORTED_KEYS_COUNT; i++) {
-            if (supported_keys[i] == key) {
-                return i + 1;
-            }
+            index[static_cast<uint8_t>(supported_keys[i])] = i + 1;
         }
-        return 0; // 如果找不到，返回0（KEY_NONE的位置）
     }
 };
+inline constexpr KeyboardBitIndexTable keyboard_bit_index_table{};
+static_assert(SUPPORTED_KEYS_COUNT < 128, "KeyboardBitmap holds at most 127 keys");
+
+inline uint8_t KeyboardBitmap::getBitIndex(HID_KeyCode key) {
+    return keyboard_bit_index_table.index[static_cast<uint8_t>(key)];
+}
 
 // HID类 - 单例模式
 class HID {
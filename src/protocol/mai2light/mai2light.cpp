@@ -99,6 +99,14 @@ void Mai2Light::deinit() {
     if (initialized_) {
         // 清除所有LED
         clear_all_leds();
+        // 释放后时间轮不再步进，渐变直接落到目标色
+        if (is_fading_) {
+            for (int32_t i = 0; i < MAI2LIGHT_NUM_LEDS; i++) {
+                led_status_[i].color = fade_target_colors_[i];
+            }
+            is_fading_ = false;
+            TimerWheel::core().cancel(fade_timer_);
+        }
         
         uart_hal_->deinit();
         initialized_ = false;
@@ -161,6 +169,7 @@ bool Mai2Light::set_led_color(uint8_t led_index, const Mai2Light_RGB& color) {
         if (!is_fading_) {
             is_fading_ = true;
             fade_start_time_ = time_us_32() / 1000;
+            TimerWheel::core().schedule_periodic(fade_timer_, MAI2LIGHT_FADE_STEP_US, fade_timer_callback, this);
         }
     } else {
         // 直接设置颜色
@@ -414,13 +423,8 @@ void Mai2Light::task() {
         return;
     }
     
-    // 处理接收到的数据
+    // 处理接收到的数据 (渐变由时间轮步进)
     process_received_data();
-    
-    // 更新渐变效果
-    if (is_fading_) {
-        update_fade_effects();
-    }
 }
 
 // 发送数据包
@@ -903,6 +907,11 @@ bool Mai2Light::send_string_response(const std::string& response) {
     return false;
 }
 
+// 渐变步进回调
+void Mai2Light::fade_timer_callback(void* context) {
+    static_cast<Mai2Light*>(context)->update_fade_effects();
+}
+
 // 更新渐变效果
 void Mai2Light::update_fade_effects() {
     if (!is_fading_) {
@@ -918,6 +927,7 @@ void Mai2Light::update_fade_effects() {
             led_status_[i].color = fade_target_colors_[i];
         }
         is_fading_ = false;
+        TimerWheel::core().cancel(fade_timer_);
     } else {
         // 计算渐变进度
         uint8_t progress = (elapsed_time * 255) / config_.fade_time_ms;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../hal/uart/hal_uart.h"
+#include "../../hal/timer_wheel.h"
 #include <stdint.h>
 #include <vector>
 #include <functional>
@@ -18,6 +19,7 @@
 #define MAI2LIGHT_MARKER_BYTE       0xD0    // 标记字节
 #define MAI2LIGHT_MAX_PACKET_SIZE   64      // 最大数据包大小
 #define MAI2LIGHT_DEFAULT_BAUD_RATE 115200  // 默认波特率
+#define MAI2LIGHT_FADE_STEP_US      10000   // 渐变步进周期 (Core1时间轮)
 
 // Mai2Light命令定义
 enum class Mai2Light_Command : uint8_t {
@@ -254,6 +256,8 @@ private:
     
     // 渐变效果
     void update_fade_effects();
+    static void fade_timer_callback(void* context);
+    WheelTimer fade_timer_;         // 渐变步进定时器，渐变结束后取消
     bool is_fading_;
     uint32_t fade_start_time_;
     Mai2Light_RGB fade_start_colors_[MAI2LIGHT_NUM_LEDS];
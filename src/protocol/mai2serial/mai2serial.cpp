@@ -96,14 +96,7 @@ bool Mai2Serial::send_touch_data(Mai2Serial_TouchState& touch_data) {
     static uint8_t packet[9] = {MAI2SERIAL_TOUCH_START_BYTE,0,0,0,0,0,0,0,MAI2SERIAL_TOUCH_END_BYTE};
     static uint64_t combined_bits;  // 35位数据
     combined_bits = touch_data.raw | triggle_touch_data_.raw;
-    
-    packet[1] = (uint8_t)(combined_bits & 0x1F);         // 位0-4
-    packet[2] = (uint8_t)((combined_bits >> 5) & 0x1F);  // 位5-9
-    packet[3] = (uint8_t)((combined_bits >> 10) & 0x1F); // 位10-14
-    packet[4] = (uint8_t)((combined_bits >> 15) & 0x1F); // 位15-19
-    packet[5] = (uint8_t)((combined_bits >> 20) & 0x1F); // 位20-24
-    packet[6] = (uint8_t)((combined_bits >> 25) & 0x1F); // 位25-29
-    packet[7] = (uint8_t)((combined_bits >> 30) & 0x1F); // 位30-34
+    pack_touch_packet(combined_bits, packet);
 
     // 返回是否成功写入完整数据包
     return (uart_hal_->write_to_tx_buffer(packet, 9) == 9);
@@ -164,6 +164,18 @@ public:
 
     // 数据发送
     bool send_touch_data(Mai2Serial_TouchState& touch_data);
+    // 将35位触摸状态按每字节5位打包到数据包的第1-7字节
+    static inline void pack_touch_packet(uint64_t combined_bits, uint8_t* packet) {
+        packet[1] = (uint8_t)(combined_bits & 0x1F);         // 位0-4
+        packet[2] = (uint8_t)((combined_bits >> 5) & 0x1F);  // 位5-9
+        packet[3] = (uint8_t)((combined_bits >> 10) & 0x1F); // 位10-14
+        packet[4] = (uint8_t)((combined_bits >> 15) & 0x1F); // 位15-19
+        packet[5] = (uint8_t)((combined_bits >> 20) & 0x1F); // 位20-24
+        packet[6] = (uint8_t)((combined_bits >> 25) & 0x1F); // 位25-29
+        packet[7] = (uint8_t)((combined_bits >> 30) & 0x1F); // 位30-34
+    }
+    // 最近一个数据包实际开始发送的时间 (UART TX DMA启动时刻)
+    inline uint32_t get_last_packet_tx_us() const { return uart_hal_->get_last_tx_start_us(); }
     void send_command_response(uint8_t lr, uint8_t sensor, uint8_t cmd, uint8_t value);
 
     // 状态
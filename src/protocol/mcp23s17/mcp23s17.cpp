@@ -6,7 +6,7 @@
 
 MCP23S17::MCP23S17(HAL_SPI* spi_hal, uint8_t cs_pin, uint8_t device_addr)
     : spi_hal_(spi_hal), cs_pin_(cs_pin), device_addr_(device_addr & 0x07),
-      initialized_(false), state_changed_(false) {
+      initialized_(false), state_changed_(false), bus_busy_(false) {
     memset(&last_state_, 0, sizeof(last_state_));
 }
 
@@ -160,6 +160,14 @@ bool MCP23S17::read_all_gpio(MCP23S17_GPIO_State& state) {
     return result;
 }
 
+bool MCP23S17::read_all_gpio_from_isr(MCP23S17_GPIO_State& state) {
+    // 被中断的代码正在进行SPI事务，不能插入新的片选帧
+    if (!is_ready() || bus_busy_) {
+        return false;
+    }
+    return read_all_gpio(state);
+}
+
 bool MCP23S17::set_pin_pullup(MCP23S17_Port port, uint8_t pin, bool enable) {
     if (!is_ready() || pin > 7) {
         return false;
@@ -326,6 +334,32 @@ bool MCP23S17::disable_port_interrupt(MCP23S17_Port port) {
     return write_register(reg, 0x00);
 }
 
+bool MCP23S17::enable_change_interrupt(uint8_t mask_a, uint8_t mask_b) {
+    if (!is_ready()) {
+        return false;
+    }
+    
+    // MIRROR：任一端口中断都驱动INTA与INTB，只需接一根INT线
+    bool result = configure_iocon(MCP23S17_IOCON_HAEN | MCP23S17_IOCON_MIRROR);
+    result &= enable_port_interrupt(MCP23S17_PORT_A, mask_a, MCP23S17_INT_CHANGE);
+    result &= enable_port_interrupt(MCP23S17_PORT_B, mask_b, MCP23S17_INT_CHANGE);
+    // 清除使能前遗留的中断，保证INT引脚从释放状态开始
+    result &= clear_interrupts();
+    return result;
+}
+
+bool MCP23S17::disable_change_interrupt() {
+    if (!is_ready()) {
+        return false;
+    }
+    
+    bool result = disable_port_interrupt(MCP23S17_PORT_A);
+    result &= disable_port_interrupt(MCP23S17_PORT_B);
+    result &= configure_iocon(MCP23S17_IOCON_HAEN);
+    result &= clear_interrupts();
+    return result;
+}
+
 bool MCP23S17::read_interrupt_flags(uint8_t& intf_a, uint8_t& intf_b) {
     if (!is_ready()) {
         return false;
@@ -478,6 +512,8 @@ bool MCP23S17::read_register_pair(uint8_t reg_a, uint8_t& value_a, uint8_t reg_b
 }
 
 bool MCP23S17::spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) {
+    bus_busy_ = true;
+    
     // 拉低CS
     gpio_put(cs_pin_, 0);
     
@@ -487,6 +523,7 @@ bool MCP23S17::spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t len
     // 拉高CS
     gpio_put(cs_pin_, 1);
     
+    bus_busy_ = false;
     return result;
 }
 
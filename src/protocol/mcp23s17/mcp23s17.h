@@ -117,6 +117,10 @@ public:
     // 读取所有GPIO状态
     bool read_all_gpio(MCP23S17_GPIO_State& state);
     
+    // 中断上下文读取所有GPIO状态：主循环正占用SPI总线时返回false，由调用方稍后补读
+    // 读取GPIO寄存器同时清除MCP中断 (INT引脚释放)
+    bool read_all_gpio_from_isr(MCP23S17_GPIO_State& state);
+    
     // 上拉电阻配置
     bool set_pin_pullup(MCP23S17_Port port, uint8_t pin, bool enable);
     bool set_port_pullup(MCP23S17_Port port, uint8_t pullup_mask);
@@ -131,6 +135,10 @@ public:
     bool enable_port_interrupt(MCP23S17_Port port, uint8_t interrupt_mask, MCP23S17_IntType type, uint8_t compare_value = 0);
     bool disable_port_interrupt(MCP23S17_Port port);
     
+    // 输入变化中断：INTA/INTB镜像为同一INT引脚 (低电平有效)，指定位与上次读取值不同即触发
+    bool enable_change_interrupt(uint8_t mask_a, uint8_t mask_b);
+    bool disable_change_interrupt();
+    
     // 中断状态读取
     bool read_interrupt_flags(uint8_t& intf_a, uint8_t& intf_b);
     bool read_interrupt_capture(uint8_t& intcap_a, uint8_t& intcap_b);
@@ -162,6 +170,7 @@ private:
     // 状态缓存
     MCP23S17_GPIO_State last_state_;
     bool state_changed_;
+    volatile bool bus_busy_;  // SPI事务进行中 (同核中断据此判断能否访问总线)
     
     
     
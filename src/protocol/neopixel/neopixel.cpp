@@ -443,7 +443,7 @@ uint32_t NeoPixel::color_to_data(const NeoPixel_Color& color) const {
 
 void NeoPixel::update_fade_animation() {
     uint32_t elapsed_time = (time_us_32() - animation_start_time_) / 1000;
-    uint8_t progress = std::min(255UL, static_cast<uint32_t>((elapsed_time * 255) / current_animation_.duration_ms));
+    uint8_t progress = std::min<uint32_t>(255, (elapsed_time * 255) / current_animation_.duration_ms);
     
     for (uint16_t i = 0; i < num_leds_; i++) {
         pixels_[i] = blend_colors(animation_start_colors_[i], current_animation_.color1, progress);
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <pico/time.h>
 #include <pico/stdlib.h>
+#include "hardware/sync.h"
 #include "../../../protocol/usb_serial_logs/usb_serial_logs.h"
 #include "src/protocol/usb_serial_logs/usb_serial_logs.h"
 
@@ -10,10 +11,11 @@ AD7147::AD7147(HAL_I2C* i2c_hal, I2C_Bus i2c_bus, uint8_t device_addr)
     : TouchSensor(AD7147_MAX_CHANNELS), i2c_hal_(i2c_hal), i2c_bus_(i2c_bus),
       device_addr_(device_addr), i2c_device_address_(device_addr),
       initialized_(false), i2c_bus_enum_(i2c_bus), enabled_stage(MIN(AD7147_MAX_CHANNELS, 12)), enabled_channels_mask_(0),
-      cdc_read_request_(false), cdc_read_stage_(0), cdc_read_value_(0),
+      cdc_read_request_(false), cdc_burst_in_flight_(false), raw_capture_enabled_(false), software_detect_enabled_(false), stage_cdc_{},
       sample_result_{.touch_mask = uint32_t(0)}, status_regs_(0),
-      reconstructed_mask_(0), stage_status_(0), stage_index_(0), temp_mask_(0), channel_pos_(0),
-      pending_config_count_(0), abnormal_channels_bitmap_(0), auto_calibration_control_(0) {
+      reconstructed_mask_(0),
+      pending_config_count_(0), abnormal_channels_bitmap_(0), auto_calibration_control_(0),
+      ready_interrupt_enabled_(false) {
     module_name = "AD7147";
     module_mask_ = TouchSensor::generateModuleMask(static_cast<uint8_t>(i2c_bus), device_addr);
     supported_channel_count_ = AD7147_MAX_CHANNELS;
@@ -78,10 +80,10 @@ bool AD7147::loadConfig(const std::string& config_data) {
         return false;
     }
     
-    // 按固定顺序从配置中加载stage设置
+    // 按固定顺序从配置中加载各通道设置；连接由通道号决定，保存值只占位 (旧版本可能存过按阶段平移后的连接)
     for (int32_t stage = 0; stage < 12; stage++) {
-        stage_settings_.stages[stage].connection_6_0 = config_manager.readValue(stage_settings_.stages[stage].connection_6_0);
-        stage_settings_.stages[stage].connection_12_7 = config_manager.readValue(stage_settings_.stages[stage].connection_12_7);
+        config_manager.readValue(stage_settings_.stages[stage].connection_6_0); // 跳过
+        config_manager.readValue(stage_settings_.stages[stage].connection_12_7); // 跳过
         stage_settings_.stages[stage].afe_offset = AFEOffsetRegister(config_manager.readValue(static_cast<uint32_t>(stage_settings_.stages[stage].afe_offset.raw)));
         stage_settings_.stages[stage].sensitivity = SensitivityRegister(config_manager.readValue(static_cast<uint32_t>(stage_settings_.stages[stage].sensitivity.raw)));
         stage_settings_.stages[stage].offset_low = config_manager.readValue(stage_settings_.stages[stage].offset_low);
@@ -89,6 +91,13 @@ bool AD7147::loadConfig(const std::string& config_data) {
         stage_settings_.stages[stage].offset_high_clamp = config_manager.readValue(stage_settings_.stages[stage].offset_high_clamp);
         stage_settings_.stages[stage].offset_low_clamp = config_manager.readValue(stage_settings_.stages[stage].offset_low_clamp);
     }
+
+    // 软件检测设置追加在阶段设置之后，旧配置缺少时保持默认
+    const bool software_detect = config_manager.readValue(false);
+    const uint16_t press_threshold = config_manager.readValue(static_cast<uint16_t>(AD7147_SW_DEFAULT_PRESS));
+    const uint16_t rapid_delta = config_manager.readValue(static_cast<uint16_t>(AD7147_SW_DEFAULT_RAPID));
+    setSoftwareThresholds(press_threshold, rapid_delta);
+    setSoftwareDetection(software_detect);
     
     // 应用配置到硬件
     return apply_stage_settings();
@@ -108,6 +117,9 @@ std::string AD7147::saveConfig() const {
         config_manager.writeValue(static_cast<uint32_t>(stage_settings_.stages[stage].offset_high_clamp));
         config_manager.writeValue(static_cast<uint32_t>(stage_settings_.stages[stage].offset_low_clamp));
     }
+    config_manager.writeValue(static_cast<bool>(software_detect_enabled_));
+    config_manager.writeValue(static_cast<uint16_t>(software_detector_.press_threshold_));
+    config_manager.writeValue(static_cast<uint16_t>(software_detector_.rapid_delta_));
     
     return config_manager.toString();
 }
@@ -146,40 +158,24 @@ bool AD7147::setCustomSensitivitySettings(const std::string& settings_data) {
     return apply_stage_settings();
 }
 
+// 按通道设置配置；通道当前启用时写入它所在的阶段，关闭时只更新内存，重新启用后随通道下发
 bool AD7147::setStageConfig(uint8_t stage, const PortConfig& config) {
     if (!initialized_ || stage >= 12) {
         return false;
     }
     
-    // 更新内存中的配置
-    stage_settings_.stages[stage] = config;
-    
-    // 应用单个阶段配置到硬件
-    uint8_t config_buffer[16];
+    // 更新内存中的配置 (连接固定为该通道)
+    PortConfig& channel_config = stage_settings_.stages[stage];
+    channel_config = config;
+    channel_config.connection_6_0 = channel_connections[stage][0];
+    channel_config.connection_12_7 = channel_connections[stage][1];
+    software_detector_.reset(); // AFE偏移改变会使CDC整体平移
     
-    config_buffer[0] = (uint8_t)(config.connection_6_0 >> 8);
-    config_buffer[1] = (uint8_t)(config.connection_6_0 & 0xFF);
-    config_buffer[2] = (uint8_t)(config.connection_12_7 >> 8);
-    config_buffer[3] = (uint8_t)(config.connection_12_7 & 0xFF);
-    config_buffer[4] = (uint8_t)(config.afe_offset.raw >> 8);
-    config_buffer[5] = (uint8_t)(config.afe_offset.raw & 0xFF);
-    config_buffer[6] = (uint8_t)(config.sensitivity.raw >> 8);
-    config_buffer[7] = (uint8_t)(config.sensitivity.raw & 0xFF);
-    config_buffer[8] = (uint8_t)(config.offset_low >> 8);
-    config_buffer[9] = (uint8_t)(config.offset_low & 0xFF);
-    config_buffer[10] = (uint8_t)(config.offset_high >> 8);
-    config_buffer[11] = (uint8_t)(config.offset_high & 0xFF);
-    config_buffer[12] = (uint8_t)(config.offset_high_clamp >> 8);
-    config_buffer[13] = (uint8_t)(config.offset_high_clamp & 0xFF);
-    config_buffer[14] = (uint8_t)(config.offset_low_clamp >> 8);
-    config_buffer[15] = (uint8_t)(config.offset_low_clamp & 0xFF);
-    
-    bool ret = true;
-    for (uint8_t i = 0; i < 8; i++) {
-        ret &= write_register(AD7147_REG_STAGE0_CONNECTION + (stage * AD7147_REG_STAGE_SIZE) + i, &config_buffer[i * 2], 2);
+    const int8_t hardware_stage = getChannelStage(stage);
+    if (hardware_stage < 0) {
+        return true;
     }
-    
-    return ret;
+    return writeStageRegisters(static_cast<uint8_t>(hardware_stage), stage);
 }
 
 PortConfig AD7147::getStageConfig(uint8_t stage) const {
@@ -190,14 +186,34 @@ PortConfig AD7147::getStageConfig(uint8_t stage) const {
     return stage_settings_.stages[stage];
 }
 
+// 通道当前所在的硬件阶段 (启用通道按通道号升序依次占用阶段0..N-1)，通道未启用时返回-1
+int8_t AD7147::getChannelStage(uint8_t channel) const {
+    const uint32_t working_mask = enabled_channels_mask_ & 0x0FFF;
+    if (channel >= 12 || !(working_mask & (1UL << channel))) {
+        return -1;
+    }
+    return static_cast<int8_t>(__builtin_popcount(working_mask & ((1UL << channel) - 1)));
+}
+
 bool AD7147::readStageCDC(uint8_t stage, uint16_t& cdc_value) {
-    if (!initialized_ || stage >= 12) {
+    if (stage >= 12) {
+        return false;
+    }
+    uint16_t cdc_values[12];
+    if (!readAllStageCDC(cdc_values)) {
+        return false;
+    }
+    cdc_value = cdc_values[stage];
+    return true;
+}
+
+bool AD7147::readAllStageCDC(uint16_t* cdc_values) {
+    if (!initialized_ || !cdc_values) {
         return false;
     }
     
     // 设置CDC读取请求
-    cdc_read_stage_ = stage;
-    cdc_read_request_ = true;
+    requestAllStageCDC();
     
     // 等待读取完成（超时保护）
     uint32_t start_time = time_us_32();
@@ -205,20 +221,49 @@ bool AD7147::readStageCDC(uint8_t stage, uint16_t& cdc_value) {
         // 等待sample()处理CDC读取请求
     }
     
-    if (!cdc_read_request_) {
-        cdc_value = cdc_read_value_;
-        return true;
+    return pollAllStageCDC(cdc_values);
+}
+
+void AD7147::requestAllStageCDC() {
+    cdc_read_request_ = true;
+}
+
+bool AD7147::pollAllStageCDC(uint16_t* cdc_values) {
+    if (cdc_read_request_ || !cdc_values) {
+        return false;
     }
-    
-    return false;
+    __dmb();  // 采样回调 (Core0) 先写入结果再清除请求
+    memcpy(cdc_values, stage_cdc_, sizeof(stage_cdc_));
+    return true;
 }
 
-// 直接采样CDC
-bool AD7147::readStageCDC_direct(uint8_t stage, uint16_t& cdc_value) {
-    if (!initialized_ || stage >= 12) return false;
-    // 读取指定阶段的CDC数据，直接访问CDC寄存器
-    uint16_t cdc_reg_addr = AD7147_REG_CDC_DATA + stage;
-    return read_register(cdc_reg_addr, cdc_value);
+bool AD7147::setRawCapture(bool enable) {
+    raw_capture_enabled_ = enable;
+    return true;
+}
+
+const uint16_t* AD7147::getRawValues(uint8_t& count) const {
+    count = cdc_burst_in_flight_ ? 12 : 0;
+    return stage_cdc_;
+}
+
+// 直接连续读取全部CDC (自动递增地址，单次事务)
+bool AD7147::readAllStageCDC_direct(uint16_t* cdc_values, uint16_t* int_status) {
+    if (!initialized_ || !cdc_values) return false;
+    uint16_t regs[15];
+    const uint16_t first_reg = int_status ? AD7147_REG_STAGE_LOW_INT_STATUS : AD7147_REG_CDC_DATA;
+    const uint8_t count = int_status ? 15 : 12;
+    if (i2c_hal_->read_register(device_addr_, first_reg | 0x8000, reinterpret_cast<uint8_t*>(regs), count * 2) != count * 2) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        regs[i] = __builtin_bswap16(regs[i]);
+    }
+    if (int_status) {
+        memcpy(int_status, regs, 3 * sizeof(uint16_t));
+    }
+    memcpy(cdc_values, &regs[count - 12], 12 * sizeof(uint16_t));
+    return true;
 }
 
 // 反初始化AD7147
@@ -255,13 +300,6 @@ void AD7147::sample(async_touchsampleresult callback) {
         pending_config_count_--;
     }
 
-    // 处理CDC读取请求
-    // 由于异步会最大限度使用I2C 必须使用强行等待插入的方式接入同步读取
-    if (cdc_read_request_) {
-        readStageCDC_direct(cdc_read_stage_, cdc_read_value_);
-        cdc_read_request_ = false;
-    }
-    
     // 处理自动校准控制请求
     if (auto_calibration_control_ & 0x80000000) {
         // 提取低24位寄存器值
@@ -273,44 +311,49 @@ void AD7147::sample(async_touchsampleresult callback) {
         auto_calibration_control_ &= 0x7FFFFFFF;
     }
 
-    // 异步读取状态寄存器数据
-    i2c_hal_->read_register_async(device_addr_, AD7147_REG_STAGE_HIGH_INT_STATUS | 0x8000, _async_read_buffer.bytes, 2, [this, callback](bool success) {
+    // 校准需要的寄存器写入 (回调中总线忙，无法同步写入)
+    if (calibration_tools_.calibration_state_ != CalibrationTools::IDLE) {
+        calibration_tools_.Apply_Pending_Hardware();
+    }
+
+    // 异步读取状态寄存器数据；就绪中断模式下连同完成中断状态一起读出，以清除INT
+    // 有CDC读取请求、软件检测或校准进行中时继续连续读出0x00B-0x016的CDC结果，不再单独发起逐阶段的同步读取
+    cdc_burst_in_flight_ = cdc_read_request_ || raw_capture_enabled_ || software_detect_enabled_ || calibration_tools_.calibration_state_;
+    const uint8_t read_length = cdc_burst_in_flight_ ? AD7147_CDC_BURST_REGS * 2 : (ready_interrupt_enabled_ ? 4 : 2);
+    i2c_hal_->read_register_async(device_addr_, AD7147_REG_STAGE_HIGH_INT_STATUS | 0x8000, _async_read_buffer.bytes, read_length, [this, callback](bool success) {
         if (success) {
             // 处理状态寄存器数据
-            __asm__ volatile (
-                "rev16 %0, %0\n"
-                : "+r" (_async_read_buffer.value)
-                :: "cc"
-            );
-            
-            // 重建通道映射：将stage反馈映射回正确的通道位置
-            reconstructed_mask_ = 0;
-            stage_status_ = ~_async_read_buffer.value; // 反转状态位（触摸时为1）
-            
-            stage_index_ = 0;
-            temp_mask_ = enabled_channels_mask_;
+            _async_read_buffer.value = __builtin_bswap16(_async_read_buffer.value);  // 编译为 rev16
+            if (cdc_burst_in_flight_) {
+                for (uint8_t stage = 0; stage < 12; stage++) {
+                    stage_cdc_[stage] = __builtin_bswap16(_async_read_buffer.words[2 + stage]);
+                }
+                __dmb();  // 结果写入先于请求清除，供其它核读取
+                cdc_read_request_ = false;
+            }
             
-            // 使用位运算快速找到每个启用通道的位置并映射stage状态
-            while (temp_mask_ && stage_index_ < enabled_stage) {
-                // 找到下一个启用通道的位置（从低位开始）
-                channel_pos_ = __builtin_ctz(temp_mask_); // 计算尾随零的个数
-                
-                // 如果当前stage有触摸状态，设置对应通道位
-                if (stage_status_ & (1U << stage_index_)) {
-                    reconstructed_mask_ |= (1UL << channel_pos_);
+            // 按阶段的触摸状态：芯片高阈值状态反转 (触摸时为1)，软件检测时由固件按CDC判定
+            // 校准期间AFE反复改写，沿用芯片阈值，结束后重新建立基线
+            uint16_t stage_touch = static_cast<uint16_t>(~_async_read_buffer.value);
+            if (software_detect_enabled_ && cdc_burst_in_flight_) {
+                if (calibration_tools_.calibration_state_) {
+                    software_detector_.reset();
+                } else {
+                    stage_touch = software_detector_.process(stage_cdc_, enabled_stage);
                 }
-                
-                // 清除已处理的通道位，继续下一个
-                temp_mask_ &= temp_mask_ - 1; // 清除最低位的1
-                stage_index_++;
             }
+
+            // 重建通道映射：将stage反馈映射回正确的通道位置
+            reconstructed_mask_ = reconstructChannelMask(stage_touch, enabled_channels_mask_, enabled_stage);
             
             sample_result_.channel_mask = reconstructed_mask_;
             sample_result_.module_mask = module_mask_;
             
-            // 留给校准模块
-            if (calibration_tools_.calibration_state_)
-                calibration_tools_.CalibrationLoop(sample_result_.channel_mask);
+            // 留给校准模块 (仅在本次事务带回了CDC时推进)；校准期间只输出已完成且原本启用的通道
+            if (cdc_burst_in_flight_ && calibration_tools_.calibration_state_) {
+                calibration_tools_.CalibrationLoop(reconstructed_mask_);
+                sample_result_.channel_mask &= ~calibration_tools_.active_mask_ & calirate_save_enabled_channels_mask_;
+            }
             sample_result_.timestamp_us = time_us_32();
             callback(sample_result_);
         } else {
@@ -328,6 +371,54 @@ bool AD7147::sample_ready() {
     return ready;
 }
 
+bool AD7147::setReadyInterrupt(bool enable) {
+    if (!initialized_) {
+        return false;
+    }
+    ready_interrupt_enabled_ = enable;
+    if (!applyInterruptEnables()) {
+        ready_interrupt_enabled_ = false;
+        return false;
+    }
+    // 读取一次状态寄存器，释放使能前可能已拉低的INT
+    uint16_t status = 0;
+    read_register(AD7147_REG_STAGE_HIGH_INT_STATUS, status);
+    read_register(AD7147_REG_STAGE_COMPLETE_INT_STATUS, status);
+    return true;
+}
+
+// 写入0x005-0x007中断使能
+// 就绪中断模式：屏蔽低/高阈值中断 (状态寄存器照常锁存，sample()读取不受影响)，只保留序列最后一个阶段的完成中断，
+// 每轮转换INT拉低一次；否则恢复默认全部使能。0x005的高4位是GPIO配置 (见setLEDEnabled)，按芯片当前值保留
+bool AD7147::applyInterruptEnables() {
+    uint16_t low_int = register_config_.stage_low_int_enable;
+    read_register(AD7147_REG_STAGE_LOW_INT_EN, low_int);
+    low_int &= 0xF000;
+    if (ready_interrupt_enabled_) {
+        register_config_.stage_high_int_enable = 0;
+        register_config_.stage_complete_int_enable = static_cast<uint16_t>(1u << register_config_.pwr_control.bits.sequence_stage_num);
+    } else {
+        low_int |= 0x0FFF;
+        register_config_.stage_high_int_enable = 0x0FFF;
+        register_config_.stage_complete_int_enable = 0x0FFF;
+    }
+    register_config_.stage_low_int_enable = low_int;
+
+    uint8_t reg_data[6] = {
+        (uint8_t)(register_config_.stage_low_int_enable >> 8),
+        (uint8_t)(register_config_.stage_low_int_enable & 0xFF),
+        (uint8_t)(register_config_.stage_high_int_enable >> 8),
+        (uint8_t)(register_config_.stage_high_int_enable & 0xFF),
+        (uint8_t)(register_config_.stage_complete_int_enable >> 8),
+        (uint8_t)(register_config_.stage_complete_int_enable & 0xFF)
+    };
+    bool ok = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        ok &= write_register(AD7147_REG_STAGE_LOW_INT_EN + i, &reg_data[i * 2], 2);
+    }
+    return ok;
+}
+
 bool AD7147::setChannelEnabled(uint8_t channel, bool enabled) {
     if (!initialized_ || channel >= AD7147_MAX_CHANNELS) {
         return false;
@@ -368,11 +459,7 @@ bool AD7147::write_register(uint16_t reg, uint8_t* value, uint16_t size) {
 
 bool AD7147::read_register(uint16_t reg, uint16_t& value) {
     bool success = i2c_hal_->read_register(device_addr_, reg | 0x8000, (uint8_t*)&value, 2) == 2;
-    __asm__ volatile (
-            "rev16 %0, %0\n"
-            : "+r" (value)
-            :: "cc"
-    );
+    value = __builtin_bswap16(value);  // 编译为 rev16
     return success;
 }
 
@@ -393,30 +480,10 @@ bool AD7147::applyEnabledChannelsToHardware() {
     }
 
     bool ok = true;
-    uint8_t config_buffer[16];
     
-    // 配置启用的通道到对应的stage
+    // 配置启用的通道到对应的stage，未使用的stage连接清零 (禁用)
     for (uint8_t stage = 0; stage < 12; stage++) {
-        if (stage < enabled_count) {
-            // 使用启用通道的配置
-            uint8_t channel = enabled_channels[stage];
-            stage_settings_.stages[stage].connection_6_0 = channel_connections[channel][0];
-            stage_settings_.stages[stage].connection_12_7 = channel_connections[channel][1];
-        } else {
-            // 未使用的stage设置为0（禁用）
-            stage_settings_.stages[stage].connection_6_0 = 0x0000;
-            stage_settings_.stages[stage].connection_12_7 = 0x0000;
-        }
-        
-        // 写入stage连接配置
-        const PortConfig& stage_config = stage_settings_.stages[stage];
-        config_buffer[0] = (uint8_t)(stage_config.connection_6_0 >> 8);
-        config_buffer[1] = (uint8_t)(stage_config.connection_6_0 & 0xFF);
-        config_buffer[2] = (uint8_t)(stage_config.connection_12_7 >> 8);
-        config_buffer[3] = (uint8_t)(stage_config.connection_12_7 & 0xFF);
-        
-        uint16_t stage_base_addr = AD7147_REG_STAGE0_CONNECTION + (stage * AD7147_REG_STAGE_SIZE);
-        ok &= write_register(stage_base_addr + AD7147_STAGE_CONNECTION_OFFSET, config_buffer, 4);
+        ok &= writeStageRegisters(stage, stage < enabled_count ? enabled_channels[stage] : 0xFF);
     }
     
     // 设置校准使能：只启用实际使用的stage
@@ -431,13 +498,19 @@ bool AD7147::applyEnabledChannelsToHardware() {
     };
     ok &= write_register(AD7147_REG_STAGE_CAL_EN, cal_en_data, 2);
     
-    // 设置高中断使能
-    uint8_t high_int_data[2] = {
-        (uint8_t)(cal_enable_mask >> 8),
-        (uint8_t)(cal_enable_mask & 0xFF)
-    };
-    ok &= write_register(AD7147_REG_STAGE_HIGH_INT_EN, high_int_data, 2);
+    // 设置高中断使能 (就绪中断模式下高中断不驱动INT，在写入电源控制后统一更新)
+    if (!ready_interrupt_enabled_) {
+        uint8_t high_int_data[2] = {
+            (uint8_t)(cal_enable_mask >> 8),
+            (uint8_t)(cal_enable_mask & 0xFF)
+        };
+        ok &= write_register(AD7147_REG_STAGE_HIGH_INT_EN, high_int_data, 2);
+    }
     
+    // 采样结果按实际下发的阶段数重建通道 (校准直接改写enabled_channels_mask_，不经过setChannelEnabled)
+    enabled_stage = enabled_count;
+    software_detector_.reset(); // 阶段对应的通道已改变
+
     // 设置sequence_stage_num为启用通道数量减1
     if (enabled_count > 0) {
         register_config_.pwr_control.bits.sequence_stage_num = enabled_count - 1;
@@ -452,47 +525,59 @@ bool AD7147::applyEnabledChannelsToHardware() {
     };
     ok &= write_register(AD7147_REG_PWR_CONTROL, pwr_ctrl_data, 2);
     
+    // 序列长度改变后，完成中断跟随新的最后一个阶段
+    if (ready_interrupt_enabled_) {
+        ok &= applyInterruptEnables();
+    }
+    
     return ok;
 }
 
-// 应用stage设置到硬件的内联函数
+// 写入一个硬件阶段的8个配置寄存器：连接与其余配置都取自所测通道；channel为0xFF时连接清零 (阶段禁用)
+bool AD7147::writeStageRegisters(uint8_t stage, uint8_t channel) {
+    const bool used = channel < 12;
+    const PortConfig& config = stage_settings_.stages[used ? channel : stage];
+    const uint16_t connection_6_0 = used ? config.connection_6_0 : 0x0000;
+    const uint16_t connection_12_7 = used ? config.connection_12_7 : 0x0000;
+    uint8_t config_buffer[16];
+    
+    config_buffer[0] = (uint8_t)(connection_6_0 >> 8);
+    config_buffer[1] = (uint8_t)(connection_6_0 & 0xFF);
+    config_buffer[2] = (uint8_t)(connection_12_7 >> 8);
+    config_buffer[3] = (uint8_t)(connection_12_7 & 0xFF);
+    config_buffer[4] = (uint8_t)(config.afe_offset.raw >> 8);
+    config_buffer[5] = (uint8_t)(config.afe_offset.raw & 0xFF);
+    config_buffer[6] = (uint8_t)(config.sensitivity.raw >> 8);
+    config_buffer[7] = (uint8_t)(config.sensitivity.raw & 0xFF);
+    config_buffer[8] = (uint8_t)(config.offset_low >> 8);
+    config_buffer[9] = (uint8_t)(config.offset_low & 0xFF);
+    config_buffer[10] = (uint8_t)(config.offset_high >> 8);
+    config_buffer[11] = (uint8_t)(config.offset_high & 0xFF);
+    config_buffer[12] = (uint8_t)(config.offset_high_clamp >> 8);
+    config_buffer[13] = (uint8_t)(config.offset_high_clamp & 0xFF);
+    config_buffer[14] = (uint8_t)(config.offset_low_clamp >> 8);
+    config_buffer[15] = (uint8_t)(config.offset_low_clamp & 0xFF);
+    
+    const uint16_t stage_base_addr = AD7147_REG_STAGE0_CONNECTION + (stage * AD7147_REG_STAGE_SIZE);
+    return write_register(stage_base_addr + AD7147_STAGE_CONNECTION_OFFSET, config_buffer, sizeof(config_buffer));
+}
+
+// 应用stage设置到硬件的内联函数 (按当前启用通道映射到阶段)
 inline bool AD7147::apply_stage_settings() {
     bool ret = true;
-    uint8_t config_buffer[16];
     
     USB_LOG_DEBUG("AD7147 apply_stage_settings");
-    // 配置每个阶段（Stage 0-11）
-    for (uint8_t stage = 0; stage < 12; stage++) {
-        const PortConfig& stage_config = stage_settings_.stages[stage];
-        
-        config_buffer[0] = (uint8_t)(stage_config.connection_6_0 >> 8);
-        config_buffer[1] = (uint8_t)(stage_config.connection_6_0 & 0xFF);
-
-        config_buffer[2] = (uint8_t)(stage_config.connection_12_7 >> 8);
-        config_buffer[3] = (uint8_t)(stage_config.connection_12_7 & 0xFF);
-
-        config_buffer[4] = (uint8_t)(stage_config.afe_offset.raw >> 8);
-        config_buffer[5] = (uint8_t)(stage_config.afe_offset.raw & 0xFF);
-
-        config_buffer[6] = (uint8_t)(stage_config.sensitivity.raw >> 8);
-        config_buffer[7] = (uint8_t)(stage_config.sensitivity.raw & 0xFF);
-
-        config_buffer[8] = (uint8_t)(stage_config.offset_low >> 8);
-        config_buffer[9] = (uint8_t)(stage_config.offset_low & 0xFF);
-
-        config_buffer[10] = (uint8_t)(stage_config.offset_high >> 8);
-        config_buffer[11] = (uint8_t)(stage_config.offset_high & 0xFF);
-        
-        config_buffer[12] = (uint8_t)(stage_config.offset_high_clamp >> 8);
-        config_buffer[13] = (uint8_t)(stage_config.offset_high_clamp & 0xFF);
-
-        config_buffer[14] = (uint8_t)(stage_config.offset_low_clamp >> 8);
-        config_buffer[15] = (uint8_t)(stage_config.offset_low_clamp & 0xFF);
-        
-        for (uint8_t i = 0; i < 8; i++) {
-            ret &= write_register(AD7147_REG_STAGE0_CONNECTION + (stage * AD7147_REG_STAGE_SIZE) + i, &config_buffer[i * 2], 2);
+    // 启用通道依次占用阶段0..N-1，其余阶段禁用
+    uint8_t stage = 0;
+    for (uint8_t channel = 0; channel < 12; channel++) {
+        if (getChannelStage(channel) >= 0) {
+            ret &= writeStageRegisters(stage++, channel);
         }
     }
+    for (; stage < 12; stage++) {
+        ret &= writeStageRegisters(stage, 0xFF);
+    }
+    software_detector_.reset();
     return ret;
 }
 
@@ -33,7 +33,8 @@
 #define AD7147_REG_STAGE_COMPLETE_INT_STATUS 0x000A // 阶段完成中断状态寄存器
 
 // CDC数据
-#define AD7147_REG_CDC_DATA 0x000B // CDC数据寄存器
+#define AD7147_REG_CDC_DATA 0x000B // CDC数据寄存器 (0x00B-0x016 对应Stage 0-11，紧跟在中断状态寄存器之后)
+#define AD7147_CDC_BURST_REGS 14   // 0x009-0x016 连续读取：高中断状态 + 完成中断状态 + 12个CDC结果
 
 // 阈值寄存器
 #define STAGE1_HIGH_THRESHOLD 0x11E
@@ -90,6 +91,11 @@
 #define CALIBRATION_STAGE1_SCAN_RANGEB -127
 #define CALIBRATION_SCAN_SAMPLE_COUNT 300 // 自动校准单轮采样次数
 #define CALIBRATION_MEASURE_SAMPLE_COUNT 500
+#define CALIBRATION_SCAN_MIN_SAMPLE_COUNT 32      // 单轮最少采样次数，此后CDC均值离目标超过波动范围即提前结束本轮
+#define CALIBRATION_MEASURE_MIN_SAMPLE_COUNT 100  // 低噪声通道 (最大波动差不超过FLUCTUATION_MIN_THRESHOLD) 的无触发验证次数
+#define CALIBRATION_CONVERGE_TOLERANCE 16         // 提前结束判定的最小余量 (CDC码)
+#define CALIBRATION_AFE_SETTLE_SAMPLES 2          // AFE写入后丢弃的采样数 (写入时正在进行的序列及其后一次读取可能仍是旧偏移)
+#define CALIBRATION_AFE_WRITES_PER_SAMPLE 4       // 每次sample()最多写入的AFE寄存器数，限制单次阻塞时间
 #define CALIBRATION_AEF_SAVE_AREA -1 // AEF完成时额外偏置保留区域 预留缓冲空间防止意外触发
 
 // 指数算法参数宏定义
@@ -107,6 +113,18 @@
 
 #define AD7147_CALIBRATION_TARGET_VALUE (AD7147_DEFAULT_OFFSET_LOW_CLAMP + (STAGE_REDUCE_NUM / 2))
 
+// 软件触摸检测 (固件按各阶段CDC判定触摸，替代芯片阈值中断)
+// 定点数：滤波值与基线保留8位小数 (慢速基线的单步增量不会被截断为0)；触摸时CDC下降，差值 = 基线 - 滤波值
+#define AD7147_SW_FRAC_BITS 8
+#define AD7147_SW_FILTER_SHIFT 1          // IIR滤波 y += (x - y) >> 1，每帧跟上一半，按下/松开最多延后一帧
+#define AD7147_SW_BASELINE_SHIFT 7        // 未触摸时基线跟随环境漂移，约128帧时间常数
+#define AD7147_SW_BASELINE_FAST_SHIFT 2   // CDC高于基线时基线快速回升 (松手后残留/上电时手在面板上)
+#define AD7147_SW_SEED_SAMPLES 4          // 复位后以当前CDC直接作为基线的帧数 (配置改写前已开始的转换可能仍是旧值)
+#define AD7147_SW_MAX_TOUCH_FRAMES 1024   // 单阶段连续按下的帧数上限 (约9.4s @ 9.2ms序列)，超过时以当前CDC重建基线，防止基线冻结后触摸卡死
+#define AD7147_SW_DEFAULT_PRESS 0x180     // 默认按下阈值 (CDC码)，芯片阈值约在空闲值下方0x200
+#define AD7147_SW_DEFAULT_RAPID 0x200     // 默认快速触发行程：按下后差值自峰值回落该值即松开，松开后自谷值回升该值即再按下
+#define AD7147_SW_MIN_THRESHOLD 0x20      // 阈值/行程下限，需高于CDC噪声
+
 // 设备信息结构体
 struct AD7147_DeviceInfo
 {
@@ -334,8 +352,9 @@ union AmbCompCtrl2Register
 
 union AD7147AsyncReadBuffer
 {
-    uint8_t bytes[2];
-    uint16_t value = 0;
+    uint16_t value = 0;                    // 高中断状态
+    uint16_t words[AD7147_CDC_BURST_REGS]; // 自0x009起连续读取的寄存器 (大端)，长度按需为1/2/14个
+    uint8_t bytes[AD7147_CDC_BURST_REGS * 2];
 }; // 异步读取数据缓冲区
 
 // 寄存器配置结构体
@@ -371,6 +390,25 @@ public:
     bool setChannelSensitivity(uint8_t channel, int8_t sensitivity) override; // 设置通道灵敏度 (0-99)
     void sample(async_touchsampleresult callback) override;                       // 异步采样接口
     bool sample_ready() override;
+    bool setReadyInterrupt(bool enable) override;                                 // INT引脚仅由最后一个阶段的转换完成驱动
+    bool setRawCapture(bool enable) override;                                     // 每次采样连同12个阶段CDC一起读取
+    const uint16_t* getRawValues(uint8_t& count) const override;                  // 本次采样带回的阶段CDC
+
+    // 将stage状态按启用通道顺序映射回通道位置 (第n个stage对应第n个启用通道)
+    static inline uint32_t reconstructChannelMask(uint16_t stage_status, uint32_t enabled_channels_mask, uint8_t enabled_stages) {
+        uint32_t mask = 0;
+        uint8_t stage_index = 0;
+        // 使用位运算快速找到每个启用通道的位置并映射stage状态
+        while (enabled_channels_mask && stage_index < enabled_stages) {
+            // 如果当前stage有触摸状态，设置对应通道位 (ctz为下一个启用通道的位置)
+            if (stage_status & (1U << stage_index)) {
+                mask |= (1UL << __builtin_ctz(enabled_channels_mask));
+            }
+            enabled_channels_mask &= enabled_channels_mask - 1; // 清除最低位的1
+            stage_index++;
+        }
+        return mask;
+    }
 
     bool setChannelEnabled(uint8_t channel, bool enabled) override;            // 设置单个通道使能
     bool getChannelEnabled(uint8_t channel) const override;                    // 获取单个通道使能状态
@@ -380,10 +418,17 @@ public:
     bool loadConfig(const std::string &config_data) override;            // 从字符串加载配置
     std::string saveConfig() const override;                             // 保存配置到字符串
     bool setCustomSensitivitySettings(const std::string &settings_data); // 设置自定义灵敏度配置
-    bool setStageConfig(uint8_t stage, const PortConfig &config);        // 设置指定阶段配置 只能在同核心调用 否则秒崩
-    bool setStageConfigAsync(uint8_t stage, const PortConfig &config);   // 异步设置指定阶段配置
-    PortConfig getStageConfig(uint8_t stage) const;                      // 获取指定阶段配置副本
+    // 阶段配置按通道号索引 (与触摸掩码位一致)，下发时随通道写入它当前所在的硬件阶段
+    bool setStageConfig(uint8_t stage, const PortConfig &config);        // 设置指定通道配置 只能在同核心调用 否则秒崩
+    bool setStageConfigAsync(uint8_t stage, const PortConfig &config);   // 异步设置指定通道配置
+    PortConfig getStageConfig(uint8_t stage) const;                      // 获取指定通道配置副本
+    int8_t getChannelStage(uint8_t channel) const;                       // 通道当前所在的硬件阶段，未启用返回-1
     bool readStageCDC(uint8_t stage, uint16_t &cdc_value);               // 读取指定阶段CDC值
+    // 一次读取全部12个阶段的CDC：采样运行时搭载在下一次sample()的状态读取中 (同一事务连续读出)，不额外占用总线
+    bool readAllStageCDC(uint16_t *cdc_values);                          // 同步：等待下一次采样带回 (超时10ms)
+    void requestAllStageCDC();                                           // 异步：请求下一次采样带回CDC
+    bool pollAllStageCDC(uint16_t *cdc_values);                          // 异步：请求完成时取出结果并返回true
+    bool readAllStageCDC_direct(uint16_t *cdc_values, uint16_t *int_status = nullptr); // 直接单次事务读取 (采样未运行时使用)，int_status可选读出0x008-0x00A
 
     // 校准相关接口实现
     bool calibrateSensor() override;                                                        // 校准传感器(接入startAutoOffsetCalibration)
@@ -404,6 +449,14 @@ public:
     bool isAutoOffsetCalibrationActive() const;
     uint8_t getAutoOffsetCalibrationTotalProgress() const; // 新增：全局总进度
 
+    // 软件触摸检测：启用后每次采样连同CDC读回，由固件按阶段跟踪基线并判定触摸 (校准期间仍使用芯片阈值)
+    void setSoftwareDetection(bool enable);
+    bool getSoftwareDetection() const { return software_detect_enabled_; }
+    void setSoftwareThresholds(uint16_t press_threshold, uint16_t rapid_delta); // 低于AD7147_SW_MIN_THRESHOLD时取下限
+    uint16_t getSoftwarePressThreshold() const { return software_detector_.press_threshold_; }
+    uint16_t getSoftwareRapidDelta() const { return software_detector_.rapid_delta_; }
+    int16_t getSoftwareDelta(uint8_t stage) const;                               // 当前差值 (基线 - 滤波值)，供设置页显示
+
     // 设备信息读取
     bool read_device_info(AD7147_DeviceInfo &info);
 
@@ -422,24 +475,22 @@ private:
     uint32_t calirate_save_enabled_channels_mask_; // 校准时保存的启用的通道掩码
 
     // 配置相关成员变量
-    StageSettings stage_settings_;         // Stage配置设置
+    StageSettings stage_settings_;         // 各通道的阶段配置 (按通道号索引，连接固定为该通道)
     AD7147RegisterConfig register_config_; // 寄存器配置
 
     // 实例级状态变量（原来的静态变量）
-    volatile bool cdc_read_request_;  // CDC读取请求标志
-    volatile uint8_t cdc_read_stage_; // 请求读取的阶段
-    uint16_t cdc_read_value_;         // 读取到的CDC值
+    volatile bool cdc_read_request_;  // CDC读取请求标志，搭载读取完成后由采样回调清除
+    bool cdc_burst_in_flight_;        // 当前采样事务是否连同CDC一起读取
+    volatile bool raw_capture_enabled_; // 原始数据流：每次采样都带回CDC
+    volatile bool software_detect_enabled_; // 软件触摸检测：每次采样都带回CDC并由固件判定触摸
+    uint16_t stage_cdc_[12];          // 最近一次连续读取的各阶段CDC值
 
     // sample()函数的实例级变量（原来的静态变量）
     TouchSampleResult sample_result_; // 采样结果
     uint16_t status_regs_;            // 状态寄存器值
 
-    // sample()函数中的映射重建临时变量（优化热点函数性能）
+    // sample()函数中的映射重建结果
     uint32_t reconstructed_mask_; // 重建的通道掩码
-    uint16_t stage_status_;       // 反转后的stage状态
-    uint8_t stage_index_;         // stage索引计数器
-    uint32_t temp_mask_;          // 临时掩码用于位运算
-    uint8_t channel_pos_;         // 通道位置
 
     // 异步配置相关
     struct PendingPortConfig
@@ -456,6 +507,9 @@ private:
     // 自动校准控制
     volatile int32_t auto_calibration_control_; // 自动校准控制变量 (最高位=执行标志, 低24位=寄存器值)
 
+    // 就绪中断模式
+    bool ready_interrupt_enabled_;
+
     // 异步I2C操作缓冲区
     AD7147AsyncReadBuffer _async_read_buffer;
 
@@ -464,9 +518,11 @@ private:
 
     // 私有方法
     bool applyEnabledChannelsToHardware();
+    bool applyInterruptEnables();
     bool configureStages(const uint16_t *connection_values);
     inline bool apply_stage_settings(); // 应用stage设置到硬件
-    // 内部快速读取当前stage配置（不做边界检查）
+    bool writeStageRegisters(uint8_t stage, uint8_t channel); // 把通道配置写入硬件阶段，channel为0xFF时禁用该阶段
+    // 内部快速读取通道配置（不做边界检查）
     inline PortConfig getStageConfigInternal(uint8_t stage) const { return stage_settings_.stages[stage]; }
 
     // 校准相关辅助方法
@@ -475,8 +531,6 @@ private:
     // I2C通信方法
     bool write_register(uint16_t reg, uint8_t *value, uint16_t size = 2);
     bool read_register(uint16_t reg, uint16_t &value);
-    // 直接读取指定stage的CDC寄存器（内部使用）
-    bool readStageCDC_direct(uint8_t stage, uint16_t &cdc_value);
 
     class CalibrationTools
     {
@@ -486,6 +540,7 @@ private:
         {
             IDLE, // 初始化/完成时设置回IDLE
             PROCESS,
+            FINISH, // 全部通道完成，等待sample()写回AFE并恢复通道配置
         };
 
         enum Direction
@@ -557,6 +612,12 @@ private:
         CalibrationState calibration_state_ = IDLE;
         CalibrationData calibration_data_; // 校准数据结构体
 
+        // CalibrationLoop在I2C完成回调中运行，此时总线仍处于忙状态，不能发起同步读写；
+        // 需要写入硬件的改动先记在这里，由下一次sample()在发起读取前写入
+        uint16_t pending_afe_mask_ = 0;                 // 待写入AFE偏移的阶段
+        uint16_t active_mask_ = 0;                      // 仍在校准的通道 (触摸输出被屏蔽)
+        uint8_t settle_[AD7147_MAX_CHANNELS] = {};      // AFE写入后待丢弃的采样数
+
         bool start_calibration()
         {
             if (calibration_state_ != IDLE)
@@ -567,13 +628,15 @@ private:
 
         // 主循环方法
         void CalibrationLoop(uint32_t sample);
+        // 在sample()中调用：准备/恢复通道配置并写入待更新的AFE偏移
+        void Apply_Pending_Hardware();
 
         // 工具方法
         // 清空设置到校准所需值
         void Clear_and_prepare_stage_settings();
         // 完成时恢复校准
         void Complete_and_restore_calibration();
-        // 直接设置AEF偏移 已内置正负翻转 0-127
+        // 设置AEF偏移 已内置正负翻转 0-127 (只更新配置并标记待写入)
         void Set_AEF_Offset(uint8_t stage, int16_t offset);
 
         // [执行一次采样一次 到目标周期返回True] 读取CDC值 计算平均值 最大值和最小值
@@ -581,9 +644,39 @@ private:
         // [执行一次采样一次 直接解析sample中的采样数据 sample应当通过外部直接传入循环中的采样结果原始值 到目标周期/验证时为触发 返回True] 读取触发值 计算触发和未触发次数
         bool Read_Triggle_Sample(uint8_t stage, uint32_t sample, TriggleSample &result, bool measure);
 
-        // 内联：根据噪声与面积补偿计算当前阶段的目标CDC
+        // 内联：根据噪声与面积补偿计算当前阶段的目标CDC (结束一轮采样时调用，累计本轮统计)
         inline uint16_t Compute_CDC_Adjusted_Target(uint8_t stage, uint16_t base_target);
+        // 由最大波动差与平均波动差计算目标CDC (不修改统计)
+        static uint16_t Adjusted_Target(const ChannelCalibrationData &ch, uint16_t max_fluctuation, uint16_t area_diff_avg, uint16_t base_target);
+        // 本轮采样是否已可提前结束：均值离 (按当前窗口预估的) 目标超过波动范围，继续采样也不会改变判定
+        inline bool Window_Converged(uint8_t stage, uint16_t base_target) const;
     };
 
     CalibrationTools calibration_tools_;
+
+    // 软件触摸检测：在I2C完成回调中按阶段运行，只用整数加减与移位，12个阶段合计不到千条指令，远小于一帧转换时间
+    class SoftwareDetector
+    {
+    public:
+        struct StageState
+        {
+            int32_t baseline = 0;  // 基线 (定点)
+            int32_t filtered = 0;  // 滤波后CDC (定点)
+            int32_t extreme = 0;   // 按下时为差值峰值，松开时为差值谷值 (CDC码)
+            uint16_t touch_frames = 0; // 本次按下已持续的帧数
+            bool touched = false;
+        };
+
+        StageState stages_[AD7147_MAX_CHANNELS];
+        volatile uint16_t press_threshold_ = AD7147_SW_DEFAULT_PRESS;
+        volatile uint16_t rapid_delta_ = AD7147_SW_DEFAULT_RAPID;
+        volatile bool reset_request_ = true; // 任意核心置位，回调中重新以当前CDC为基线
+        uint8_t seed_remaining_ = 0;
+
+        // 处理一帧CDC，返回按阶段的触摸位图 (位n对应阶段n)
+        uint16_t process(const uint16_t *cdc, uint8_t stage_count);
+        inline void reset() { reset_request_ = true; }
+    };
+
+    SoftwareDetector software_detector_;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "ad7147.h"
 #include <algorithm>
+#include <cstring>
 #include "src/protocol/usb_serial_logs/usb_serial_logs.h"
 
 // 清空设置到校准所需值 - 仅准备被setChannelCalibrationTarget设置过的通道
@@ -10,11 +11,15 @@ void AD7147::CalibrationTools::Clear_and_prepare_stage_settings()
     pthis->calirate_save_enabled_channels_mask_ = pthis->enabled_channels_mask_; // 校准时保存的启用的通道掩码
     pthis->enabled_channels_mask_ = ((1 << AD7147_MAX_CHANNELS) - 1);
     pthis->applyEnabledChannelsToHardware();
+    pending_afe_mask_ = 0;
+    active_mask_ = 0;
+    memset(settle_, 0, sizeof(settle_));
     
     // 准备所有通道的配置和初始化状态
     for (uint8_t ch = 0; ch < AD7147_MAX_CHANNELS; ch++) {
         // 初始化通道校准状态
         if (!calibration_data_.channels[ch].s1_inited_) continue;
+        active_mask_ |= 1u << ch;
         calibration_data_.channels[ch].s1_aef_ = CALIBRATION_STAGE1_SCAN_RANGEA;
         calibration_data_.channels[ch].s1_best_aef_ = 0;
         calibration_data_.channels[ch].cdc_samples_.clear();
@@ -37,34 +42,62 @@ void AD7147::CalibrationTools::Clear_and_prepare_stage_settings()
 void AD7147::CalibrationTools::Complete_and_restore_calibration()
 {
     calibration_data_.inited_ = false;
-    calibration_state_ = IDLE;
     pthis->enabled_channels_mask_ = pthis->calirate_save_enabled_channels_mask_; // 校准时保存的启用的通道掩码
     pthis->applyEnabledChannelsToHardware();
+    active_mask_ = 0;
     
     // 重置全局初始化标志，以便下次校准时重新初始化
     calibration_data_.global_initialized_ = false;
+    calibration_data_.stage_process = 255;
+    calibration_state_ = IDLE;
+}
+
+void AD7147::CalibrationTools::Apply_Pending_Hardware()
+{
+    // 首次进入复位硬件配置到校准所需
+    if (calibration_state_ == PROCESS && !calibration_data_.inited_)
+    {
+        calibration_data_.inited_ = true;
+        // 一次性准备所有通道的校准设置和初始化状态
+        Clear_and_prepare_stage_settings();
+    }
+
+    // 只写各阶段的AFE偏移寄存器，超出预算的留到下一次sample() (校准期间全部通道启用，通道号即阶段号)
+    for (uint8_t writes = 0; pending_afe_mask_ && writes < CALIBRATION_AFE_WRITES_PER_SAMPLE; writes++)
+    {
+        const uint8_t stage = __builtin_ctz(pending_afe_mask_);
+        const uint16_t raw = pthis->stage_settings_.stages[stage].afe_offset.raw;
+        uint8_t data[2] = {(uint8_t)(raw >> 8), (uint8_t)(raw & 0xFF)};
+        if (!pthis->write_register(AD7147_REG_STAGE0_CONNECTION + stage * AD7147_REG_STAGE_SIZE + AD7147_STAGE_AFE_OFFSET_OFFSET, data, 2))
+            break;
+        pending_afe_mask_ &= pending_afe_mask_ - 1;
+        settle_[stage] = CALIBRATION_AFE_SETTLE_SAMPLES;
+    }
+
+    if (calibration_state_ == FINISH && !pending_afe_mask_)
+        Complete_and_restore_calibration();
 }
 
 // 设置AFE偏移 -127 ~ 127
 void AD7147::CalibrationTools::Set_AEF_Offset(uint8_t stage, int16_t offset)
 {
-    PortConfig config = pthis->stage_settings_.stages[stage];
+    AFEOffsetRegister &afe_offset = pthis->stage_settings_.stages[stage].afe_offset;
     
     // 自动判定方向并配置偏移
     bool is_positive = offset >= 0;
     uint16_t abs_offset = abs(MAX(-127, MIN(127, offset)));
     
-    config.afe_offset.bits.pos_afe_offset_swap = !is_positive;
-    config.afe_offset.bits.neg_afe_offset_swap = is_positive;
-    config.afe_offset.bits.pos_afe_offset = abs_offset > 63 ? 63 : abs_offset;
-    config.afe_offset.bits.neg_afe_offset = MAX(abs_offset - 63, 0);
-    pthis->setStageConfig(stage, config);
+    afe_offset.bits.pos_afe_offset_swap = !is_positive;
+    afe_offset.bits.neg_afe_offset_swap = is_positive;
+    afe_offset.bits.pos_afe_offset = abs_offset > 63 ? 63 : abs_offset;
+    afe_offset.bits.neg_afe_offset = MAX(abs_offset - 63, 0);
+    pending_afe_mask_ |= 1u << stage;
 }
 
 bool AD7147::CalibrationTools::Read_CDC_Sample(uint8_t stage, CDCSample_result &result, bool measure)
 {
-    static uint16_t value;
-    pthis->readStageCDC_direct(stage, value);
+    // 校准期间每次采样都连同CDC一起读取 (见sample())，这里直接取本次结果
+    const uint16_t value = pthis->stage_cdc_[stage];
     if (result.sample_count)
     {
         result.average = (uint16_t)((result.average * result.sample_count + value) / (result.sample_count + 1));
@@ -85,7 +118,11 @@ bool AD7147::CalibrationTools::Read_Triggle_Sample(uint8_t stage, uint32_t sampl
     }
     else
         result.not_triggle_num++;
-    return (result.sample_count++ >= (measure ? CALIBRATION_MEASURE_SAMPLE_COUNT : CALIBRATION_SCAN_SAMPLE_COUNT));
+    // 低噪声通道缩短无触发验证
+    uint32_t count = CALIBRATION_SCAN_SAMPLE_COUNT;
+    if (measure)
+        count = calibration_data_.channels[stage].max_fluctuation_ <= FLUCTUATION_MIN_THRESHOLD ? CALIBRATION_MEASURE_MIN_SAMPLE_COUNT : CALIBRATION_MEASURE_SAMPLE_COUNT;
+    return (result.sample_count++ >= count);
 }
 
 inline uint16_t AD7147::CalibrationTools::Compute_CDC_Adjusted_Target(uint8_t stage, uint16_t base_target)
@@ -112,11 +149,16 @@ inline uint16_t AD7147::CalibrationTools::Compute_CDC_Adjusted_Target(uint8_t st
         ch.cdc_avg_count_++;
     ch.cdc_avg_overall_ = (uint16_t)(ch.cdc_avg_accum_ / (uint32_t)(ch.cdc_avg_count_ ? ch.cdc_avg_count_ : 1));
 
+    return Adjusted_Target(ch, ch.max_fluctuation_, ch.area_diff_avg_, base_target);
+}
+
+uint16_t AD7147::CalibrationTools::Adjusted_Target(const ChannelCalibrationData &ch, uint16_t max_fluctuation, uint16_t area_diff_avg, uint16_t base_target)
+{
     // 基于最大波动差的指数型噪声自适应因子（与原逻辑一致）
     uint16_t fluctuation_factor = 0;
     uint32_t x_normalized = 0;
-    if (ch.max_fluctuation_ > FLUCTUATION_MIN_THRESHOLD)
-        x_normalized = (uint32_t)(ch.max_fluctuation_ - FLUCTUATION_MIN_THRESHOLD); // 减去最小阈值
+    if (max_fluctuation > FLUCTUATION_MIN_THRESHOLD)
+        x_normalized = (uint32_t)(max_fluctuation - FLUCTUATION_MIN_THRESHOLD); // 减去最小阈值
 
     // t = k * x_normalized / RANGE, k=2
     uint32_t t = (2u * x_normalized) / (uint32_t)TAYLOR_NORMALIZATION_RANGE;
@@ -140,13 +182,13 @@ inline uint16_t AD7147::CalibrationTools::Compute_CDC_Adjusted_Target(uint8_t st
         exp_neg_t = 0; // 大t时 e^-t -> 0
     }
 
-    uint32_t min_factor = (uint32_t)ch.max_fluctuation_ / (uint32_t)FLUCTUATION_MIN_FACTOR; // 低噪声下的最小调整
-    uint32_t max_factor = (uint32_t)ch.max_fluctuation_ * (uint32_t)FLUCTUATION_MAX_FACTOR; // 高噪声下的最大调整
+    uint32_t min_factor = (uint32_t)max_fluctuation / (uint32_t)FLUCTUATION_MIN_FACTOR; // 低噪声下的最小调整
+    uint32_t max_factor = (uint32_t)max_fluctuation * (uint32_t)FLUCTUATION_MAX_FACTOR; // 高噪声下的最大调整
     uint32_t growth_factor = (uint32_t)TAYLOR_SCALE_FACTOR - exp_neg_t;                       // 1 - e^-t
     fluctuation_factor = (uint16_t)(min_factor + ((max_factor - min_factor) * growth_factor) / (uint32_t)TAYLOR_SCALE_FACTOR);
 
     // 面积补偿：平均波动差与面积正相关，线性叠加到目标CDC
-    uint16_t area_comp = ch.area_diff_avg_ / (uint16_t)AREA_COMPENSATION_DIVISOR;
+    uint16_t area_comp = area_diff_avg / (uint16_t)AREA_COMPENSATION_DIVISOR;
     if (area_comp > (uint16_t)AREA_COMPENSATION_MAX) area_comp = (uint16_t)AREA_COMPENSATION_MAX;
 
     // 灵敏度修正
@@ -156,19 +198,31 @@ inline uint16_t AD7147::CalibrationTools::Compute_CDC_Adjusted_Target(uint8_t st
     return adjusted_target > sensitivity_adjust ? (adjusted_target - sensitivity_adjust) : 0;
 }
 
+inline bool AD7147::CalibrationTools::Window_Converged(uint8_t stage, uint16_t base_target) const
+{
+    const ChannelCalibrationData &ch = calibration_data_.channels[stage];
+    const CDCSample_result &samples = ch.cdc_samples_;
+    if (samples.sample_count < CALIBRATION_SCAN_MIN_SAMPLE_COUNT)
+        return false;
+    // 按本轮若在此结束时Compute_CDC_Adjusted_Target会得到的统计预估目标
+    const uint16_t spread = samples.max >= samples.min ? samples.max - samples.min : samples.min - samples.max;
+    const uint16_t max_fluctuation = MAX(ch.max_fluctuation_, spread);
+    const uint16_t area_diff_avg = (uint16_t)((ch.area_diff_accum_ + spread) / ((uint32_t)ch.area_diff_count_ + 1));
+    const uint32_t target = Adjusted_Target(ch, max_fluctuation, area_diff_avg, base_target);
+    const uint32_t margin = MAX(spread, (uint16_t)CALIBRATION_CONVERGE_TOLERANCE);
+    return samples.average + margin < target || samples.average > target + margin;
+}
+
 void AD7147::CalibrationTools::CalibrationLoop(uint32_t sample)
 {
-    // 首次进入复位硬件配置到校准所需
+    // 硬件准备由sample()在发起读取前完成
     if (!calibration_data_.inited_)
-    {
-        calibration_data_.inited_ = true;
-        // 一次性准备所有通道的校准设置和初始化状态
-        Clear_and_prepare_stage_settings();
-    }
+        return;
 
     switch (calibration_state_)
     {
     case IDLE:
+    case FINISH:
     {
         return;
     }
@@ -188,9 +242,17 @@ void AD7147::CalibrationTools::CalibrationLoop(uint32_t sample)
                 continue;
             }
             all_channels_completed = false;
+
+            // 新AFE偏移尚未写入或刚写入，本次CDC仍可能来自旧偏移
+            if (pending_afe_mask_ & (1u << stage)) continue;
+            if (settle_[stage]) {
+                settle_[stage]--;
+                continue;
+            }
             
-            // 进行CDC采样
-            if (!Read_CDC_Sample(stage, calibration_data_.channels[stage].cdc_samples_, false)) continue; // 继续采样当前AEF点
+            // 进行CDC采样，均值已明确落在目标一侧时不必采满一轮
+            if (!Read_CDC_Sample(stage, calibration_data_.channels[stage].cdc_samples_, false) &&
+                !Window_Converged(stage, target_value)) continue; // 继续采样当前AEF点
 
             // CDC附加处理：指数噪声自适应 + 面积补偿 + 灵敏度修正，得到调整后的目标值
             uint16_t adjusted_target = Compute_CDC_Adjusted_Target(stage, target_value);
@@ -203,6 +265,7 @@ void AD7147::CalibrationTools::CalibrationLoop(uint32_t sample)
                     // 不再触发，该通道完成校准
                     Set_AEF_Offset(stage, calibration_data_.channels[stage].s1_best_aef_ + CALIBRATION_AEF_SAVE_AREA);
                     calibration_data_.channels[stage].s1_inited_ = false;
+                    active_mask_ &= ~(1u << stage);
                     continue;
                 }
                 calibration_data_.channels[stage].trigger_samples_.clear();
@@ -233,14 +296,16 @@ void AD7147::CalibrationTools::CalibrationLoop(uint32_t sample)
             // 扫描结束，调整到头也低于目标值，该通道视为异常
             pthis->abnormal_channels_bitmap_ |= (1 << stage);
             calibration_data_.channels[stage].s1_inited_ = false; // 标记为已完成（异常）
+            active_mask_ &= ~(1u << stage);
         }
 
         // 计算总进度为所有通道的平均进度 (范围0-255)
         if (!all_channels_completed) {
             calibration_data_.stage_process = MIN((total_progress / AD7147_MAX_CHANNELS), 255);
         } else {
-            calibration_data_.stage_process = 255; // 所有目标通道都已完成
-            Complete_and_restore_calibration();
+            // 所有目标通道都已完成，最后的AFE写入与通道配置恢复由sample()完成后进度才置为255
+            calibration_data_.stage_process = 254;
+            calibration_state_ = FINISH;
         }
 
         return;
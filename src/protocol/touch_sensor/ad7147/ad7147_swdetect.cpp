@@ -0,0 +1,115 @@
+#include "ad7147.h"
+
+// 软件触摸检测
+// 每个阶段：IIR滤波 -> 基线跟踪 -> 差值 (基线 - 滤波值，触摸时为正) -> 阈值迟滞 + 快速触发
+// 芯片阈值只能在差值跌回阈值以下时才松开，滑动经过时手指离开前差值下降缓慢，松开明显拖后；
+// 快速触发以按下后的峰值为参照，回落一个行程即松开，不再等待绝对阈值
+// 按下期间基线冻结，持续超过AD7147_SW_MAX_TOUCH_FRAMES时视为环境突变 (水汽/异物/温漂)，以当前CDC重建该阶段基线
+uint16_t AD7147::SoftwareDetector::process(const uint16_t *cdc, uint8_t stage_count)
+{
+    if (reset_request_)
+    {
+        reset_request_ = false;
+        seed_remaining_ = AD7147_SW_SEED_SAMPLES;
+    }
+    if (stage_count > AD7147_MAX_CHANNELS)
+        stage_count = AD7147_MAX_CHANNELS;
+
+    // 复位后的若干帧直接以当前CDC作为基线，不输出触摸
+    if (seed_remaining_)
+    {
+        seed_remaining_--;
+        for (uint8_t stage = 0; stage < stage_count; stage++)
+        {
+            StageState &st = stages_[stage];
+            st.baseline = (int32_t)cdc[stage] << AD7147_SW_FRAC_BITS;
+            st.filtered = st.baseline;
+            st.extreme = 0;
+            st.touch_frames = 0;
+            st.touched = false;
+        }
+        return 0;
+    }
+
+    const int32_t press = press_threshold_;
+    const int32_t release = press - (press >> 2); // 迟滞：差值低于按下阈值的3/4才松开
+    const int32_t rapid = rapid_delta_;
+    uint16_t touch_mask = 0;
+
+    for (uint8_t stage = 0; stage < stage_count; stage++)
+    {
+        StageState &st = stages_[stage];
+        st.filtered += (((int32_t)cdc[stage] << AD7147_SW_FRAC_BITS) - st.filtered) >> AD7147_SW_FILTER_SHIFT;
+        const int32_t delta = (st.baseline - st.filtered) >> AD7147_SW_FRAC_BITS;
+
+        if (st.touched)
+        {
+            if (delta > st.extreme)
+                st.extreme = delta;
+            if (delta < release || delta <= st.extreme - rapid)
+            {
+                st.touched = false;
+                st.extreme = delta;
+            }
+            else if (++st.touch_frames >= AD7147_SW_MAX_TOUCH_FRAMES)
+            {
+                // 按下超时：重新播种基线，手指仍在时也需要重新按下才会触发
+                st.baseline = (int32_t)cdc[stage] << AD7147_SW_FRAC_BITS;
+                st.filtered = st.baseline;
+                st.extreme = 0;
+                st.touched = false;
+                continue;
+            }
+        }
+        else
+        {
+            if (delta < st.extreme)
+                st.extreme = delta;
+            // 完全离开 (谷值跌回迟滞下限以下) 后按绝对阈值按下；快速松开后手指仍在附近时，
+            // 差值仍在回落，只有自谷值回升一个行程才重新按下
+            if ((delta >= press && st.extreme < release) || (delta >= release && delta >= st.extreme + rapid))
+            {
+                st.touched = true;
+                st.extreme = delta;
+                st.touch_frames = 0;
+            }
+        }
+
+        if (st.touched)
+        {
+            touch_mask |= 1u << stage;
+        }
+        else if (delta < 0)
+        {
+            // CDC高于基线：松手后残留或复位时手在面板上，快速回升
+            st.baseline += (st.filtered - st.baseline) >> AD7147_SW_BASELINE_FAST_SHIFT;
+        }
+        else if (delta < release)
+        {
+            // 未触摸且不在接近区间时缓慢跟随环境漂移
+            st.baseline += (st.filtered - st.baseline) >> AD7147_SW_BASELINE_SHIFT;
+        }
+    }
+    return touch_mask;
+}
+
+void AD7147::setSoftwareDetection(bool enable)
+{
+    software_detector_.reset();
+    software_detect_enabled_ = enable;
+}
+
+void AD7147::setSoftwareThresholds(uint16_t press_threshold, uint16_t rapid_delta)
+{
+    software_detector_.press_threshold_ = MAX(press_threshold, (uint16_t)AD7147_SW_MIN_THRESHOLD);
+    software_detector_.rapid_delta_ = MAX(rapid_delta, (uint16_t)AD7147_SW_MIN_THRESHOLD);
+}
+
+int16_t AD7147::getSoftwareDelta(uint8_t stage) const
+{
+    if (stage >= AD7147_MAX_CHANNELS || !software_detect_enabled_)
+        return 0;
+    const SoftwareDetector::StageState &st = software_detector_.stages_[stage];
+    const int32_t delta = (st.baseline - st.filtered) >> AD7147_SW_FRAC_BITS;
+    return (int16_t)MAX(-32768, MIN(32767, delta));
+}
@@ -195,22 +195,14 @@ bool PSoC::read_reg16(uint8_t reg, uint16_t& value) {
     uint16_t tmp = 0;
     int32_t r = i2c_hal_->read_register(i2c_device_address_, reg, (uint8_t*)&tmp, 2);
     if (r != 2) return false;
-    __asm__ volatile (
-            "rev16 %0, %0\n"
-            : "+r" (tmp)
-            :: "cc"
-    );
+    tmp = __builtin_bswap16(tmp);  // 编译为 rev16
     value = tmp;
     return true;
 }
 
 bool PSoC::write_reg16(uint8_t reg, uint16_t value) {
     uint16_t tmp = value;
-    __asm__ volatile (
-            "rev16 %0, %0\n"
-            : "+r" (tmp)
-            :: "cc"
-    );
+    tmp = __builtin_bswap16(tmp);  // 编译为 rev16
     int32_t w = i2c_hal_->write_register(i2c_device_address_, reg, (uint8_t*)&tmp, 2);
     return w == 2;
 }
@@ -92,6 +92,15 @@ public:
     virtual bool sample_ready() {
         return true;
     };
+    
+    // 就绪中断 - 子类可选实现：使能后芯片在每轮转换完成时拉低INT引脚，就绪由主机侧的中断标志判断，
+    // 读取sample()的状态寄存器即清除中断；返回false表示不支持，调用方继续使用sample_ready()轮询
+    virtual bool setReadyInterrupt(bool enable) { return false; }
+    
+    // 原始值读取 - 子类可选实现：使能后sample()在同一事务中连同原始电容值一起读回；
+    // getRawValues()在采样完成回调中调用，返回本次采样的原始值 (values[i]对应阶段i)，count为0表示本次未读取
+    virtual bool setRawCapture(bool enable) { return false; }
+    virtual const uint16_t* getRawValues(uint8_t& count) const { count = 0; return nullptr; }
 
     /**
      * 获取当前模块支持的通道数量
@@ -22,7 +22,11 @@ static const char* ANSI_BRIGHT_RED = "\033[91m";
 USB_SerialLogs::USB_SerialLogs(HAL_USB* usb_hal)
     : usb_hal_(usb_hal)
     , initialized_(false)
-    , last_flush_time_(0) {
+    , last_flush_time_(0)
+    , commands_()
+    , command_count_(0)
+    , command_length_(0)
+    , command_overflow_(false) {
 }
 
 // 析构函数
@@ -285,6 +289,8 @@ void USB_SerialLogs::task() {
         return;
     }
     
+    process_commands();
+    
     // 自动刷新
     if (config_.auto_flush) {
         uint32_t current_time = time_us_32() / 1000;
@@ -296,6 +302,83 @@ void USB_SerialLogs::task() {
 
 
 
+// 注册CDC命令，同名命令覆盖原处理函数
+bool USB_SerialLogs::register_command(const char* name, USB_CommandHandler handler, const char* help) {
+    if (!name || !*name || !handler) {
+        return false;
+    }
+    for (uint8_t i = 0; i < command_count_; i++) {
+        if (strcmp(commands_[i].name, name) == 0) {
+            commands_[i].handler = handler;
+            commands_[i].help = help;
+            return true;
+        }
+    }
+    if (command_count_ >= USB_LOGS_MAX_COMMANDS) {
+        return false;
+    }
+    commands_[command_count_].name = name;
+    commands_[command_count_].help = help;
+    commands_[command_count_].handler = handler;
+    command_count_++;
+    return true;
+}
+
+// 读取CDC输入并按行分发命令
+void USB_SerialLogs::process_commands() {
+    uint8_t buffer[32];
+    size_t count;
+    while ((count = usb_hal_->cdc_read(buffer, sizeof(buffer))) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const char ch = static_cast<char>(buffer[i]);
+            if (ch == '\r' || ch == '\n') {
+                if (command_length_ && !command_overflow_) {
+                    command_line_[command_length_] = '\0';
+                    dispatch_command(command_line_);
+                }
+                command_length_ = 0;
+                command_overflow_ = false;
+            } else if (command_length_ < USB_LOGS_COMMAND_LENGTH - 1) {
+                command_line_[command_length_++] = ch;
+            } else {
+                command_overflow_ = true;
+            }
+        }
+    }
+}
+
+void USB_SerialLogs::dispatch_command(char* line) {
+    while (*line == ' ') {
+        line++;
+    }
+    char* args = line;
+    while (*args && *args != ' ') {
+        args++;
+    }
+    if (*args) {
+        *args++ = '\0';
+        while (*args == ' ') {
+            args++;
+        }
+    }
+    if (!*line) {
+        return;
+    }
+    if (strcmp(line, "help") == 0) {
+        for (uint8_t i = 0; i < command_count_; i++) {
+            infof("%s - %s", commands_[i].name, commands_[i].help);
+        }
+        return;
+    }
+    for (uint8_t i = 0; i < command_count_; i++) {
+        if (strcmp(commands_[i].name, line) == 0) {
+            commands_[i].handler(args);
+            return;
+        }
+    }
+    warningf("Unknown command: %s (type help)", line);
+}
+
 void USB_SerialLogs::global_log(USB_LogLevel level, const std::string& message, const std::string& tag) {
     if (global_instance_) {
         global_instance_->log(level, message, tag);
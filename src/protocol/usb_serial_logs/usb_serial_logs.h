@@ -12,6 +12,8 @@
 #define USB_LOGS_MAX_LINE_LENGTH 256
 #define USB_LOGS_BUFFER_BLOCKS 128  // 128个日志块
 #define USB_LOGS_BLOCK_SIZE (USB_LOGS_MAX_LINE_LENGTH + 64)  // 每块预留最长字节+头部空间
+#define USB_LOGS_MAX_COMMANDS 8           // 可注册的CDC命令数
+#define USB_LOGS_COMMAND_LENGTH 64        // 单行命令最大长度
 
 // 日志级别
 enum class USB_LogLevel : uint8_t {
@@ -119,6 +121,8 @@ struct USB_LogRingBuffer {
 // 回调函数类型
 using USB_LogCallback = std::function<void(const USB_LogEntry&)>;
 using USB_ErrorCallback = std::function<void(const std::string&)>;
+// CDC命令处理函数，args为命令名之后的参数 (可能为空串)，在usb_logs->task()所在核心执行
+using USB_CommandHandler = std::function<void(const char* args)>;
 
 // USB串口日志类
 class USB_SerialLogs {
@@ -153,6 +157,7 @@ public:
     
     // 原始数据输出
     bool write_raw(const uint8_t* data, size_t length);
+    inline size_t get_write_available() const { return is_ready() ? usb_hal_->cdc_write_available() : 0; }
     bool write_string(const std::string& str);
     bool write_line(const std::string& line);
     
@@ -185,6 +190,10 @@ public:
     inline void set_log_callback(USB_LogCallback callback) { log_callback_ = callback; }
     inline void set_error_callback(USB_ErrorCallback callback) { error_callback_ = callback; }
     
+    // 命令接口 - 主机经CDC发送一行文本 (\r或\n结束)，按首个单词分发；内置"help"列出已注册命令
+    // name/help须为静态字符串
+    bool register_command(const char* name, USB_CommandHandler handler, const char* help = "");
+    
     // 任务处理
     void task();
     
@@ -207,6 +216,18 @@ private:
     USB_LogCallback log_callback_;
     USB_ErrorCallback error_callback_;
     
+    // CDC命令
+    struct USB_Command {
+        const char* name;
+        const char* help;
+        USB_CommandHandler handler;
+    };
+    USB_Command commands_[USB_LOGS_MAX_COMMANDS];
+    uint8_t command_count_;
+    char command_line_[USB_LOGS_COMMAND_LENGTH];
+    uint8_t command_length_;
+    bool command_overflow_;                 // 当前行超长，丢弃到行尾
+    
     // 静态全局实例
     static USB_SerialLogs* global_instance_;
     
@@ -222,6 +243,8 @@ private:
     void add_to_queue(const USB_LogEntry& entry);
     
     void update_statistics(USB_LogLevel level);
+    void process_commands();
+    void dispatch_command(char* line);
     void handle_error(const std::string& error_msg);
     
     // 格式化辅助方法
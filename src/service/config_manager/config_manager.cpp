@@ -31,6 +31,8 @@ std::map<std::string, std::string> ConfigManager::_string_cache;
 std::vector<ConfigInitFunction> ConfigManager::_init_functions;
 bool ConfigManager::_littlefs_ready = false;
 volatile bool ConfigManager::_save_requested = false;
+bool ConfigManager::_save_due = false;
+WheelTimer ConfigManager::_save_timer;
 ConfigManager* ConfigManager::_instance = nullptr;
 // DEBUG
 bool ConfigManager::_debug_output_enabled = false;
@@ -53,6 +55,7 @@ ConfigManager::ConfigManager() {
 // 析构函数
 ConfigManager::~ConfigManager() {
     if (_initialized) {
+        _save_due = true;
         save_config_task();
     }
 }
@@ -1247,14 +1250,31 @@ bool ConfigManager::register_init_function(ConfigInitFunction func) {
 // 置位保存信号
 void ConfigManager::save_config() {
     _save_requested = true;
+    __sev();  // 唤醒可能在时间轮上休眠的Core0
 }
 
+// 去抖窗口到期 - 在Core0时间轮上回调，直接执行写入
+void ConfigManager::on_save_timer(void*) {
+    _save_due = true;
+    save_config_task();
+}
 
 // 保存配置到文件（task版本，检查信号）
+// 首个请求在Core0时间轮上开启去抖窗口，窗口到期前的请求并入同一次写入
 bool ConfigManager::save_config_task() {
     if (!_save_requested) {
         return true;  // 没有保存请求，直接返回成功
     }
+    if (!_save_due) {
+        if (!_save_timer.pending()) {
+            TimerWheel::core().schedule_after(_save_timer, CONFIG_SAVE_DEBOUNCE_US, on_save_timer);
+        }
+        return true;
+    }
+    _save_due = false;
+    if (_save_timer.pending()) {
+        TimerWheel::core().cancel(_save_timer);
+    }
     
     // 调用各服务的配置写入函数
     InputManager_PrivateConfig input_config = inputmanager_get_config_copy();
@@ -1286,6 +1306,8 @@ bool ConfigManager::save_config_task() {
 // 重置到默认配置
 bool ConfigManager::reset_to_defaults() {
     _runtime_map = _default_map;
+    _save_requested = true;
+    _save_due = true;  // 恢复默认立即落盘，不经去抖窗口
     return save_config_task();
 }
 
@@ -5,6 +5,7 @@
 #include <functional>
 #include "config_types.h"
 #include "config_crc.h"
+#include "../../hal/timer_wheel.h"
 
 #ifdef PICO_PLATFORM
 #include "LittleFS.h"
@@ -13,6 +14,9 @@
 // 配置键常量
 #define CONFIG_KEY_CRC "__crc32__"
 
+// 保存请求去抖窗口 - 窗口内的连续保存请求合并为一次Flash写入
+#define CONFIG_SAVE_DEBOUNCE_US 200000
+
 // 配置初始化函数类型
 using ConfigInitFunction = std::function<void(config_map_t&)>;
 
@@ -193,6 +197,9 @@ private:
     // 核心私有成员
     static bool _littlefs_ready;            // LittleFS就绪状态
     static volatile bool _save_requested;    // 保存请求信号
+    static bool _save_due;                   // 去抖窗口已到期，下一次save_config_task执行写入
+    static WheelTimer _save_timer;           // 保存去抖定时器 (Core0时间轮)
+    static void on_save_timer(void* context);
     
     // 单例实例
     static ConfigManager* _instance;
@@ -12,6 +12,12 @@
 InputManager *InputManager::instance_ = nullptr;
 // 静态配置变量
 static InputManager_PrivateConfig static_config_;
+// 串口映射已变化、需要重建区域编译表 (配置加载等非成员函数也会修改映射)
+static volatile bool serial_area_table_dirty_ = true;
+// HID坐标映射已变化、需要重建坐标编译表
+static volatile bool hid_coord_table_dirty_ = true;
+// 键盘映射被整体替换 (配置写入)，需要重新编译键盘分发表
+static volatile bool keyboard_dispatch_dirty_ = false;
 // 常量空逻辑映射表
 static const LogicalKeyMapping EMPTY_LOGICAL_MAPPINGS[1] = { LogicalKeyMapping() };
 // Debug开关静态变量
@@ -23,6 +29,20 @@ InputManager::SerialModeDelayState InputManager::serial_delay_state_;
 uint32_t InputManager::device_completed_bitmap_ = 0;
 uint8_t InputManager::total_device_count_ = 0;
 
+// I2C采样调度参数
+#define SAMPLING_FAILURE_THRESHOLD 3        // 连续失败达到该次数后开始退避
+#define SAMPLING_FAILURE_BACKOFF_US 1000    // 首次退避时间，之后每次翻倍
+#define SAMPLING_MAX_BACKOFF_US 100000      // 退避上限
+#define SAMPLING_MIN_POLL_BACKOFF_US 0      // 未就绪时的重查间隔 (0表示下一轮主循环，只在预计就绪点之后发生)
+#define TOUCH_TELEMETRY_WINDOW_US 1000000   // 采样遥测窗口
+#define TOUCH_INT_FALLBACK_US 20000         // INT设备距上次完成超过该时间仍无中断时，退回I2C就绪查询
+#define TOUCH_INT_FALLBACK_LIMIT 8          // 连续这么多次靠查询才发现就绪时判定INT失效，锁定为轮询直到重新配置
+
+// 总线对应的I2C实例，采样失败时从中读取中止原因
+static inline HAL_I2C* sampling_bus_hal(uint8_t i2c_bus) {
+    return i2c_bus ? static_cast<HAL_I2C*>(HAL_I2C1::getInstance()) : static_cast<HAL_I2C*>(HAL_I2C0::getInstance());
+}
+
 // 单例模式实现
 InputManager *InputManager::getInstance()
 {
@@ -35,17 +55,30 @@ InputManager *InputManager::getInstance()
 
 // 私有构造函数
 InputManager::InputManager()
-    : delay_buffer_head_(0)
+    : i2c_bus_busy_permille_()
+    , telemetry_window_start_us_(0)
+    , telemetry_dump_pending_(false)
+    , telemetry_reset_pending_(false)
+    , serial_area_module_count_(0)
+    , serial_combo_count_(0)
+    , hid_coord_module_count_(0)
+    , delay_buffer_head_(0)
     , delay_buffer_count_(0)
+    , delay_buffer_seq_(0)
     , mcu_gpio_states_(0)
     , mcu_gpio_previous_states_(0)
     , serial_state_()
     , touch_keyboard_current_time_cache_(0)
-    , touch_keyboard_areas_matched_cache_(false)
     , touch_keyboard_hold_satisfied_cache_(false)
     , sample_counter_(0)
     , last_reset_time_(0)
     , current_sample_rate_(0)
+    , frame_sample_us_(0)
+    , latency_dump_pending_(false)
+    , latency_reset_pending_(false)
+    , last_frame_us_(0)
+    , frame_stale_bitmap_(0)
+    , touch_frame_stats_()
     , binding_active_(false)
     , binding_callback_()
     , binding_state_(BindingState::IDLE)
@@ -67,22 +100,31 @@ InputManager::InputManager()
     , touch_bitmap_cache_()
     , mcp_gpio_states_()
     , mcp_gpio_previous_states_()
-    , gpio_mcu_changed_(0)
     , gpio_mcu_inverted_(0)
-    , gpio_mcp_changed_a_(0)
-    , gpio_mcp_changed_b_(0)
     , gpio_mcp_inverted_a_(0)
     , gpio_mcp_inverted_b_(0)
-    , gpio_mappings_cache_(nullptr)
-    , gpio_mapping_count_cache_(0)
     , gpio_logical_mappings_cache_(EMPTY_LOGICAL_MAPPINGS)
     , gpio_logical_count_cache_(0)
-    , gpio_pin_cache_(0)
-    , gpio_pin_num_cache_(0)
-    , gpio_bit_pos_cache_(0)
-    , gpio_current_state_cache_(false)
-    , gpio_mapping_ptr_cache_(nullptr)
-    , gpio_keys_ptr_cache_(nullptr)
+    , gpio_dispatch_count_(0)
+    , gpio_mapped_inputs_(0)
+    , gpio_sample_time_us_(0)
+    , gpio_debounced_inputs_(0)
+    , gpio_debounce_eager_(0)
+    , gpio_debounce_defer_(0)
+    , gpio_debounce_pending_(0)
+    , gpio_irq_mcp_states_()
+    , gpio_irq_inputs_(0)
+    , mcp_int_pin_(0xFF)
+    , gpio_irq_active_(false)
+    , gpio_edge_overflow_(false)
+    , mcp_read_pending_(false)
+    , touch_dispatch_count_(0)
+    , touch_dispatch_active_(0)
+    , touch_dispatch_touched_(0)
+    , touch_dispatch_waiting_(0)
+    , touch_dispatch_release_next_(0)
+    , touch_hold_timer_()
+    , touch_hold_expired_(false)
     , last_sent_serial_state_()
     , remaining_extra_sends_(0)
     , serial_state_changed_(false)
@@ -99,6 +141,14 @@ InputManager::InputManager()
     for (int i = 0; i < 2; i++) {
         i2c_sampling_stages_[i] = I2C_SamplingStage();
     }
+    memset(device_timing_, 0, sizeof(device_timing_));
+    memset(device_telemetry_, 0, sizeof(device_telemetry_));
+    memset(touch_int_pins_, 0xFF, sizeof(touch_int_pins_));
+    memset(touch_int_fallbacks_, 0, sizeof(touch_int_fallbacks_));
+    for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++) {
+        touch_int_ready_[i] = false;
+    }
+    touch_int_pin_mask_ = 0;
 
     // 初始化MCP GPIO状态
     mcp_gpio_states_.port_a = 0;
@@ -121,12 +171,13 @@ bool InputManager::init(const InitConfig &config)
     hid_ = config.hid;
     mcp23s17_ = config.mcp23s17;
     mcp23s17_available_ = (mcp23s17_ != nullptr);
+    mcp_int_pin_ = config.mcp23s17_int_pin;
     ui_manager_ = config.ui_manager;
     
     // 加载配置
     inputmanager_load_config_from_manager();
-    // 基于已加载的键盘映射重建反转位图（ACTIVE_LOW位翻转掩码）
-    rebuildGPIOInversionMasks();
+    // 基于已加载的键盘映射编译分发表（同时派生ACTIVE_LOW位翻转掩码）
+    compileKeyboardDispatch();
     
     // 应用mai2serial配置到实例
     if (mai2_serial_) {
@@ -173,7 +224,7 @@ void InputManager::start() {
     // 首先清空所有阶段
     for (int bus = 0; bus < 2; bus++) {
         for (int stage = 0; stage < 4; stage++) {
-            i2c_sampling_stages_[bus].device_instances[stage] = nullptr;
+            unregisterDeviceFromStage(bus, stage);
         }
     }
     
@@ -243,6 +294,9 @@ void InputManager::start() {
         }
     }
     log_info("Initialized device sampling bitmap for " + std::to_string(total_device_count_) + " devices");
+    resetSamplingSchedule();
+    setupTouchReadyInterrupts();
+    TimerWheel::core().schedule_periodic(telemetry_timer_, TOUCH_TELEMETRY_WINDOW_US, onTelemetryTimer, this);
     
     log_info("InputManager start completed");
 }
@@ -398,13 +452,7 @@ bool InputManager::addPhysicalKeyboard(MCU_GPIO gpio, HID_KeyCode default_key, G
     // 添加新映射
     PhysicalKeyboardMapping new_mapping(gpio, default_key, effective_level);
     config_->physical_keyboard_mappings.push_back(new_mapping);
-    // 增量更新MCU反转位图
-    uint8_t pin_num = get_gpio_pin_number(static_cast<uint8_t>(gpio));
-    if (effective_level == GPIOTriggerLevel::ACTIVE_LOW) {
-        gpio_mcu_inverted_ |= (1u << pin_num);
-    } else {
-        gpio_mcu_inverted_ &= ~(1u << pin_num);
-    }
+    compileKeyboardDispatch();
     // 运行时电平有效性检查（仅日志提示，不更改配置）
     sanityCheckPhysicalKeyboard(new_mapping);
     return true;
@@ -450,29 +498,31 @@ bool InputManager::addPhysicalKeyboard(MCP_GPIO gpio, HID_KeyCode default_key, G
     // 添加新映射
     PhysicalKeyboardMapping new_mapping(gpio, default_key, effective_level);
     config_->physical_keyboard_mappings.push_back(new_mapping);
-    // 增量更新MCP反转位图
-    uint8_t raw = static_cast<uint8_t>(gpio);
-    uint8_t pin_num = get_gpio_pin_number(raw);
-    if (pin_num <= 8) {
-        uint8_t bit_pos = pin_num - 1;
-        if (effective_level == GPIOTriggerLevel::ACTIVE_LOW) {
-            gpio_mcp_inverted_a_ |= (1u << bit_pos);
-        } else {
-            gpio_mcp_inverted_a_ &= ~(1u << bit_pos);
-        }
-    } else {
-        uint8_t bit_pos = pin_num - 9;
-        if (effective_level == GPIOTriggerLevel::ACTIVE_LOW) {
-            gpio_mcp_inverted_b_ |= (1u << bit_pos);
-        } else {
-            gpio_mcp_inverted_b_ &= ~(1u << bit_pos);
-        }
-    }
+    compileKeyboardDispatch();
     // 运行时电平有效性检查（仅日志提示，不更改配置）
     sanityCheckPhysicalKeyboard(new_mapping);
     return true;
 }
 
+// 设置指定物理按键的消抖算法与时间；debounce_us为0等同于不消抖
+bool InputManager::setPhysicalKeyboardDebounce(uint8_t gpio_id, GPIODebounceMode mode, uint16_t debounce_us)
+{
+    auto it = std::find_if(config_->physical_keyboard_mappings.begin(),
+                           config_->physical_keyboard_mappings.end(),
+                           [gpio_id](const PhysicalKeyboardMapping &mapping)
+                           {
+                               return mapping.gpio == gpio_id;
+                           });
+    if (it == config_->physical_keyboard_mappings.end())
+    {
+        return false;
+    }
+    it->debounce_mode = mode;
+    it->debounce_us = debounce_us;
+    compileKeyboardDispatch();
+    return true;
+}
+
 bool InputManager::removePhysicalKeyboard(uint8_t gpio_pin)
 {
     auto it = std::find_if(config_->physical_keyboard_mappings.begin(),
@@ -485,8 +535,8 @@ bool InputManager::removePhysicalKeyboard(uint8_t gpio_pin)
     if (it != config_->physical_keyboard_mappings.end())
     {
         config_->physical_keyboard_mappings.erase(it);
-        // 删除映射后重建一次反转位图，保证一致性
-        rebuildGPIOInversionMasks();
+        // 删除映射后重新编译分发表，保证一致性
+        compileKeyboardDispatch();
         return true;
     }
 
@@ -499,21 +549,9 @@ inline void InputManager::processSerialModeWithDelay()
     static Mai2Serial_TouchState delayed_serial_state;
     static uint32_t target_time;
     static uint16_t buffer_idx;
-    static uint32_t current_timestamp;
-    static uint16_t search_offset;
     static uint32_t last_rate_limit_time = 0;  // 上次发送时间（频率限制用）
     static uint32_t current_time = 0;  // 使用静态变量避免栈分配
-    // 使用union位域优化bool变量存储，支持一次性重置所有标志
-    static union {
-        struct {
-            uint8_t found : 1;  // 是否找到符合条件的数据
-            uint8_t reserved : 7;  // 预留位，供未来扩展
-        };
-        uint8_t all_flags;  // 用于一次性重置所有标志位
-    } flags;
 
-    flags.all_flags = 0;
-    
     // 如果缓冲区为空，直接返回
     if (delay_buffer_count_ == 0) {
         return;
@@ -539,48 +577,8 @@ inline void InputManager::processSerialModeWithDelay()
     // 计算目标时间点（当前时间减去延迟时间）
     target_time = time_us_32() - (config_->touch_response_delay_ms * 1000U);
     
-    // 限制偏移范围，防止越界
-    if (serial_delay_state_.last_hit_offset >= delay_buffer_count_) {
-        serial_delay_state_.last_hit_offset = delay_buffer_count_ / 2;  // 重置到中间位置
-    }
-    
-    // 从上次命中位置开始搜索
-    buffer_idx = (delay_buffer_head_ - serial_delay_state_.last_hit_offset) & (DELAY_BUFFER_SIZE - 1);
-    current_timestamp = delay_buffer_[buffer_idx].timestamp_us;
-    
-    if (current_timestamp <= target_time) {
-        // 当前位置时间戳过旧，需要向最新方向搜索最贴近目标的位置
-        uint16_t best_idx = buffer_idx;
-        uint16_t best_offset = serial_delay_state_.last_hit_offset;
-        
-        // 向最新方向搜索，找到最后一个符合条件的位置
-        for (search_offset = serial_delay_state_.last_hit_offset - 1; search_offset > 0; --search_offset) {
-            buffer_idx = (delay_buffer_head_ - search_offset) & (DELAY_BUFFER_SIZE - 1);
-            if (delay_buffer_[buffer_idx].timestamp_us <= target_time) {
-                best_idx = buffer_idx;
-                best_offset = search_offset;
-            } else {
-                break;  // 找到第一个不符合的，停止搜索
-            }
-        }
-        
-        buffer_idx = best_idx;
-        serial_delay_state_.last_hit_offset = best_offset;
-        delayed_serial_state = delay_buffer_[buffer_idx].serial_touch_state;
-        goto process_aggregation;
-    }
-    
-    // 当前位置时间戳过新，需要向过去方向搜索第一个符合条件的位置
-    for (search_offset = serial_delay_state_.last_hit_offset + 1; search_offset <= delay_buffer_count_; ++search_offset) {
-        buffer_idx = (delay_buffer_head_ - search_offset) & (DELAY_BUFFER_SIZE - 1);
-        if (delay_buffer_[buffer_idx].timestamp_us <= target_time) {
-            serial_delay_state_.last_hit_offset = search_offset;
-            flags.found = 1;
-            break;
-        }
-    }
-    
-    if (!flags.found) {
+    // 二分查找最新的、时间戳不晚于目标时间的帧
+    if (!findDelayedFrame(target_time, buffer_idx)) {
         // 没找到符合条件的，说明还没到发送时候
         return;
     }
@@ -590,16 +588,11 @@ inline void InputManager::processSerialModeWithDelay()
 process_aggregation:
     // 新的投票聚合处理（按位多数投票 + 平票取反 + 无样本沿用）
     if (config_->data_aggregation_delay_ms > 0) {
-        // 重置投票状态
-        serial_delay_state_.voting_state.reset();
-
         // 使用静态变量，减少栈分配和提升缓存命中
         static uint32_t anchor_end_time;
         static uint32_t agg_us;
         static uint32_t aggregation_start_time;
-        static uint16_t idx;
-        static uint16_t i;
-        static uint32_t check_timestamp;
+        static uint64_t voting_result;
 
         // 计算聚合时间范围：以选定的“目标时间”作为结束点
         // 非零延迟：窗口结束于target_time；零延迟：窗口结束于当前选中样本的时间戳
@@ -611,38 +604,12 @@ process_aggregation:
             ? (anchor_end_time - agg_us)
             : 0U;
 
-        // 从已命中的索引(buffer_idx)开始，向过去方向遍历，减少“过新样本”判断和无效扫描
-        i = 0;
-        idx = buffer_idx;
-        while (i < delay_buffer_count_) {
-            check_timestamp = delay_buffer_[idx].timestamp_us;
-            if (check_timestamp < aggregation_start_time) {
-                break;  // 时间戳过旧，停止搜索
-            }
-            const Mai2Serial_TouchState &state = delay_buffer_[idx].serial_touch_state;
-            serial_delay_state_.voting_state.accumulate(state.parts.state1, state.parts.state2);
-            // 递减索引并继续向过去遍历
-            idx = (uint16_t)((idx - 1) & (DELAY_BUFFER_SIZE - 1));
-            ++i;
-        }
-
-        // 使用投票聚合算法计算最终状态
-        static uint32_t temp_state1, temp_state2;
-        temp_state1 = 0;
-        temp_state2 = 0;
-        serial_delay_state_.voting_state.getVotingResult(
-            temp_state1,
-            temp_state2,
-            serial_delay_state_.last_emitted_result
-        );
+        // 滑动窗口只处理新进入与刚离开的样本，不再每帧重扫整个窗口
+        voting_result = updateVotingWindow(buffer_idx, aggregation_start_time);
 
         // 若窗口内存在样本，更新聚合状态；否则沿用之前的 delayed_serial_state
         if (serial_delay_state_.voting_state.total_samples > 0) {
-            static Mai2Serial_TouchState aggregated_state;  // 使用静态，避免重复栈分配
-            aggregated_state.raw = 0;
-            aggregated_state.parts.state1 = temp_state1;
-            aggregated_state.parts.state2 = temp_state2;
-            delayed_serial_state = aggregated_state;
+            delayed_serial_state.raw = voting_result;
         }
     }
     
@@ -669,11 +636,14 @@ process_aggregation:
             remaining_extra_sends_ = config_->extra_send_count;
         }
     }
-    serial_state_ = delayed_serial_state;  // 始终同步
+    serial_state_.store(delayed_serial_state);  // 始终同步，发布给task1
     // 发送数据
     if (should_send) {
+        static uint32_t select_us;
+        select_us = time_us_32();
         // 仅在发送成功时更新last_sent_serial_state_，确保发送失败时保持差异检测
         if (mai2_serial_->send_touch_data(delayed_serial_state)) {
+            recordTouchLatency(delay_buffer_[buffer_idx], select_us);
             last_sent_serial_state_ = delayed_serial_state;  // 更新上次发送状态
             serial_delay_state_.last_emitted_result = delayed_serial_state;  // 更新上次发出结果
             
@@ -686,13 +656,107 @@ process_aggregation:
     }
 }
 
+// 在延迟缓冲区中查找最新的、时间戳不晚于target_time的帧
+// 环内时间戳单调递增 (按偏移由新到旧单调递减)，对偏移 [1, count] 二分查找：
+// 最坏 ceil(log2(DELAY_BUFFER_SIZE)) + 1 = 10 次探测，与采样率波动和环回绕无关
+// 时间比较使用有符号差值，time_us_32回绕时仍然有效
+bool InputManager::findDelayedFrame(uint32_t target_time, uint16_t &buffer_idx) const
+{
+    // 最旧的帧也晚于目标时间：还没到发送时候
+    uint16_t hi = delay_buffer_count_;
+    if (hi == 0 ||
+        static_cast<int32_t>(delay_buffer_[(delay_buffer_head_ - hi) & (DELAY_BUFFER_SIZE - 1)].timestamp_us - target_time) > 0)
+    {
+        return false;
+    }
+    // 不变式：偏移hi处的帧满足条件，偏移lo处的帧不满足 (lo=0 为虚拟的"未来"位置)
+    uint16_t lo = 0;
+    while (hi - lo > 1)
+    {
+        const uint16_t mid = (lo + hi) >> 1;
+        if (static_cast<int32_t>(delay_buffer_[(delay_buffer_head_ - mid) & (DELAY_BUFFER_SIZE - 1)].timestamp_us - target_time) > 0)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    buffer_idx = (delay_buffer_head_ - hi) & (DELAY_BUFFER_SIZE - 1);
+    return true;
+}
+
+// 将聚合窗口滑动到 [window_start_time, end_idx]，返回按位投票结果
+// 常规路径只累加新进入窗口的样本、扣除已过期的样本；
+// 窗口起点回退、终点回退或最旧样本已被覆盖时 (修改延迟/清空缓冲区) 才整体重建
+uint64_t InputManager::updateVotingWindow(uint16_t end_idx, uint32_t window_start_time)
+{
+    SerialModeDelayState &window = serial_delay_state_;
+    VotingAggregationState &voting = window.voting_state;
+    // 帧序号 -> 环形缓冲区索引：序号 delay_buffer_seq_-1 对应 head-1
+    auto seq_to_index = [this](uint32_t seq) -> uint16_t {
+        return (uint16_t)((delay_buffer_head_ - (delay_buffer_seq_ - seq)) & (DELAY_BUFFER_SIZE - 1));
+    };
+
+    const uint32_t end_seq = delay_buffer_seq_ - ((delay_buffer_head_ - end_idx) & (DELAY_BUFFER_SIZE - 1)) + 1;
+
+    if (!window.window_valid ||
+        (delay_buffer_seq_ - window.window_begin_seq) > delay_buffer_count_ ||
+        static_cast<int32_t>(end_seq - window.window_end_seq) < 0 ||
+        static_cast<int32_t>(window_start_time - window.window_start_time) < 0)
+    {
+        // 重建：从终点向过去累加，直到时间戳早于窗口起点
+        voting.reset();
+        window.window_end_seq = end_seq;
+        window.window_begin_seq = end_seq;
+        while ((delay_buffer_seq_ - (window.window_begin_seq - 1)) <= delay_buffer_count_)
+        {
+            const DelayedSerialState &frame = delay_buffer_[seq_to_index(window.window_begin_seq - 1)];
+            if (static_cast<int32_t>(frame.timestamp_us - window_start_time) < 0) break;
+            voting.accumulate(frame.serial_touch_state.raw);
+            window.window_begin_seq--;
+        }
+        window.window_valid = true;
+    }
+    else
+    {
+        // 新样本进入窗口
+        while (window.window_end_seq != end_seq)
+        {
+            voting.accumulate(delay_buffer_[seq_to_index(window.window_end_seq)].serial_touch_state.raw);
+            window.window_end_seq++;
+        }
+        // 过期样本离开窗口
+        while (window.window_begin_seq != window.window_end_seq)
+        {
+            const DelayedSerialState &frame = delay_buffer_[seq_to_index(window.window_begin_seq)];
+            if (static_cast<int32_t>(frame.timestamp_us - window_start_time) >= 0) break;
+            voting.remove(frame.serial_touch_state.raw);
+            window.window_begin_seq++;
+        }
+    }
+    window.window_start_time = window_start_time;
+
+    return voting.getVotingResult(window.last_emitted_result);
+}
+
+// 记录已发出帧的各阶段延迟，串口发送成功后调用
+inline void InputManager::recordTouchLatency(const DelayedSerialState& frame, uint32_t select_us)
+{
+    static uint32_t wire_us;
+    wire_us = mai2_serial_->get_last_packet_tx_us();
+    touch_latency_[static_cast<uint8_t>(TouchLatencyStage::SAMPLE_TO_BUFFER)].record(frame.timestamp_us - frame.sample_us);
+    touch_latency_[static_cast<uint8_t>(TouchLatencyStage::BUFFER_TO_SELECT)].record(select_us - frame.timestamp_us);
+    touch_latency_[static_cast<uint8_t>(TouchLatencyStage::SELECT_TO_WIRE)].record(wire_us - select_us);
+    touch_latency_[static_cast<uint8_t>(TouchLatencyStage::SAMPLE_TO_WIRE)].record(wire_us - frame.sample_us);
+}
+
 void InputManager::clearPhysicalKeyboards()
 {
     config_->physical_keyboard_mappings.clear();
-    // 同步清空反转位图
-    gpio_mcu_inverted_ = 0;
-    gpio_mcp_inverted_a_ = 0;
-    gpio_mcp_inverted_b_ = 0;
+    // 同步清空分发表与反转位图
+    compileKeyboardDispatch();
 }
 
 // 触摸键盘映射管理方法
@@ -724,6 +788,9 @@ bool InputManager::addTouchKeyboardMapping(uint64_t area_mask, uint32_t hold_tim
     if (area_mask == 0 || key == HID_KeyCode::KEY_NONE) {
         return false;
     }
+    if (config_->touch_keyboard_mappings.size() >= MAX_TOUCH_KEYBOARD_MAPPINGS) {
+        return false; // 超出分发表容量
+    }
     
     // 检查是否已存在相同的映射
     for (const auto& mapping : config_->touch_keyboard_mappings) {
@@ -735,6 +802,7 @@ bool InputManager::addTouchKeyboardMapping(uint64_t area_mask, uint32_t hold_tim
     // 添加新映射
     TouchKeyboardMapping new_mapping(area_mask, hold_time_ms, key, trigger_once);
     config_->touch_keyboard_mappings.push_back(new_mapping);
+    compileKeyboardDispatch();
     
     return true;
 }
@@ -749,6 +817,7 @@ bool InputManager::removeTouchKeyboardMapping(uint64_t area_mask, HID_KeyCode ke
     
     if (it != config_->touch_keyboard_mappings.end()) {
         config_->touch_keyboard_mappings.erase(it);
+        compileKeyboardDispatch();
         return true;
     }
     
@@ -760,58 +829,126 @@ const std::vector<TouchKeyboardMapping>& InputManager::getTouchKeyboardMappings(
     return config_->touch_keyboard_mappings;
 }
 
-inline void InputManager::checkTouchKeyboardTrigger()
+void InputManager::checkTouchKeyboardTrigger()
 {
     // 缓存当前时间，避免重复系统调用
     touch_keyboard_current_time_cache_ = us_to_ms(time_us_32());
-    // 遍历所有触摸键盘映射，采用静态缓存变量，直接调用HID接口置位按键
-    for (auto &mapping : config_->touch_keyboard_mappings) {
-        touch_keyboard_areas_matched_cache_ = MAI2_TOUCH_CHECK_MASK(serial_state_, mapping.area_mask);
-
-        if (__builtin_expect(touch_keyboard_areas_matched_cache_, 0)) {
-            // 区域匹配，检查是否刚开始按下
-            if (__builtin_expect(mapping.press_timestamp == 0, 0)) {
-                mapping.press_timestamp = touch_keyboard_current_time_cache_;
+    // 每轮只读取一次Core0发布的一致快照，避免64位状态被撕裂
+    const uint64_t touched = serial_state_.load().raw;
+
+    // 待处理项：上一轮trigger_once已按下的项 + 引用了变化区域的项 + 长按到期的等待项
+    uint32_t work = touch_dispatch_release_next_;
+    uint64_t changed = (touched ^ touch_dispatch_touched_) & ((1ULL << 34) - 1);
+    touch_dispatch_touched_ = touched;
+    while (changed) {
+        const uint8_t area = __builtin_ctzll(changed);
+        changed &= changed - 1;
+        work |= touch_area_dispatch_[area];
+    }
+    if (touch_hold_expired_) {
+        touch_hold_expired_ = false;
+        work |= touch_dispatch_waiting_;
+    }
+    if (__builtin_expect(!work, 1)) {
+        return;
+    }
+
+    // 按分发项顺序处理，与逐项遍历时的按键顺序一致
+    while (work) {
+        const uint8_t i = __builtin_ctz(work);
+        work &= work - 1;
+        evaluateTouchKeyboardEntry(i, touched, touch_keyboard_current_time_cache_);
+    }
+
+    // 按最早的长按到期时间重新设置定时器
+    uint32_t waiting = touch_dispatch_waiting_;
+    if (!waiting) {
+        TimerWheel::core().cancel(touch_hold_timer_);
+        return;
+    }
+    uint32_t earliest = UINT32_MAX;
+    while (waiting) {
+        const uint8_t i = __builtin_ctz(waiting);
+        waiting &= waiting - 1;
+        const uint32_t remaining = touch_dispatch_states_[i].press_timestamp + touch_dispatch_entries_[i].hold_time_ms
+                                   - touch_keyboard_current_time_cache_;
+        if (remaining < earliest) earliest = remaining;
+    }
+    // 截止时间对齐到毫秒边界，与按下时间戳的毫秒精度一致
+    TimerWheel::core().schedule_at(touch_hold_timer_, (touch_keyboard_current_time_cache_ + earliest) * 1000u,
+                                   &InputManager::onTouchHoldTimer, this);
+}
+
+// 长按定时器到期 (Core1时间轮回调)：标记后由下一轮checkTouchKeyboardTrigger处理
+void InputManager::onTouchHoldTimer(void* context)
+{
+    static_cast<InputManager*>(context)->touch_hold_expired_ = true;
+}
+
+// 处理单个触摸分发项：区域匹配时推进长按/触发阶段，不匹配时释放按键并复位
+inline void InputManager::evaluateTouchKeyboardEntry(uint8_t i, uint64_t touched, uint32_t now_ms)
+{
+    const TouchKeyboardDispatchEntry &entry = touch_dispatch_entries_[i];
+    TouchKeyboardDispatchState &state = touch_dispatch_states_[i];
+    const uint32_t bit = 1u << i;
+
+    if ((touched & entry.area_mask) != entry.area_mask) {
+        // 区域不匹配：仅当该项处于非空闲状态时释放按键并重置触发阶段
+        if (touch_dispatch_active_ & bit) {
+            if (state.key_pressed) {
+                hid_->release_key(KeyboardBitmap::getKeyAt(entry.key_bit));
+                state.key_pressed = false;
             }
+            state.stage = TOUCH_KEYBOARD_TRIGGLE_STAGE_NONE;
+            state.press_timestamp = 0;
+            touch_dispatch_active_ &= ~bit;
+            touch_dispatch_waiting_ &= ~bit;
+            touch_dispatch_release_next_ &= ~bit;
+        }
+        return;
+    }
 
-            touch_keyboard_hold_satisfied_cache_ = (mapping.hold_time_ms == 0) ||
-                                                   ((touch_keyboard_current_time_cache_ - mapping.press_timestamp) >= mapping.hold_time_ms);
-
-            // 处理触发逻辑
-            if (mapping.trigger_once) {
-                // trigger_once：同一次触摸只触发一次；离开区域后才能再次触发
-                if (mapping.has_triggered == TOUCH_KEYBOARD_TRIGGLE_STAGE_NONE) {
-                    if (__builtin_expect(touch_keyboard_hold_satisfied_cache_, 0)) {
-                        hid_->press_key(mapping.key);
-                        mapping.key_pressed = true;
-                        mapping.has_triggered = TOUCH_KEYBOARD_TRIGGLE_STAGE_PRESS;
-                    }
-                } else if (mapping.has_triggered == TOUCH_KEYBOARD_TRIGGLE_STAGE_PRESS) {
-                    // 下一次检查立即松开
-                    hid_->release_key(mapping.key);
-                    mapping.key_pressed = false;
-                    mapping.has_triggered = TOUCH_KEYBOARD_TRIGGLE_STAGE_RELEASE;
-                } else {
-                    // RELEASE 状态下不触发，等待离开区域后在else分支中重置为 NONE
-                    mapping.key_pressed = false;
-                }
+    // 区域匹配，检查是否刚开始按下
+    touch_dispatch_active_ |= bit;
+    if (state.press_timestamp == 0) {
+        state.press_timestamp = now_ms;
+    }
+
+    touch_keyboard_hold_satisfied_cache_ = (entry.hold_time_ms == 0) ||
+                                           ((now_ms - state.press_timestamp) >= entry.hold_time_ms);
+
+    if (entry.flags & KEYBOARD_DISPATCH_TRIGGER_ONCE) {
+        // trigger_once：同一次触摸只触发一次；离开区域后才能再次触发
+        if (state.stage == TOUCH_KEYBOARD_TRIGGLE_STAGE_NONE) {
+            if (touch_keyboard_hold_satisfied_cache_) {
+                hid_->press_key(KeyboardBitmap::getKeyAt(entry.key_bit));
+                state.key_pressed = true;
+                state.stage = TOUCH_KEYBOARD_TRIGGLE_STAGE_PRESS;
+                touch_dispatch_waiting_ &= ~bit;
+                touch_dispatch_release_next_ |= bit;
             } else {
-                // 正常模式：满足条件就按下按键（持续触发）
-                if (__builtin_expect(touch_keyboard_hold_satisfied_cache_, 0)) {
-                    if (!mapping.key_pressed) {
-                        hid_->press_key(mapping.key);
-                        mapping.key_pressed = true;
-                    }
-                }
+                touch_dispatch_waiting_ |= bit;
             }
+        } else if (state.stage == TOUCH_KEYBOARD_TRIGGLE_STAGE_PRESS) {
+            // 下一次检查立即松开
+            hid_->release_key(KeyboardBitmap::getKeyAt(entry.key_bit));
+            state.key_pressed = false;
+            state.stage = TOUCH_KEYBOARD_TRIGGLE_STAGE_RELEASE;
+            touch_dispatch_release_next_ &= ~bit;
         } else {
-            // 区域不匹配，释放按键并重置触发阶段
-            if (__builtin_expect(mapping.key_pressed, 0)) {
-                hid_->release_key(mapping.key);
-                mapping.key_pressed = false;
+            // RELEASE 状态下不触发，等待离开区域后重置为 NONE
+            state.key_pressed = false;
+        }
+    } else {
+        // 正常模式：满足条件就按下按键（持续触发）
+        if (touch_keyboard_hold_satisfied_cache_) {
+            if (!state.key_pressed) {
+                hid_->press_key(KeyboardBitmap::getKeyAt(entry.key_bit));
+                state.key_pressed = true;
             }
-            mapping.has_triggered = TOUCH_KEYBOARD_TRIGGLE_STAGE_NONE;
-            mapping.press_timestamp = 0;
+            touch_dispatch_waiting_ &= ~bit;
+        } else {
+            touch_dispatch_waiting_ |= bit;
         }
     }
 }
@@ -830,6 +967,7 @@ void InputManager::task0()
     processSensitivityRequests();
     
     // 更新所有设备的触摸状态
+    updateFrameTimer();
     updateTouchStates();
 
     mai2_serial_->task();
@@ -838,9 +976,19 @@ void InputManager::task0()
     if (calibration_request_pending_ != CalibrationRequestType::IDLE)
         processCalibrationRequest();
 
+    // 保存已停止的触摸轨迹
+    if (touch_trace_.save_pending())
+        touch_trace_.save();
+
+    // 处理延迟统计请求
+    if (latency_dump_pending_ || latency_reset_pending_)
+        processTouchLatencyRequests();
+    if (telemetry_dump_pending_ || telemetry_reset_pending_)
+        processTouchTelemetryRequests();
+
+    // 校准期间照常输出：传感器自行屏蔽仍在校准的通道
     if (calibration_in_progress_) {
         getCalibrationProgress();
-        return;
     }
     
     // 处理绑定状态
@@ -868,8 +1016,27 @@ void InputManager::task0()
 // CPU1核心循环 - 键盘处理和HID发送
 void InputManager::task1()
 {
-    updateGPIOStates();
-    processGPIOKeyboard(); // 物理键盘按键变化检测并直接发送HID
+    if (keyboard_dispatch_dirty_)
+    {
+        keyboard_dispatch_dirty_ = false;
+        compileKeyboardDispatch();
+    }
+    // 模式切换或映射引脚变化后重新配置边沿中断 (中断注册在Core1，处理函数也在Core1执行)
+    if (gpio_irq_active_ != config_->gpio_irq_mode ||
+        (gpio_irq_active_ && gpio_irq_inputs_ != gpio_mapped_inputs_))
+    {
+        applyGPIOIRQMode();
+    }
+
+    if (gpio_irq_active_)
+    {
+        processGPIOEdgeEvents(); // 按边沿事件顺序处理，不再每轮读取SPI
+    }
+    else
+    {
+        updateGPIOStates();
+        processGPIOKeyboard(); // 物理键盘按键变化检测并直接发送HID
+    }
 
     switch (config_->work_mode)
     {
@@ -886,6 +1053,15 @@ void InputManager::task1()
             break;
     }
     hid_->task();
+
+    if (touch_raw_stream_.is_active())
+    {
+        USB_SerialLogs* logs = USB_SerialLogs::get_global_instance();
+        if (logs)
+        {
+            touch_raw_stream_.drain(*logs);
+        }
+    }
 }
 
 // 开始Serial绑定
@@ -998,7 +1174,7 @@ void InputManager::requestCancelBinding()
 void InputManager::setSensitivity(uint8_t device_id_mask, uint8_t channel, int8_t sensitivity)
 {
     // 将请求推送到环形缓冲区，由task0处理
-    if (sensitivity_request_buffer_.pushRequest(device_id_mask, channel, sensitivity))
+    if (sensitivity_request_buffer_.push(SensitivityRequest(device_id_mask, channel, sensitivity)))
     {
         log_debug("setSensitivity: pushed request to buffer - device_id_mask=" + std::to_string(device_id_mask) +
                   " channel=" + std::to_string(channel) +
@@ -1043,6 +1219,7 @@ void InputManager::setSerialMapping(uint8_t device_id_mask, uint8_t channel, Mai
     {
         // 反向映射：区域 -> 通道，使用32位物理通道地址，索引0-33对应区域1-34
         static_config_.area_channel_mappings.serial_mappings[area - 1].channel = encodePhysicalChannelAddress(device_id_mask, 1 << channel);
+        serial_area_table_dirty_ = true;
     }
 }
 
@@ -1053,7 +1230,7 @@ void InputManager::setHIDMapping(uint8_t device_id_mask, uint8_t channel, float
 
     // 查找是否已有该通道的映射
     int target_index = -1;
-    for (int i = 0; i < 10; i++)
+    for (int i = 0; i < MAX_HID_AREA_MAPPINGS; i++)
     {
         if (static_config_.area_channel_mappings.hid_mappings[i].channel == physical_address)
         {
@@ -1065,7 +1242,7 @@ void InputManager::setHIDMapping(uint8_t device_id_mask, uint8_t channel, float
     // 如果没有找到，寻找空闲位置
     if (target_index == -1)
     {
-        for (int i = 0; i < 10; i++)
+        for (int i = 0; i < MAX_HID_AREA_MAPPINGS; i++)
         {
             if (static_config_.area_channel_mappings.hid_mappings[i].channel == 0xFFFFFFFF)
             {
@@ -1080,6 +1257,7 @@ void InputManager::setHIDMapping(uint8_t device_id_mask, uint8_t channel, float
     {
         static_config_.area_channel_mappings.hid_mappings[target_index].channel = physical_address;
         static_config_.area_channel_mappings.hid_mappings[target_index].coordinates = {x, y};
+        hid_coord_table_dirty_ = true;
     }
 }
 
@@ -1101,7 +1279,7 @@ TouchAxis InputManager::getHIDMapping(uint8_t device_id_mask, uint8_t channel)
 {
     // 反向查找：通过通道找到对应的HID坐标
     uint32_t physical_address = encodePhysicalChannelAddress(device_id_mask, 1 << channel);
-    for (int i = 0; i < 10; i++)
+    for (int i = 0; i < MAX_HID_AREA_MAPPINGS; i++)
     {
         if (static_config_.area_channel_mappings.hid_mappings[i].channel == physical_address)
         {
@@ -1245,7 +1423,7 @@ void InputManager::setSerialAreaSensitivity(Mai2_TouchArea area, int8_t sensitiv
 
 void InputManager::setHIDAreaSensitivity(uint8_t hid_area_index, uint8_t sensitivity)
 {
-    if (hid_area_index >= 10)
+    if (hid_area_index >= MAX_HID_AREA_MAPPINGS)
         return;
 
     // 遍历所有设备映射，找到对应的HID区域
@@ -1355,6 +1533,7 @@ void InputManager::clearSerialMappings()
     {
         static_config_.area_channel_mappings.serial_mappings[area_idx].channel = 0xFFFFFFFF; // 0xFFFFFFFF表示未映射
     }
+    serial_area_table_dirty_ = true;
     
     log_info("Serial mappings cleared");
 }
@@ -1416,33 +1595,213 @@ void InputManager::updateChannelStatesAfterBinding()
 inline void InputManager::updateTouchStates()
 {
     static TouchSensor* _target_device = nullptr;
+    const uint32_t now_us = time_us_32();
 
-    // 遍历每个I2C总线，进行阶段性采样
+    // 遍历每个I2C总线，每条总线同一时刻只有一个设备在采样
     for (uint8_t bus = 0; bus < 2; bus++) {
+        I2C_SamplingStage& stages = i2c_sampling_stages_[bus];
         
         // 如果当前阶段被锁定（正在采样中），跳过
-        if (i2c_sampling_stages_[bus].stage_locked) {
+        if (stages.stage_locked) {
             continue;
         }
         
-        // 获取当前阶段的设备实例
-        _target_device = i2c_sampling_stages_[bus].device_instances[i2c_sampling_stages_[bus].current_stage];
-        if (_target_device == nullptr) {
-            i2c_sampling_stages_[bus].next_stage();
+        const int8_t stage = selectSamplingStage(bus, now_us);
+        if (stage < 0) {
             continue;
         }
+        stages.current_stage = static_cast<uint8_t>(stage);
+        _target_device = stages.device_instances[stage];
+        TouchDeviceTiming& timing = device_timing_[stages.device_indices[stage]];
         
-        // 检查当前设备是否准备好采样
-        if (!_target_device->sample_ready()) {
+        TouchDeviceTelemetry& telemetry = device_telemetry_[stages.device_indices[stage]];
+        
+        // 检查当前设备是否准备好采样；未就绪时短暂退避，期间总线可以让给同总线的其它设备
+        const uint32_t poll_us = time_us_32();
+        bool polled = false;
+        if (!touchDeviceReady(stages.device_indices[stage], _target_device, now_us, polled)) {
+            const uint32_t polled_us = time_us_32();
+            if (polled) {
+                telemetry.window_busy_us += polled_us - poll_us;
+            }
+            timing.not_ready_polls++;
+            timing.waited = true;
+            timing.next_poll_us = polled_us + SAMPLING_MIN_POLL_BACKOFF_US;
             continue;
         }
+        if (timing.samples && timing.failures == 0) {
+            // 等待过才能确定就绪时刻；首次查询即就绪只说明实际间隔更短，估计值向下收敛
+            uint32_t ready_us = std::min<uint32_t>(now_us - timing.done_us, UINT16_MAX);
+            if (!timing.waited) {
+                ready_us = std::min<uint32_t>(ready_us, timing.ready_us - timing.ready_us / 4);
+            }
+            timing.ready_us = static_cast<uint16_t>(timing.ready_us + (static_cast<int32_t>(ready_us) - timing.ready_us) / 8);
+        }
         
         // 锁定当前阶段并发起异步采样
-        i2c_sampling_stages_[bus].stage_locked = true;
+        stages.stage_locked = true;
+        touch_int_ready_[stages.device_indices[stage]] = false;
+        timing.issue_us = time_us_32();
+        telemetry.window_busy_us += timing.issue_us - poll_us;
         _target_device->sample(InputManager::async_touchsampleresult);
     }
 }
 
+// 就绪判断：INT设备只看中断标志与引脚电平 (不占用总线)，INT长时间无响应 (引脚未接/配置错误) 时退回I2C查询
+// 引脚仍为低电平也视为就绪，发起采样清除标志之后、状态读取之前完成的转换不会丢失
+// 连续TOUCH_INT_FALLBACK_LIMIT次都由查询发现就绪时INT视为失效，该设备锁定为轮询，不再每帧等满回退窗口
+inline bool InputManager::touchDeviceReady(uint8_t device_index, TouchSensor* device, uint32_t now_us, bool& polled)
+{
+    const uint8_t pin = touch_int_pins_[device_index];
+    if (pin != 0xFF) {
+        if (touch_int_ready_[device_index] || !gpio_get(pin)) {
+            touch_int_fallbacks_[device_index] = 0;
+            return true;
+        }
+        if (static_cast<int32_t>(now_us - device_timing_[device_index].done_us) < TOUCH_INT_FALLBACK_US) {
+            return false;
+        }
+    }
+    polled = true;
+    const bool ready = device->sample_ready();
+    if (pin != 0xFF && ready && ++touch_int_fallbacks_[device_index] >= TOUCH_INT_FALLBACK_LIMIT) {
+        latchTouchDevicePolling(device_index, device);
+    }
+    return ready;
+}
+
+// INT失效锁定：摘除该设备的INT引脚，之后按普通轮询设备调度；重新执行setupTouchReadyInterrupts时解除
+void InputManager::latchTouchDevicePolling(uint8_t device_index, TouchSensor* device)
+{
+    const uint8_t pin = touch_int_pins_[device_index];
+    touch_int_pins_[device_index] = 0xFF;
+    touch_int_ready_[device_index] = false;
+    touch_int_fallbacks_[device_index] = 0;
+    touch_int_pin_mask_ &= ~(1u << pin);
+    gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, false);
+    log_warning("INT pin GPIO" + std::to_string(pin) + " of " + device->getDeviceName() + " stopped responding, polling instead");
+}
+
+/**
+ * 选择总线上下一个采样的阶段 (不产生I2C访问)
+ * 预计尚未就绪 (按实测就绪间隔) 或处于失败退避中的设备不参与选择，不再对未就绪设备反复做阻塞的就绪查询。
+ * 本帧尚未上报的设备优先 (其中就绪间隔长的先采)，其次是距上次完成最久的设备，同分时从上次选中的阶段之后轮转；
+ * 但同总线还有正常设备在等就绪时，随时可采的待采设备推迟到它之后，让帧以最新的采样收尾。
+ * 已上报的设备只在重采样能赶在待采设备就绪前完成时才发起，事务不可打断，避免推迟整帧。
+ */
+inline int8_t InputManager::selectSamplingStage(uint8_t bus, uint32_t now_us) const
+{
+    const I2C_SamplingStage& stages = i2c_sampling_stages_[bus];
+    int8_t best_stage = -1;
+    uint32_t best_score = 0;
+    int32_t pending_slack_us = INT32_MAX;  // 最早的待采设备距就绪的时间
+    bool pending_waiting = false;          // 有未失败的待采设备在等就绪
+    for (uint8_t n = 1; n <= 4; n++) {
+        const uint8_t stage = (stages.current_stage + n) & 3;
+        const uint8_t index = stages.device_indices[stage];
+        if (index == 0xFF || stages.device_instances[stage] == nullptr) {
+            continue;
+        }
+        const TouchDeviceTiming& timing = device_timing_[index];
+        int32_t wait_us = static_cast<int32_t>(timing.next_poll_us - now_us);
+        const bool pending = !(device_completed_bitmap_ & (1u << index));
+        // INT已报告就绪时不必等到预计就绪点 (失败退避仍然生效)
+        if (wait_us > 0 && touch_int_ready_[index] && timing.failures == 0) {
+            wait_us = 0;
+        }
+        if (wait_us > 0) {
+            if (pending) {
+                // 预计就绪时刻 (提前查询点之后仍可能未就绪)
+                const int32_t ready_wait_us = std::max<int32_t>(wait_us, static_cast<int32_t>(timing.done_us + timing.ready_us - now_us));
+                pending_slack_us = std::min(pending_slack_us, ready_wait_us);
+                pending_waiting |= (timing.failures == 0);
+            }
+            continue;
+        }
+        // 待采设备中就绪间隔长的先采 (刚就绪的慢设备不能再被快设备插队)，其余按距上次完成的时间
+        const uint32_t age_us = now_us - timing.done_us;
+        uint32_t score = pending
+            ? (0x80000000u | (static_cast<uint32_t>(timing.ready_us >> 1) << 16) | std::min<uint32_t>(age_us, 0xFFFF))
+            : std::min<uint32_t>(age_us, 0x7FFFFFFE) + 1;
+        if (score > best_score) {
+            best_score = score;
+            best_stage = static_cast<int8_t>(stage);
+        }
+    }
+    if (best_stage < 0) {
+        return -1;
+    }
+    if (best_score & 0x80000000u) {
+        return pending_waiting ? -1 : best_stage;
+    }
+    return device_timing_[stages.device_indices[best_stage]].cost_us > pending_slack_us ? -1 : best_stage;
+}
+
+// 采样完成/失败时更新设备代价统计 (I2C完成中断中调用，总线锁定期间线程侧不访问该设备)
+inline void InputManager::recordSampleTiming(uint8_t device_index, bool success, uint32_t now_us)
+{
+    TouchDeviceTiming& timing = device_timing_[device_index];
+    TouchDeviceTelemetry& telemetry = device_telemetry_[device_index];
+    const uint32_t cost_us = std::min<uint32_t>(now_us - timing.issue_us, UINT16_MAX);
+    telemetry.window_transactions++;
+    telemetry.window_cost_us += cost_us;
+    telemetry.window_busy_us += cost_us;
+    if (cost_us > telemetry.max_cost_us) {
+        telemetry.max_cost_us = static_cast<uint16_t>(cost_us);
+    }
+    if (success) {
+        telemetry.window_samples++;
+        timing.cost_us = timing.samples
+            ? static_cast<uint16_t>(timing.cost_us + (static_cast<int32_t>(cost_us) - timing.cost_us) / 8)
+            : static_cast<uint16_t>(cost_us);
+        timing.samples++;
+        timing.failures = 0;
+        timing.waited = false;
+        timing.done_us = now_us;
+        timing.next_poll_us = now_us + timing.ready_us - timing.ready_us / 8;
+        return;
+    }
+    // 连续失败时指数退避，NACK的设备不再独占总线
+    timing.failure_total++;
+    timing.waited = false;
+    if (timing.failures < UINT8_MAX) {
+        timing.failures++;
+    }
+    uint32_t backoff_us = 0;
+    if (timing.failures >= SAMPLING_FAILURE_THRESHOLD) {
+        const uint8_t shift = std::min<uint8_t>(timing.failures - SAMPLING_FAILURE_THRESHOLD, 7);
+        backoff_us = std::min<uint32_t>(SAMPLING_FAILURE_BACKOFF_US << shift, SAMPLING_MAX_BACKOFF_US);
+    }
+    timing.next_poll_us = now_us + backoff_us;
+}
+
+void InputManager::resetSamplingSchedule()
+{
+    const uint32_t now_us = time_us_32();
+    memset(device_timing_, 0, sizeof(device_timing_));
+    memset(device_telemetry_, 0, sizeof(device_telemetry_));
+    memset(i2c_bus_busy_permille_, 0, sizeof(i2c_bus_busy_permille_));
+    telemetry_window_start_us_ = now_us;
+    for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++) {
+        device_timing_[i].next_poll_us = now_us;
+    }
+}
+
+uint32_t InputManager::getI2CBusFrameCost(uint8_t i2c_bus) const
+{
+    if (i2c_bus >= 2) {
+        return 0;
+    }
+    uint32_t cost_us = 0;
+    for (uint8_t stage = 0; stage < 4; stage++) {
+        const uint8_t index = i2c_sampling_stages_[i2c_bus].device_indices[stage];
+        if (index != 0xFF) {
+            cost_us += device_timing_[index].cost_us;
+        }
+    }
+    return cost_us;
+}
+
 // 处理自动校准控制 - 根据mai2serial发送状态控制AD7147设备的自动校准
 inline void InputManager::updateAutoCalibrationControl()
 {
@@ -1460,69 +1819,48 @@ inline void InputManager::updateAutoCalibrationControl()
 }
 
 // 发送HID触摸数据 - 使用32位TouchSensor接口的统一实现
-inline void InputManager::sendHIDTouchData()
+void InputManager::sendHIDTouchData()
 {
     InputManager_PrivateConfig *config = inputmanager_get_config_holder();
-
-    // 预计算32位触摸设备映射指针数组，避免重复查找
-    TouchDeviceMapping *touch_mappings[8] = {nullptr};
     const int touch_device_count = config->device_count;
 
-    // 预处理32位触摸设备映射，建立快速查找表
-    for (int i = 0; i < touch_device_count; i++)
+    if (hid_coord_table_dirty_)
     {
-        const uint32_t device_id_mask = touch_device_states_[i].current_touch_mask;
-        touch_mappings[i] = findTouchDeviceMapping(device_id_mask);
+        rebuildHIDCoordTable();
     }
 
-    // 处理所有32位触摸设备的HID数据
+    // Core0发布的完整帧快照
+    static TouchFrameSnapshot frame;
+    frame = touch_frame_.load();
+
     for (int i = 0; i < touch_device_count; i++)
     {
-        const TouchDeviceMapping *mapping = touch_mappings[i];
-        if (!mapping)
-            continue;
-
-        const uint32_t current_touch_mask = touch_device_states_[i].current_touch_mask;
+        const uint32_t current_touch_mask = frame.touch_masks[i];
         if (!current_touch_mask)
             continue; // 无触摸数据
 
-        const uint8_t max_channels = mapping->max_channels;
+        // 按模块掩码定位编译表行
+        const uint8_t module_mask = current_touch_mask >> 24;
+        uint8_t row = 0;
+        while (row < hid_coord_module_count_ && hid_coord_modules_[row] != module_mask) row++;
+        if (row == hid_coord_module_count_)
+            continue;
 
-        // 使用位运算快速处理所有可用通道
-        for (uint8_t ch = 0; ch < max_channels && ch < 32; ch++)
+        // 只遍历被按下且已映射坐标的通道
+        uint32_t pressed = current_touch_mask & hid_coord_valid_[row];
+        while (pressed)
         {
-            const uint32_t ch_mask = (1UL << ch);
-            if (!(current_touch_mask & ch_mask))
-                continue;
-
-            // 检查是否有有效HID映射 - 使用反向映射查找
-            TouchAxis hid_area = {0.0f, 0.0f};
-            // 生成当前通道的32位物理地址
-            uint32_t physical_address = encodePhysicalChannelAddress(mapping->device_id_mask, 1 << ch);
-            // 查找该通道对应的HID坐标
-            for (const auto &hid_mapping : static_config_.area_channel_mappings.hid_mappings)
-            {
-                if (hid_mapping.channel == physical_address)
-                {
-                    hid_area = hid_mapping.coordinates;
-                    break;
-                }
-            }
-            if (hid_area.x == 0.0f && hid_area.y == 0.0f)
-                continue;
+            const uint8_t ch = __builtin_ctz(pressed);
+            pressed &= pressed - 1;
+            const uint32_t coord = hid_coord_table_[row][ch];
 
             // 计算唯一的触摸点ID：设备索引(3位) + 通道号(6位)
             // 支持最多8个设备，每个设备64个通道
-            uint8_t unique_contact_id = ((i & 0x07) << 6) | (ch & 0x3F);
-
-            // 创建触摸点报告
             HID_TouchPoint touch_point;
             touch_point.press = true;
-            touch_point.id = unique_contact_id;
-
-            // 转换坐标到HID范围 (0-65535)
-            touch_point.x = (uint16_t)(hid_area.x * 65535.0f);
-            touch_point.y = (uint16_t)(hid_area.y * 65535.0f);
+            touch_point.id = ((i & 0x07) << 6) | (ch & 0x3F);
+            touch_point.x = (uint16_t)(coord >> 16);
+            touch_point.y = (uint16_t)(coord & 0xFFFF);
 
             // 发送触摸点
             if (hid_)
@@ -1533,6 +1871,51 @@ inline void InputManager::sendHIDTouchData()
     }
 }
 
+// 由hid_mappings重建HID坐标编译表 (task1，映射变化后首次发送前调用)
+void InputManager::rebuildHIDCoordTable()
+{
+    hid_coord_table_dirty_ = false;
+    hid_coord_module_count_ = 0;
+
+    for (uint16_t i = 0; i < MAX_HID_AREA_MAPPINGS; i++)
+    {
+        const auto &hid_mapping = static_config_.area_channel_mappings.hid_mappings[i];
+        if (hid_mapping.channel == 0xFFFFFFFF)
+            continue;
+        // 坐标(0,0)视为未设置
+        if (hid_mapping.coordinates.x == 0.0f && hid_mapping.coordinates.y == 0.0f)
+            continue;
+
+        const uint8_t module_mask = hid_mapping.channel >> 24;
+        const uint32_t channel_bits = hid_mapping.channel & 0x00FFFFFF;
+        // 只有单通道地址能被触点命中
+        if (channel_bits == 0 || (channel_bits & (channel_bits - 1)) != 0)
+            continue;
+
+        uint8_t row = 0;
+        while (row < hid_coord_module_count_ && hid_coord_modules_[row] != module_mask) row++;
+        if (row == hid_coord_module_count_)
+        {
+            if (row >= MAPPING_TABLE_DEVICES)
+                continue;
+            hid_coord_modules_[row] = module_mask;
+            hid_coord_valid_[row] = 0;
+            hid_coord_module_count_++;
+        }
+
+        // 转换坐标到HID范围 (0-65535)，运行时不再做浮点运算
+        const uint8_t ch = __builtin_ctz(channel_bits);
+        const uint16_t x = (uint16_t)(hid_mapping.coordinates.x * 65535.0f);
+        const uint16_t y = (uint16_t)(hid_mapping.coordinates.y * 65535.0f);
+        // 同一通道存在多条映射时保留第一条，与原先的线性查找一致
+        if (!(hid_coord_valid_[row] & (1UL << ch)))
+        {
+            hid_coord_table_[row][ch] = ((uint32_t)x << 16) | y;
+            hid_coord_valid_[row] |= (1UL << ch);
+        }
+    }
+}
+
 // 地址转设备编号 0-N
 int32_t InputManager::findTouchDeviceIndex(uint8_t device_id_mask)
 {
@@ -1586,11 +1969,19 @@ void inputmanager_register_default_configs(config_map_t &default_map)
     default_map[INPUTMANAGER_RATE_LIMIT_ENABLED] = ConfigValue(false);        // 默认关闭频率限制
     default_map[INPUTMANAGER_RATE_LIMIT_FREQUENCY] = ConfigValue((uint16_t)120, (uint16_t)10, (uint16_t)1000); // 频率限制，范围10-1000Hz
 
+    // 按键输入模式
+    default_map[INPUTMANAGER_GPIO_IRQ_MODE] = ConfigValue(false);             // 默认轮询
+
+    // 组帧模式
+    default_map[INPUTMANAGER_PARTIAL_FRAME_ENABLED] = ConfigValue(false);     // 默认等待所有设备
+    default_map[INPUTMANAGER_FRAME_STALENESS] = ConfigValue((uint8_t)10, (uint8_t)1, (uint8_t)100); // 新鲜度上限，范围1-100ms
+
     // 阶段分配配置
     default_map[INPUTMANAGER_STAGE_ASSIGNMENTS] = ConfigValue(std::string(""));  // 阶段分配配置
 
     default_map[INPUTMANAGER_TOUCH_DEVICES] = ConfigValue(std::string(""));      // 触摸设备映射数据
     default_map[INPUTMANAGER_PHYSICAL_KEYBOARDS] = ConfigValue(std::string(""));
+    default_map[INPUTMANAGER_PHYSICAL_KEYBOARDS_LEGACY] = ConfigValue(std::string(""));
     default_map[INPUTMANAGER_AREA_CHANNEL_MAPPINGS] = ConfigValue(std::string(""));  // 区域通道映射配置
 }
 
@@ -1600,6 +1991,20 @@ InputManager_PrivateConfig *inputmanager_get_config_holder()
     return &static_config_;
 }
 
+// 旧版本区域映射配置的前缀布局 (HID区域上限10个)，仅用于加载迁移
+#define LEGACY_HID_AREA_MAPPINGS 10
+struct LegacyAreaChannelMappingHeader {
+    AreaChannelMappingConfig::AreaChannelMapping serial_mappings[34];
+    AreaChannelMappingConfig::HIDAreaMapping hid_mappings[LEGACY_HID_AREA_MAPPINGS];
+};
+
+// 旧版本物理键盘映射布局 (无消抖字段)，仅用于加载迁移
+struct LegacyPhysicalKeyboardMapping {
+    uint8_t gpio;
+    HID_KeyCode default_key;
+    GPIOTriggerLevel trigger_level;
+};
+
 // [配置加载函数] - 从ConfigManager加载所有配置到静态配置变量
 bool inputmanager_load_config_from_manager()
 {
@@ -1630,6 +2035,13 @@ bool inputmanager_load_config_from_manager()
     static_config_.rate_limit_enabled = config_mgr->get_bool(INPUTMANAGER_RATE_LIMIT_ENABLED);
     static_config_.rate_limit_frequency = config_mgr->get_uint16(INPUTMANAGER_RATE_LIMIT_FREQUENCY);
     
+    // 加载按键输入模式
+    static_config_.gpio_irq_mode = config_mgr->get_bool(INPUTMANAGER_GPIO_IRQ_MODE);
+    
+    // 加载组帧模式
+    static_config_.partial_frame_enabled = config_mgr->get_bool(INPUTMANAGER_PARTIAL_FRAME_ENABLED);
+    static_config_.frame_staleness_ms = config_mgr->get_uint8(INPUTMANAGER_FRAME_STALENESS);
+    
     // 通过调用设置函数来预计算最小间隔时间，确保复用逻辑
     InputManager* instance = InputManager::getInstance();
     if (instance && static_config_.rate_limit_frequency > 0) {
@@ -1674,7 +2086,27 @@ bool inputmanager_load_config_from_manager()
         static_config_.physical_keyboard_mappings.resize(mapping_count);
         std::memcpy(static_config_.physical_keyboard_mappings.data(),
                     physical_keyboards_str.data(),
-                    physical_keyboards_str.size());
+                    mapping_count * sizeof(PhysicalKeyboardMapping));
+    }
+    else
+    {
+        // 旧版本配置：逐项迁移，消抖取默认值
+        std::string legacy_str = config_mgr->get_string(INPUTMANAGER_PHYSICAL_KEYBOARDS_LEGACY);
+        size_t mapping_count = legacy_str.size() / sizeof(LegacyPhysicalKeyboardMapping);
+        if (mapping_count > 0)
+        {
+            const LegacyPhysicalKeyboardMapping* legacy = reinterpret_cast<const LegacyPhysicalKeyboardMapping*>(legacy_str.data());
+            static_config_.physical_keyboard_mappings.clear();
+            static_config_.physical_keyboard_mappings.resize(mapping_count);
+            for (size_t i = 0; i < mapping_count; i++)
+            {
+                PhysicalKeyboardMapping &mapping = static_config_.physical_keyboard_mappings[i];
+                mapping.gpio = legacy[i].gpio;
+                mapping.default_key = legacy[i].default_key;
+                mapping.trigger_level = legacy[i].trigger_level;
+            }
+            InputManager::log_info("已迁移旧版本物理键盘映射配置");
+        }
     }
 
     // 加载区域通道映射配置
@@ -1684,6 +2116,24 @@ bool inputmanager_load_config_from_manager()
         // 使用拷贝赋值替代memcpy，避免非平凡可复制对象警告
         const AreaChannelMappingConfig* source = reinterpret_cast<const AreaChannelMappingConfig*>(area_mappings_str.data());
         static_config_.area_channel_mappings = *source;
+        serial_area_table_dirty_ = true;
+        hid_coord_table_dirty_ = true;
+    }
+    else if (area_mappings_str.size() >= sizeof(LegacyAreaChannelMappingHeader))
+    {
+        // 旧版本配置 (HID区域上限10个)：迁移Serial映射与前10个HID区域
+        const LegacyAreaChannelMappingHeader* legacy = reinterpret_cast<const LegacyAreaChannelMappingHeader*>(area_mappings_str.data());
+        for (uint8_t area_idx = 0; area_idx < 34; area_idx++)
+        {
+            static_config_.area_channel_mappings.serial_mappings[area_idx] = legacy->serial_mappings[area_idx];
+        }
+        for (uint8_t i = 0; i < LEGACY_HID_AREA_MAPPINGS; i++)
+        {
+            static_config_.area_channel_mappings.hid_mappings[i] = legacy->hid_mappings[i];
+        }
+        serial_area_table_dirty_ = true;
+        hid_coord_table_dirty_ = true;
+        InputManager::log_info("已迁移旧版本区域映射配置");
     }
 
     // 加载阶段分配配置
@@ -1727,13 +2177,15 @@ bool inputmanager_load_config_from_manager()
 void InputManager::get_all_device_status(TouchDeviceStatus *data)
 {
     InputManager_PrivateConfig *config = inputmanager_get_config_holder();
+    // UI运行在Core1，读取Core0发布的帧快照
+    const TouchFrameSnapshot frame = touch_frame_.load();
     for (int i = 0; i < config->device_count; i++)
     {
         // 复制设备映射配置
         data[i].touch_device = config->touch_device_mappings[i];
 
         // 获取当前触摸状态
-        data[i].touch_states_32bit = touch_device_states_[i].current_touch_mask;
+        data[i].touch_states_32bit = frame.touch_masks[i];
 
         // 设置连接状态 - 根据实际连接状态反馈
         data[i].is_connected = config->touch_device_mappings[i].is_connected;
@@ -1811,6 +2263,13 @@ bool inputmanager_write_config_to_manager(const InputManager_PrivateConfig &conf
     config_mgr->set_bool(INPUTMANAGER_RATE_LIMIT_ENABLED, config.rate_limit_enabled);
     config_mgr->set_uint16(INPUTMANAGER_RATE_LIMIT_FREQUENCY, config.rate_limit_frequency);
     
+    // 写入按键输入模式
+    config_mgr->set_bool(INPUTMANAGER_GPIO_IRQ_MODE, config.gpio_irq_mode);
+    
+    // 写入组帧模式
+    config_mgr->set_bool(INPUTMANAGER_PARTIAL_FRAME_ENABLED, config.partial_frame_enabled);
+    config_mgr->set_uint8(INPUTMANAGER_FRAME_STALENESS, config.frame_staleness_ms);
+    
     // 保存Mai2Serial配置
     config_mgr->set_uint32(INPUTMANAGER_MAI2SERIAL_BAUD_RATE, config.mai2serial_config.baud_rate);
 
@@ -1879,6 +2338,9 @@ bool inputmanager_write_config_to_manager(const InputManager_PrivateConfig &conf
 
     // 更新静态配置
     static_config_ = config;
+    serial_area_table_dirty_ = true;
+    hid_coord_table_dirty_ = true;
+    keyboard_dispatch_dirty_ = true;
 
     return true;
 }
@@ -2130,6 +2592,7 @@ void InputManager::updateGPIOStates()
     // 批量读取MCU GPIO状态 - 避免循环，使用硬件寄存器直接读取
     // RP2040 GPIO状态寄存器：SIO_BASE + SIO_GPIO_IN_OFFSET
     mcu_gpio_states_ = sio_hw->gpio_in & 0x3FFFFFFF; // 30位GPIO掩码
+    gpio_sample_time_us_ = time_us_32();
 
     // 读取MCP23S17 GPIO状态
     if (mcp23s17_available_ && mcp23s17_)
@@ -2143,96 +2606,63 @@ void InputManager::processGPIOKeyboard()
     static KeyboardBitmap prev_keyboard_state; // 跟踪上一次的按键状态
     static KeyboardBitmap current_keyboard_state;
 
-    gpio_mcu_changed_ = mcu_gpio_states_ ^ mcu_gpio_previous_states_;
-    gpio_mcp_changed_a_ = mcp_gpio_states_.port_a ^ mcp_gpio_previous_states_.port_a;
-    gpio_mcp_changed_b_ = mcp_gpio_states_.port_b ^ mcp_gpio_previous_states_.port_b;
+    // 合并MCU与MCP输入为同一输入字，与上一次异或得到变化位 (只关心存在映射的引脚)
+    const uint64_t inputs = combineGPIOInputs(mcu_gpio_states_, mcp_gpio_states_);
+    const uint64_t previous_inputs = combineGPIOInputs(mcu_gpio_previous_states_, mcp_gpio_previous_states_);
+
+    mcu_gpio_previous_states_ = mcu_gpio_states_;
+    mcp_gpio_previous_states_ = mcp_gpio_states_;
 
-    // 快速跳过：如果没有GPIO变化则直接返回
-    if (!gpio_mcu_changed_ && !gpio_mcp_changed_a_ && !gpio_mcp_changed_b_)
+    // 快速跳过：已映射引脚无变化且没有进行中的消抖定时
+    if (!((inputs ^ previous_inputs) & gpio_mapped_inputs_) && !gpio_debounce_pending_)
     {
         return;
     }
-    // 仅更新发生变化的键，避免整表重算：先复制上一帧状态
-    current_keyboard_state = prev_keyboard_state;
-
-    // 零内存分配：使用类成员缓存变量获取所有指针和计数
-    gpio_mappings_cache_ = config_->physical_keyboard_mappings.data();
-    gpio_mapping_count_cache_ = config_->physical_keyboard_mappings.size();
 
-    // 预先计算按键“有效状态”（已按下=1）后的整体位图，用于快速读取
-    // MCU：对ACTIVE_LOW映射的位执行异或翻转
-    const uint32_t effective_mcu_states = mcu_gpio_states_ ^ gpio_mcu_inverted_;
-    // MCP：分别处理A/B端口的ACTIVE_LOW异或翻转
-    const uint8_t effective_mcp_a = static_cast<uint8_t>(mcp_gpio_states_.port_a) ^ static_cast<uint8_t>(gpio_mcp_inverted_a_ & 0xFF);
-    const uint8_t effective_mcp_b = static_cast<uint8_t>(mcp_gpio_states_.port_b) ^ static_cast<uint8_t>(gpio_mcp_inverted_b_ & 0xFF);
-
-    for (size_t i = 0; i < gpio_mapping_count_cache_; ++i)
+    // 消抖后与上一次上报电平比较，得到需要更新的输入位
+    const uint64_t previous_debounced = gpio_debounced_inputs_;
+    const uint64_t debounced = debounceGPIOInputs(inputs, previous_inputs);
+    uint64_t changed = (debounced ^ previous_debounced) & gpio_mapped_inputs_;
+    if (!changed)
     {
-        gpio_mapping_ptr_cache_ = &gpio_mappings_cache_[i];
-        gpio_pin_cache_ = gpio_mapping_ptr_cache_->gpio;
-        gpio_pin_num_cache_ = get_gpio_pin_number(gpio_pin_cache_);
+        return;
+    }
 
-        // 使用位运算快速判断GPIO类型；根据变化位图仅处理发生变化的引脚
-        if ((gpio_pin_cache_ & 0xC0) == 0x00)
-        { // MCU GPIO
-            if (((gpio_mcu_changed_ >> gpio_pin_num_cache_) & 1) == 0) {
-                continue; // 未变化，跳过
-            }
-            gpio_current_state_cache_ = (effective_mcu_states >> gpio_pin_num_cache_) & 1;
-        }
-        else
-        { // MCP GPIO
-            if (gpio_pin_num_cache_ <= 8)
-            { // PORTA
-                gpio_bit_pos_cache_ = gpio_pin_num_cache_ - 1;
-                if (((gpio_mcp_changed_a_ >> gpio_bit_pos_cache_) & 1) == 0) {
-                    continue; // 未变化，跳过
-                }
-                gpio_current_state_cache_ = (effective_mcp_a >> gpio_bit_pos_cache_) & 1;
-            }
-            else
-            { // PORTB
-                gpio_bit_pos_cache_ = gpio_pin_num_cache_ - 9;
-                if (((gpio_mcp_changed_b_ >> gpio_bit_pos_cache_) & 1) == 0) {
-                    continue; // 未变化，跳过
-                }
-                gpio_current_state_cache_ = (effective_mcp_b >> gpio_bit_pos_cache_) & 1;
-            }
-        }
+    // 按键"有效状态"（已按下=1）：对ACTIVE_LOW映射的位执行异或翻转
+    const uint64_t effective_inputs = debounced
+        ^ (gpio_mcu_inverted_
+           | (static_cast<uint64_t>(gpio_mcp_inverted_a_ & 0xFF) << 32)
+           | (static_cast<uint64_t>(gpio_mcp_inverted_b_ & 0xFF) << 40));
 
-        // 普通键盘处理：根据当前状态设置或清除按键
-        if (gpio_mapping_ptr_cache_->default_key != HID_KeyCode::KEY_NONE)
-        {
-            current_keyboard_state.setKey(gpio_mapping_ptr_cache_->default_key, gpio_current_state_cache_);
-        }
-        // 逻辑键处理：将关联的逻辑键同步为当前状态
-        if (gpio_logical_mappings_cache_ && gpio_logical_count_cache_)
+    // 仅更新发生变化的引脚：按分发表区间置位/清除该引脚对应的按键位
+    current_keyboard_state = prev_keyboard_state;
+    while (changed)
+    {
+        const uint8_t bit = __builtin_ctzll(changed);
+        changed &= changed - 1;
+        const uint64_t pressed = 0 - ((effective_inputs >> bit) & 1);  // 按下时全1，释放时全0
+        const uint8_t end = gpio_dispatch_offsets_[bit + 1];
+        for (uint8_t e = gpio_dispatch_offsets_[bit]; e < end; e++)
         {
-            for (size_t j = 0; j < gpio_logical_count_cache_; ++j)
-            {
-                if (gpio_logical_mappings_cache_[j].gpio_id == gpio_pin_cache_)
-                {
-                    gpio_keys_ptr_cache_ = gpio_logical_mappings_cache_[j].keys;
-                    if (gpio_keys_ptr_cache_[0] != HID_KeyCode::KEY_NONE)
-                        current_keyboard_state.setKey(gpio_keys_ptr_cache_[0], gpio_current_state_cache_);
-                    if (gpio_keys_ptr_cache_[1] != HID_KeyCode::KEY_NONE)
-                        current_keyboard_state.setKey(gpio_keys_ptr_cache_[1], gpio_current_state_cache_);
-                    if (gpio_keys_ptr_cache_[2] != HID_KeyCode::KEY_NONE)
-                        current_keyboard_state.setKey(gpio_keys_ptr_cache_[2], gpio_current_state_cache_);
-                    break;
-                }
-            }
+            const uint8_t key_bit = gpio_dispatch_entries_[e].key_bit;
+            uint64_t &word = current_keyboard_state.bitmap[key_bit >> 6];
+            const uint64_t key_mask = 1ULL << (key_bit & 63);
+            word = (word & ~key_mask) | (key_mask & pressed);
         }
     }
 
-    // 直接对比变化并通过HID发送按键按下/释放，避免额外聚合开销
+    // 两帧位图异或得到变化位，只遍历发生变化的按键发送按下/释放
     if (hid_) {
-        for (uint8_t i = 0; i < SUPPORTED_KEYS_COUNT; i++) {
-            HID_KeyCode key = supported_keys[i];
-            bool curr = current_keyboard_state.getKey(key);
-            bool prev = prev_keyboard_state.getKey(key);
-            if (curr != prev) {
-                if (curr) {
+        for (uint8_t w = 0; w < 2; w++) {
+            uint64_t key_changed = current_keyboard_state.bitmap[w] ^ prev_keyboard_state.bitmap[w];
+            if (w == 0) {
+                key_changed &= ~1ULL;  // bit 0 为KEY_NONE/不支持键码的占位
+            }
+            while (key_changed) {
+                const uint8_t key_bit = __builtin_ctzll(key_changed);
+                key_changed &= key_changed - 1;
+                const HID_KeyCode key = KeyboardBitmap::getKeyAt((w << 6) | key_bit);
+                if ((current_keyboard_state.bitmap[w] >> key_bit) & 1) {
                     hid_->press_key(key);
                 } else {
                     hid_->release_key(key);
@@ -2245,40 +2675,392 @@ void InputManager::processGPIOKeyboard()
     gpio_keyboard_bitmap_ = current_keyboard_state;
     // 更新上一次状态（用于下一次变化计算）
     prev_keyboard_state = current_keyboard_state;
-    mcu_gpio_previous_states_ = mcu_gpio_states_;
-    mcp_gpio_previous_states_ = mcp_gpio_states_;
 }
 
-// 基于当前物理键盘映射重建MCU/MCP反转位图（ACTIVE_LOW需要位翻转）
-inline void InputManager::rebuildGPIOInversionMasks()
+// 按键消抖：输入为原始电平，返回消抖后的电平。时间以采样时间戳为准，定时到期在下一次调用时结算
+// 即时消抖：电平变化立即上报并锁定debounce_us，锁定结束时电平仍与上报不同则补报并重新锁定
+// 延迟消抖：每次原始边沿重新计时，电平稳定debounce_us后上报，期间回到原电平则取消
+inline uint64_t InputManager::debounceGPIOInputs(uint64_t inputs, uint64_t previous_inputs)
 {
+    const uint32_t now = gpio_sample_time_us_;
+    uint64_t debounced = gpio_debounced_inputs_;
+    uint64_t restart = 0;
+
+    // 结算到期定时：到期时刻的电平即上一次采样的电平
+    uint64_t pending = gpio_debounce_pending_;
+    while (pending)
+    {
+        const uint8_t bit = __builtin_ctzll(pending);
+        pending &= pending - 1;
+        if (static_cast<int32_t>(now - gpio_debounce_deadline_[bit]) < 0)
+            continue;
+        const uint64_t mask = 1ULL << bit;
+        gpio_debounce_pending_ &= ~mask;
+        if ((previous_inputs ^ debounced) & mask)
+        {
+            debounced ^= mask;
+            restart |= mask & gpio_debounce_eager_;
+        }
+    }
+
+    const uint64_t diff = (inputs ^ debounced) & gpio_mapped_inputs_;
+    const uint64_t debounce_bits = gpio_debounce_eager_ | gpio_debounce_defer_;
+    // 不消抖的输入位直接跟随
+    debounced ^= diff & ~debounce_bits;
+    // 即时消抖：锁定期外的变化立即上报
+    const uint64_t eager_accept = diff & gpio_debounce_eager_ & ~gpio_debounce_pending_;
+    debounced ^= eager_accept;
+    restart |= eager_accept;
+    // 延迟消抖：回到上报电平则取消等待；与上报电平不同且出现新边沿 (或尚未计时) 时重新计时
+    gpio_debounce_pending_ &= ~(gpio_debounce_defer_ & ~diff);
+    restart |= diff & gpio_debounce_defer_ & ((inputs ^ previous_inputs) | ~gpio_debounce_pending_);
+
+    gpio_debounce_pending_ |= restart;
+    while (restart)
+    {
+        const uint8_t bit = __builtin_ctzll(restart);
+        restart &= restart - 1;
+        gpio_debounce_deadline_[bit] = now + gpio_debounce_us_[bit];
+    }
+
+    gpio_debounced_inputs_ = debounced;
+    return debounced;
+}
+
+// 按配置与当前映射使能/关闭边沿中断；中断在调用核上生效，因此只能在Core1 (task1) 中调用
+void InputManager::applyGPIOIRQMode()
+{
+    const uint64_t inputs = config_->gpio_irq_mode ? gpio_mapped_inputs_ : 0;
+    const uint32_t mcu_before = static_cast<uint32_t>(gpio_irq_inputs_) & 0x3FFFFFFF;
+    const uint32_t mcu_after = static_cast<uint32_t>(inputs) & 0x3FFFFFFF;
+
+    // MCU引脚：按差异增减双边沿中断
+    uint32_t removed = mcu_before & ~mcu_after;
+    while (removed)
+    {
+        const uint8_t pin = __builtin_ctz(removed);
+        removed &= removed - 1;
+        gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+    }
+    uint32_t added = mcu_after & ~mcu_before;
+    while (added)
+    {
+        const uint8_t pin = __builtin_ctz(added);
+        added &= added - 1;
+        gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpioIRQHandler);
+    }
+
+    // MCP：接入INT线时改为输入变化中断，读取GPIO寄存器即清除中断
+    if (mcp23s17_available_ && mcp23s17_ && mcp_int_pin_ < 30)
+    {
+        const uint8_t mcp_a = static_cast<uint8_t>(inputs >> 32);
+        const uint8_t mcp_b = static_cast<uint8_t>(inputs >> 40);
+        if (mcp_a | mcp_b)
+        {
+            mcp23s17_->enable_change_interrupt(mcp_a, mcp_b);
+            gpio_init(mcp_int_pin_);
+            gpio_pull_up(mcp_int_pin_);
+            gpio_set_irq_enabled_with_callback(mcp_int_pin_, GPIO_IRQ_EDGE_FALL, true, &gpioIRQHandler);
+        }
+        else if (gpio_irq_inputs_ >> 32)
+        {
+            gpio_set_irq_enabled(mcp_int_pin_, GPIO_IRQ_EDGE_FALL, false);
+            mcp23s17_->disable_change_interrupt();
+        }
+    }
+
+    gpio_irq_inputs_ = inputs;
+    gpio_irq_active_ = config_->gpio_irq_mode;
+    // 切换后先整体采样一次作为基准，之后由边沿事件推进
+    gpio_edge_overflow_ = true;
+}
+
+void InputManager::gpioIRQHandler(unsigned int gpio, uint32_t events)
+{
+    (void)events;
+    InputManager* self = getInstance();
+    // 触摸INT引脚 (Core0) 只置位就绪标志，采样由task0发起
+    if (gpio < 30 && (self->touch_int_pin_mask_ & (1u << gpio)))
+    {
+        for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++)
+        {
+            if (self->touch_int_pins_[i] == gpio)
+            {
+                self->touch_int_ready_[i] = true;
+            }
+        }
+        return;
+    }
+    self->onGPIOEdge(static_cast<uint8_t>(gpio));
+}
+
+// 按设备映射使能触摸就绪中断；中断在调用核上生效，因此只能在Core0 (start) 中调用
+// 引脚与按键/MCP INT冲突或设备不支持时该设备保持轮询
+void InputManager::setupTouchReadyInterrupts()
+{
+    uint32_t previous = touch_int_pin_mask_;
+    while (previous)
+    {
+        const uint8_t pin = __builtin_ctz(previous);
+        previous &= previous - 1;
+        gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, false);
+    }
+    touch_int_pin_mask_ = 0;
+
+    for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++)
+    {
+        TouchSensor* device = (i < touch_sensor_devices_.size()) ? touch_sensor_devices_[i] : nullptr;
+        const TouchDeviceMapping* mapping = device ? findTouchDeviceMapping(device->getModuleMask()) : nullptr;
+        const uint8_t pin = mapping ? mapping->getIntPin() : 0xFF;
+        const bool was_enabled = touch_int_pins_[i] != 0xFF;
+        touch_int_pins_[i] = 0xFF;
+        touch_int_ready_[i] = false;
+        touch_int_fallbacks_[i] = 0;
+        if (pin == 0xFF)
+        {
+            if (was_enabled && device)
+            {
+                device->setReadyInterrupt(false);
+            }
+            continue;
+        }
+
+        const std::string name = device->getDeviceName();
+        if (pin == mcp_int_pin_ || (touch_int_pin_mask_ & (1u << pin)) || (gpio_mapped_inputs_ & (1ULL << pin)))
+        {
+            log_warning("INT pin GPIO" + std::to_string(pin) + " of " + name + " is already in use, polling instead");
+            continue;
+        }
+        if (!device->setReadyInterrupt(true))
+        {
+            log_warning(name + " does not support ready interrupt, polling instead");
+            continue;
+        }
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_up(pin);
+        touch_int_pins_[i] = pin;
+        touch_int_pin_mask_ |= 1u << pin;
+        gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_FALL, true, &gpioIRQHandler);
+        log_info(name + " ready interrupt on GPIO" + std::to_string(pin));
+    }
+}
+
+// 边沿中断：记录时间戳与电平快照。MCU电平直接读SIO；MCP在总线空闲时立即读取 (4字节SPI事务)，
+// 否则留给主循环补读。HID报文不在中断中发送，TinyUSB只在主循环中访问
+void InputManager::onGPIOEdge(uint8_t gpio)
+{
+    GPIOEdgeEvent event;
+    event.timestamp_us = time_us_32();
+    event.mcu_states = sio_hw->gpio_in & 0x3FFFFFFF;
+    if (gpio == mcp_int_pin_ && !mcp23s17_->read_all_gpio_from_isr(gpio_irq_mcp_states_))
+    {
+        mcp_read_pending_ = true;
+    }
+    event.mcp_states = gpio_irq_mcp_states_;
+    if (!gpio_edge_events_.push(event))
+    {
+        gpio_edge_overflow_ = true;
+    }
+}
+
+void InputManager::processGPIOEdgeEvents()
+{
+    // 逐个事件推进输入状态；同一输入位在本轮内再次变化时停止消费，剩余事件留到下一轮，
+    // 保证两次主循环之间的短按也分别发出按下与释放报文，而不是在同一份报文前相互抵消
+    // 消抖锁定/等待中的抖动边沿不改变上报电平，不会打断消费
+    GPIOEdgeEvent event;
+    uint64_t current_inputs = combineGPIOInputs(mcu_gpio_previous_states_, mcp_gpio_previous_states_);
+    uint64_t round_changed = 0;  // 本轮已改变上报电平的输入位
+    while (gpio_edge_events_.peek(event))
+    {
+        const uint64_t inputs = combineGPIOInputs(event.mcu_states, event.mcp_states);
+        if (round_changed)
+        {
+            // 不消抖的输入位再次变化，或消抖定时在该事件前到期，都可能再次改变上报电平
+            bool conflict = ((inputs ^ current_inputs) & round_changed & ~(gpio_debounce_eager_ | gpio_debounce_defer_)) != 0;
+            uint64_t timed = round_changed & gpio_debounce_pending_;
+            while (timed && !conflict)
+            {
+                const uint8_t bit = __builtin_ctzll(timed);
+                timed &= timed - 1;
+                conflict = static_cast<int32_t>(event.timestamp_us - gpio_debounce_deadline_[bit]) >= 0;
+            }
+            if (conflict)
+            {
+                return;
+            }
+        }
+        gpio_edge_events_.pop(event);
+        current_inputs = inputs;
+        mcu_gpio_states_ = event.mcu_states;
+        mcp_gpio_states_ = event.mcp_states;
+        gpio_sample_time_us_ = event.timestamp_us;
+        const uint64_t before = gpio_debounced_inputs_;
+        processGPIOKeyboard();
+        round_changed |= (gpio_debounced_inputs_ ^ before) & gpio_mapped_inputs_;
+    }
+
+    // 补读：队列溢出/刚切换模式、中断时总线被占用、INT线仍为低 (边沿已错过)、未接INT线时MCP退回轮询
+    const bool mcp_inputs = mcp23s17_available_ && mcp23s17_ && (gpio_irq_inputs_ >> 32);
+    const bool mcp_poll = mcp_inputs &&
+        (mcp_int_pin_ >= 30 || mcp_read_pending_ || !gpio_get(mcp_int_pin_));
+    if (!gpio_edge_overflow_ && !mcp_poll)
+    {
+        // 没有新边沿时推进消抖定时 (锁定结束补报、稳定等待到期)
+        if (gpio_debounce_pending_)
+        {
+            gpio_sample_time_us_ = time_us_32();
+            processGPIOKeyboard();
+        }
+        return;
+    }
+    gpio_edge_overflow_ = false;
+    mcp_read_pending_ = false;
+
+    // 关中断完成读取与快照更新，避免与中断侧交错写入gpio_irq_mcp_states_
+    const uint32_t irq_state = save_and_disable_interrupts();
+    if (mcp_inputs)
+    {
+        mcp23s17_->read_all_gpio(gpio_irq_mcp_states_);
+    }
+    mcu_gpio_states_ = sio_hw->gpio_in & 0x3FFFFFFF;
+    mcp_gpio_states_ = gpio_irq_mcp_states_;
+    gpio_sample_time_us_ = time_us_32();
+    restore_interrupts(irq_state);
+    processGPIOKeyboard();
+}
+
+// GPIO编码 -> 编译表输入位；无效引脚返回GPIO_INPUT_BITS
+inline uint8_t InputManager::getGPIOInputBit(uint8_t gpio)
+{
+    const uint8_t pin = get_gpio_pin_number(gpio);
+    if (is_mcu_gpio(gpio))
+    {
+        return pin < 30 ? pin : GPIO_INPUT_BITS;
+    }
+    if (is_mcp_gpio(gpio) && pin >= 1 && pin <= 16)
+    {
+        // MCP引脚编号1-8为Port A，9-16为Port B
+        return pin <= 8 ? (32 + pin - 1) : (40 + pin - 9);
+    }
+    return GPIO_INPUT_BITS;
+}
+
+// 把物理/逻辑/触摸键盘映射编译为连续分发表，并由分发项派生MCU/MCP反转位图
+// 在映射变化时调用 (Core1或初始化阶段)，轮询路径只访问编译结果
+void InputManager::compileKeyboardDispatch()
+{
+    // 第一遍：收集GPIO分发项 (未排序)
+    KeyboardDispatchEntry pending[MAX_GPIO_DISPATCH_ENTRIES];
+    uint8_t pending_count = 0;
+    uint8_t bit_counts[GPIO_INPUT_BITS] = {0};
+    const uint64_t previous_mapped = gpio_mapped_inputs_;
+    gpio_mapped_inputs_ = 0;
+    gpio_debounce_eager_ = 0;
+    gpio_debounce_defer_ = 0;
     gpio_mcu_inverted_ = 0;
     gpio_mcp_inverted_a_ = 0;
     gpio_mcp_inverted_b_ = 0;
 
-    const auto &mappings = config_->physical_keyboard_mappings;
-    for (const auto &m : mappings)
+    for (const auto &mapping : config_->physical_keyboard_mappings)
     {
-        const bool invert = (m.trigger_level == GPIOTriggerLevel::ACTIVE_LOW);
-        const uint8_t pin = get_gpio_pin_number(m.gpio);
-        if (is_mcu_gpio(m.gpio))
+        const uint8_t bit = getGPIOInputBit(mapping.gpio);
+        if (bit >= GPIO_INPUT_BITS || pending_count >= MAX_GPIO_DISPATCH_ENTRIES)
+            continue;
+        const uint8_t flags = (mapping.trigger_level == GPIOTriggerLevel::ACTIVE_LOW) ? KEYBOARD_DISPATCH_ACTIVE_LOW : 0;
+        // 未指定按键的物理映射仍生成占位项 (key_bit=0)，保证输入位与电平翻转被记录
+        pending[pending_count++] = {bit, KeyboardBitmap::getBitIndex(mapping.default_key), flags};
+        bit_counts[bit]++;
+        gpio_mapped_inputs_ |= (1ULL << bit);
+        if (flags & KEYBOARD_DISPATCH_ACTIVE_LOW)
         {
-            if (invert) gpio_mcu_inverted_ |= (1u << pin);
+            if (bit < 32) gpio_mcu_inverted_ |= (1u << bit);
+            else if (bit < 40) gpio_mcp_inverted_a_ |= (1u << (bit - 32));
+            else gpio_mcp_inverted_b_ |= (1u << (bit - 40));
         }
-        else if (is_mcp_gpio(m.gpio))
+        // 消抖参数按输入位展开 (同一引脚多次映射时以最后一项为准)
+        gpio_debounce_eager_ &= ~(1ULL << bit);
+        gpio_debounce_defer_ &= ~(1ULL << bit);
+        gpio_debounce_us_[bit] = mapping.debounce_us;
+        if (mapping.debounce_us > 0)
         {
-            if (pin <= 8)
-            {
-                uint8_t bit = pin - 1;
-                if (invert) gpio_mcp_inverted_a_ |= (1u << bit);
-            }
-            else
+            if (mapping.debounce_mode == GPIODebounceMode::EAGER) gpio_debounce_eager_ |= (1ULL << bit);
+            else if (mapping.debounce_mode == GPIODebounceMode::DEFER) gpio_debounce_defer_ |= (1ULL << bit);
+        }
+    }
+
+    // 新映射的输入位以当前电平作为已上报电平，已移除或改为不消抖的输入位结束定时
+    const uint64_t new_inputs = gpio_mapped_inputs_ & ~previous_mapped;
+    gpio_debounced_inputs_ = (gpio_debounced_inputs_ & ~new_inputs) |
+        (combineGPIOInputs(mcu_gpio_previous_states_, mcp_gpio_previous_states_) & new_inputs);
+    gpio_debounce_pending_ &= gpio_debounce_eager_ | gpio_debounce_defer_;
+
+    // 逻辑键：同一GPIO联动最多3个按键，只对存在物理映射的输入位生效
+    for (size_t i = 0; i < gpio_logical_count_cache_; i++)
+    {
+        const LogicalKeyMapping &logical = gpio_logical_mappings_cache_[i];
+        const uint8_t bit = getGPIOInputBit(logical.gpio_id);
+        if (bit >= GPIO_INPUT_BITS || !(gpio_mapped_inputs_ & (1ULL << bit)))
+            continue;
+        for (uint8_t k = 0; k < 3 && pending_count < MAX_GPIO_DISPATCH_ENTRIES; k++)
+        {
+            if (logical.keys[k] != HID_KeyCode::KEY_NONE)
             {
-                uint8_t bit = pin - 9;
-                if (invert) gpio_mcp_inverted_b_ |= (1u << bit);
+                pending[pending_count++] = {bit, KeyboardBitmap::getBitIndex(logical.keys[k]), KEYBOARD_DISPATCH_LOGICAL};
+                bit_counts[bit]++;
             }
         }
     }
+
+    // 第二遍：按输入位计数排序，生成区间索引
+    gpio_dispatch_offsets_[0] = 0;
+    for (uint8_t bit = 0; bit < GPIO_INPUT_BITS; bit++)
+    {
+        gpio_dispatch_offsets_[bit + 1] = gpio_dispatch_offsets_[bit] + bit_counts[bit];
+    }
+    uint8_t cursors[GPIO_INPUT_BITS];
+    memcpy(cursors, gpio_dispatch_offsets_, sizeof(cursors));
+    for (uint8_t i = 0; i < pending_count; i++)
+    {
+        gpio_dispatch_entries_[cursors[pending[i].input_bit]++] = pending[i];
+    }
+    gpio_dispatch_count_ = pending_count;
+
+    // 触摸键盘：先释放旧分发表中仍按下的按键，再重建分发项并清空运行时状态
+    for (uint8_t i = 0; i < touch_dispatch_count_; i++)
+    {
+        if (touch_dispatch_states_[i].key_pressed && hid_)
+        {
+            hid_->release_key(KeyboardBitmap::getKeyAt(touch_dispatch_entries_[i].key_bit));
+        }
+    }
+    touch_dispatch_count_ = 0;
+    touch_dispatch_active_ = 0;
+    touch_dispatch_waiting_ = 0;
+    touch_dispatch_release_next_ = 0;
+    // 长按定时器属于Core1时间轮，这里不取消；过期的定时器到期后只会触发一次空处理
+    touch_hold_expired_ = false;
+    // 清空上一次区域状态，下一轮把当前所有按下区域视为变化，重新评估相关分发项
+    touch_dispatch_touched_ = 0;
+    memset(touch_area_dispatch_, 0, sizeof(touch_area_dispatch_));
+    for (const auto &mapping : config_->touch_keyboard_mappings)
+    {
+        const uint8_t key_bit = KeyboardBitmap::getBitIndex(mapping.key);
+        if (mapping.area_mask == 0 || key_bit == 0 || touch_dispatch_count_ >= MAX_TOUCH_KEYBOARD_MAPPINGS)
+            continue;
+        touch_dispatch_entries_[touch_dispatch_count_] = {mapping.area_mask, mapping.hold_time_ms, key_bit,
+                                                          static_cast<uint8_t>(mapping.trigger_once ? KEYBOARD_DISPATCH_TRIGGER_ONCE : 0)};
+        touch_dispatch_states_[touch_dispatch_count_] = {0, TOUCH_KEYBOARD_TRIGGLE_STAGE_NONE, false};
+        // 区域 -> 分发项倒排索引
+        uint64_t areas = mapping.area_mask & ((1ULL << 34) - 1);
+        while (areas)
+        {
+            touch_area_dispatch_[__builtin_ctzll(areas)] |= (1u << touch_dispatch_count_);
+            areas &= areas - 1;
+        }
+        touch_dispatch_count_++;
+    }
 }
 
 // 新增映射时进行电平有效性检查（仅日志提示，不更改配置）
@@ -2389,6 +3171,69 @@ bool InputManager::getSendOnlyOnChange() const
     return config_->send_only_on_change;
 }
 
+void InputManager::setGPIOIRQMode(bool enabled)
+{
+    config_->gpio_irq_mode = enabled;
+}
+
+bool InputManager::getGPIOIRQMode() const
+{
+    return config_->gpio_irq_mode;
+}
+
+void InputManager::setPartialFrameEnabled(bool enabled)
+{
+    config_->partial_frame_enabled = enabled;
+}
+
+bool InputManager::getPartialFrameEnabled() const
+{
+    return config_->partial_frame_enabled;
+}
+
+bool InputManager::setTouchDeviceIntPin(uint8_t device_id_mask, uint8_t gpio)
+{
+    TouchDeviceMapping* mapping = findTouchDeviceMapping(device_id_mask);
+    if (!mapping || (gpio != 0xFF && gpio >= 30))
+    {
+        return false;
+    }
+    mapping->setIntPin(gpio);
+    return true;
+}
+
+uint8_t InputManager::getTouchDeviceIntPin(uint8_t device_id_mask)
+{
+    const TouchDeviceMapping* mapping = findTouchDeviceMapping(device_id_mask);
+    return mapping ? mapping->getIntPin() : 0xFF;
+}
+
+bool InputManager::isTouchDeviceIntActive(uint8_t device_id_mask) const
+{
+    for (uint8_t i = 0; i < touch_sensor_devices_.size() && i < MAX_TOUCH_DEVICE; i++)
+    {
+        if (touch_sensor_devices_[i] && touch_sensor_devices_[i]->getModuleMask() == device_id_mask)
+        {
+            return touch_int_pins_[i] != 0xFF;
+        }
+    }
+    return false;
+}
+
+void InputManager::setFrameStaleness(uint8_t staleness_ms)
+{
+    if (staleness_ms < 1)
+        staleness_ms = 1;
+    if (staleness_ms > 100)
+        staleness_ms = 100;
+    config_->frame_staleness_ms = staleness_ms;
+}
+
+uint8_t InputManager::getFrameStaleness() const
+{
+    return config_->frame_staleness_ms;
+}
+
 void InputManager::setDataAggregationDelay(uint8_t delay_ms)
 {
     if (delay_ms > 100)
@@ -2468,45 +3313,110 @@ bool InputManager::setMai2SerialConfig(const Mai2Serial_Config& config)
     return true;  // 配置已保存到内部
 }
 
-inline void InputManager::storeDelayedSerialState()
+void InputManager::rebuildSerialAreaTable()
+{
+    // 先清标志：重建期间若映射再次变化，下一帧会重新编译
+    serial_area_table_dirty_ = false;
+    memset(serial_area_table_, 0, sizeof(serial_area_table_));
+    serial_area_module_count_ = 0;
+    serial_combo_count_ = 0;
+
+    for (uint8_t area_idx = 0; area_idx < 34; area_idx++)
+    {
+        const uint32_t channel = static_config_.area_channel_mappings.serial_mappings[area_idx].channel;
+        if (channel == 0xFFFFFFFF) continue;
+
+        const uint8_t module_mask = channel >> 24;
+        const uint32_t channel_bits = channel & 0x00FFFFFF;
+
+        // 查找或分配该模块的表行
+        uint8_t row = 0;
+        while (row < serial_area_module_count_ && serial_area_modules_[row] != module_mask) row++;
+        if (row == serial_area_module_count_ && row < MAPPING_TABLE_DEVICES)
+        {
+            serial_area_modules_[row] = module_mask;
+            serial_area_module_count_++;
+        }
+
+        // 单通道映射直接编译进表，其余 (多通道组合/行已满) 保留原比较逻辑
+        if (row < serial_area_module_count_ && channel_bits != 0 && (channel_bits & (channel_bits - 1)) == 0)
+        {
+            serial_area_table_[row][__builtin_ctz(channel_bits)] |= (1ULL << area_idx);
+        }
+        else
+        {
+            serial_combo_mappings_[serial_combo_count_].channel = channel;
+            serial_combo_mappings_[serial_combo_count_].area_idx = area_idx;
+            serial_combo_count_++;
+        }
+    }
+}
+
+void InputManager::storeDelayedSerialState()
 {
     static uint32_t current_time_us;
-    static uint32_t channel;
     static Mai2Serial_TouchState local_serial_state_;
-    local_serial_state_.clear();
     current_time_us = time_us_32();
 
-    // 优化的Serial触摸状态计算
+    if (serial_area_table_dirty_)
+    {
+        rebuildSerialAreaTable();
+    }
+
+    // 查表组帧：每个设备只遍历被按下的通道位，OR上该通道对应的区域位
+    uint64_t areas = 0;
     for (int i = 0; i < config_->device_count; i++)
     {
-        // 直接使用0-33索引，避免额外运算
-         for (int area_idx = 0; area_idx < 34; area_idx++)
-         {
-            channel = static_config_.area_channel_mappings.serial_mappings[area_idx].channel;  // 直接索引0-33
-            if (channel == 0xFFFFFFFF) continue;
-            
-            // 优化位运算检查
-            if ((touch_device_states_[i].current_touch_mask & (channel | 0xFF000000)) == channel)
+        const uint32_t touch_mask = touch_device_states_[i].current_touch_mask;
+        const uint8_t module_mask = touch_mask >> 24;
+        uint8_t row = 0;
+        while (row < serial_area_module_count_ && serial_area_modules_[row] != module_mask) row++;
+        if (row < serial_area_module_count_)
+        {
+            const uint64_t *table = serial_area_table_[row];
+            uint32_t pressed = touch_mask & 0x00FFFFFF;
+            while (pressed)
+            {
+                areas |= table[__builtin_ctz(pressed)];
+                pressed &= pressed - 1;
+            }
+        }
+
+        for (uint8_t c = 0; c < serial_combo_count_; c++)
+        {
+            const uint32_t channel = serial_combo_mappings_[c].channel;
+            if ((touch_mask & (channel | 0xFF000000)) == channel)
             {
-                // 直接位操作，避免额外计算
-                if (area_idx < 32)
-                    local_serial_state_.parts.state1 |= (1UL << area_idx);
-                else
-                    local_serial_state_.parts.state2 |= (1UL << (area_idx - 32));
+                areas |= (1ULL << serial_combo_mappings_[c].area_idx);
             }
         }
     }
+    local_serial_state_.raw = areas;
+
     delay_buffer_[delay_buffer_head_].timestamp_us = current_time_us;
+    delay_buffer_[delay_buffer_head_].sample_us = frame_sample_us_;
     delay_buffer_[delay_buffer_head_].serial_touch_state = local_serial_state_;
 
     // 优化缓冲区指针更新
     delay_buffer_head_ = (delay_buffer_head_ + 1) % DELAY_BUFFER_SIZE;
+    delay_buffer_seq_++;
     if (delay_buffer_count_ < DELAY_BUFFER_SIZE)
     {
         delay_buffer_count_++;
     }
 }
 
+// 发布完整采样帧的触摸掩码快照 (Core0，所有设备完成采样后调用)
+void InputManager::publishTouchFrame()
+{
+    static TouchFrameSnapshot frame;
+    for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++)
+    {
+        frame.touch_masks[i] = touch_device_states_[i].current_touch_mask;
+    }
+    touch_frame_.store(frame);
+}
+
 // 静态日志函数实现
 void InputManager::log_debug(const std::string &msg)
 {
@@ -2739,6 +3649,223 @@ bool InputManager::hasCalibratableSensors() const
     return false;
 }
 
+// 请求输出触摸延迟统计
+void InputManager::requestTouchLatencyDump(bool reset_after)
+{
+    if (reset_after) {
+        latency_reset_pending_ = true;
+    }
+    latency_dump_pending_ = true;
+}
+
+// 请求重置触摸延迟统计
+void InputManager::requestTouchLatencyReset()
+{
+    latency_reset_pending_ = true;
+}
+
+const char* InputManager::getTouchLatencyStageName(TouchLatencyStage stage)
+{
+    switch (stage) {
+        case TouchLatencyStage::SAMPLE_TO_BUFFER: return "sample->buffer";
+        case TouchLatencyStage::BUFFER_TO_SELECT: return "buffer->select";
+        case TouchLatencyStage::SELECT_TO_WIRE:   return "select->wire";
+        case TouchLatencyStage::SAMPLE_TO_WIRE:   return "sample->wire";
+        default:                                  return "unknown";
+    }
+}
+
+// 统计由task0写入，输出与重置同样放在task0中执行，避免跨核读写
+void InputManager::processTouchLatencyRequests()
+{
+    if (latency_dump_pending_) {
+        latency_dump_pending_ = false;
+        USB_LOG_TAG_INFO("Latency", "delay=%ums aggregation=%ums rate_limit=%s send_on_change=%s",
+                         config_->touch_response_delay_ms, config_->data_aggregation_delay_ms,
+                         config_->rate_limit_enabled ? "on" : "off",
+                         config_->send_only_on_change ? "on" : "off");
+        for (uint8_t i = 0; i < static_cast<uint8_t>(TouchLatencyStage::COUNT); i++) {
+            const LatencyHistogram& histogram = touch_latency_[i];
+            USB_LOG_TAG_INFO("Latency", "%s n=%lu p50=%luus p99=%luus max=%luus",
+                             getTouchLatencyStageName(static_cast<TouchLatencyStage>(i)),
+                             (unsigned long)histogram.count(),
+                             (unsigned long)histogram.percentile(50),
+                             (unsigned long)histogram.percentile(99),
+                             (unsigned long)histogram.max_us());
+        }
+        USB_LOG_TAG_INFO("Latency", "i2c frame cost bus0=%luus bus1=%luus",
+                         (unsigned long)getI2CBusFrameCost(0), (unsigned long)getI2CBusFrameCost(1));
+        for (uint8_t i = 0; i < total_device_count_; i++) {
+            const TouchDeviceTiming& timing = device_timing_[i];
+            USB_LOG_TAG_INFO("Latency", "device %u cost=%uus ready=%uus samples=%lu not_ready=%lu failed=%lu",
+                             i, timing.cost_us, timing.ready_us, (unsigned long)timing.samples,
+                             (unsigned long)timing.not_ready_polls, (unsigned long)timing.failure_total);
+        }
+        if (config_->partial_frame_enabled) {
+            USB_LOG_TAG_INFO("Latency", "frames full=%lu partial=%lu staleness=%ums stale_now=0x%04lx",
+                             (unsigned long)touch_frame_stats_.full_frames,
+                             (unsigned long)touch_frame_stats_.partial_frames,
+                             config_->frame_staleness_ms,
+                             (unsigned long)frame_stale_bitmap_);
+            for (uint8_t i = 0; i < total_device_count_; i++) {
+                if (touch_frame_stats_.device_stale_frames[i]) {
+                    USB_LOG_TAG_INFO("Latency", "device %u stale in %lu frames", i,
+                                     (unsigned long)touch_frame_stats_.device_stale_frames[i]);
+                }
+            }
+        }
+    }
+    if (latency_reset_pending_) {
+        latency_reset_pending_ = false;
+        for (uint8_t i = 0; i < static_cast<uint8_t>(TouchLatencyStage::COUNT); i++) {
+            touch_latency_[i].reset();
+        }
+        memset(&touch_frame_stats_, 0, sizeof(touch_frame_stats_));
+    }
+}
+
+// 请求输出采样遥测
+void InputManager::requestTouchTelemetryDump(bool reset_after)
+{
+    if (reset_after) {
+        telemetry_reset_pending_ = true;
+    }
+    telemetry_dump_pending_ = true;
+}
+
+uint32_t InputManager::getTimeSinceLastSample(uint8_t device_index) const
+{
+    const TouchDeviceTiming& timing = device_timing_[device_index];
+    if (timing.samples == 0) {
+        return UINT32_MAX;
+    }
+    return (time_us_32() - timing.done_us) / 1000;
+}
+
+// 滚动遥测窗口：窗口量在I2C完成中断中累加，关中断后一次性换算并清零
+void InputManager::onTelemetryTimer(void* context)
+{
+    InputManager* instance = static_cast<InputManager*>(context);
+    const uint32_t irq_state = save_and_disable_interrupts();
+    const uint32_t now_us = time_us_32();
+    const uint32_t window_us = now_us - instance->telemetry_window_start_us_;
+    instance->telemetry_window_start_us_ = now_us;
+    if (window_us == 0) {
+        restore_interrupts(irq_state);
+        return;
+    }
+    for (uint8_t bus = 0; bus < 2; bus++) {
+        uint32_t busy_us = 0;
+        for (uint8_t stage = 0; stage < 4; stage++) {
+            const uint8_t index = instance->i2c_sampling_stages_[bus].device_indices[stage];
+            if (index != 0xFF) {
+                busy_us += instance->device_telemetry_[index].window_busy_us;
+            }
+        }
+        instance->i2c_bus_busy_permille_[bus] = static_cast<uint16_t>(
+            std::min<uint64_t>(static_cast<uint64_t>(busy_us) * 1000 / window_us, 1000));
+    }
+    for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++) {
+        TouchDeviceTelemetry& telemetry = instance->device_telemetry_[i];
+        telemetry.samples_per_sec = static_cast<uint16_t>(
+            std::min<uint64_t>(static_cast<uint64_t>(telemetry.window_samples) * 1000000 / window_us, UINT16_MAX));
+        telemetry.mean_cost_us = telemetry.window_transactions
+            ? static_cast<uint16_t>(telemetry.window_cost_us / telemetry.window_transactions) : 0;
+        telemetry.window_busy_us = 0;
+        telemetry.window_cost_us = 0;
+        telemetry.window_samples = 0;
+        telemetry.window_transactions = 0;
+    }
+    restore_interrupts(irq_state);
+}
+
+// 遥测由task0/采样中断写入，输出与重置同样放在task0中执行
+void InputManager::processTouchTelemetryRequests()
+{
+    if (telemetry_dump_pending_) {
+        telemetry_dump_pending_ = false;
+        USB_LOG_TAG_INFO("Telemetry", "bus0 util=%u.%u%% bus1 util=%u.%u%%",
+                         i2c_bus_busy_permille_[0] / 10, i2c_bus_busy_permille_[0] % 10,
+                         i2c_bus_busy_permille_[1] / 10, i2c_bus_busy_permille_[1] % 10);
+        for (uint8_t i = 0; i < total_device_count_; i++) {
+            const TouchDeviceTelemetry& telemetry = device_telemetry_[i];
+            const TouchDeviceTiming& timing = device_timing_[i];
+            const uint32_t since_ms = getTimeSinceLastSample(i);
+            char since_text[16];
+            if (since_ms == UINT32_MAX) {
+                snprintf(since_text, sizeof(since_text), "never");
+            } else {
+                snprintf(since_text, sizeof(since_text), "%lums", (unsigned long)since_ms);
+            }
+            USB_LOG_TAG_INFO("Telemetry", "device %u rate=%u/s failed=%lu nack=%lu cost avg=%uus max=%uus last_ok=%s",
+                             i, telemetry.samples_per_sec, (unsigned long)timing.failure_total,
+                             (unsigned long)telemetry.nacks, telemetry.mean_cost_us, telemetry.max_cost_us, since_text);
+        }
+    }
+    if (telemetry_reset_pending_) {
+        telemetry_reset_pending_ = false;
+        // 累计量清零，窗口量保持滚动
+        const uint32_t irq_state = save_and_disable_interrupts();
+        for (uint8_t i = 0; i < MAX_TOUCH_DEVICE; i++) {
+            device_telemetry_[i].nacks = 0;
+            device_telemetry_[i].max_cost_us = 0;
+            device_timing_[i].failure_total = 0;
+        }
+        restore_interrupts(irq_state);
+    }
+}
+
+// 开始触摸轨迹录制
+bool InputManager::startTouchTrace(uint32_t capacity_bytes)
+{
+    return touch_trace_.start(capacity_bytes);
+}
+
+// 停止触摸轨迹录制，实际保存在task0中执行
+void InputManager::stopTouchTrace()
+{
+    touch_trace_.stop();
+}
+
+bool InputManager::startRawStream(uint8_t module_filter, uint16_t stage_mask, uint8_t decimation)
+{
+    stopRawStream();
+    uint8_t capturing = 0;
+    for (TouchSensor* sensor : touch_sensor_devices_)
+    {
+        if (sensor && (module_filter == 0 || sensor->getModuleMask() == module_filter) && sensor->setRawCapture(true))
+        {
+            capturing++;
+        }
+    }
+    if (capturing == 0)
+    {
+        log_warning("Raw stream: no device supports raw capture");
+        return false;
+    }
+    touch_raw_stream_.start(module_filter, stage_mask, decimation);
+    log_info("Raw stream started on " + std::to_string(capturing) + " device(s)");
+    return true;
+}
+
+void InputManager::stopRawStream()
+{
+    if (!touch_raw_stream_.is_active())
+    {
+        return;
+    }
+    touch_raw_stream_.stop();
+    for (TouchSensor* sensor : touch_sensor_devices_)
+    {
+        if (sensor)
+        {
+            sensor->setRawCapture(false);
+        }
+    }
+    log_info("Raw stream stopped, sent " + std::to_string(touch_raw_stream_.frames_sent()) +
+             " dropped " + std::to_string(touch_raw_stream_.frames_dropped()));
+}
+
 // 根据设备ID掩码获取设备名称 - UI显示时调用
 std::string InputManager::getDeviceNameByMask(uint32_t device_and_channel_mask) const
 {
@@ -2789,12 +3916,34 @@ void InputManager::async_touchsampleresult(const TouchSampleResult& result) {
     i2c_bus = TouchSensor::extractI2CBusFromMask(device_mask);
     device_index = -1;
 
+    // 正在采样的设备即总线当前阶段的设备
+    const uint8_t stage_device_index = instance->i2c_sampling_stages_[i2c_bus].device_indices[instance->i2c_sampling_stages_[i2c_bus].current_stage];
+    if (stage_device_index != 0xFF) {
+        instance->recordSampleTiming(stage_device_index, result.timestamp_us != 0, time_us_32());
+        if (result.timestamp_us == 0 && sampling_bus_hal(i2c_bus)->last_abort_was_nack()) {
+            instance->device_telemetry_[stage_device_index].nacks++;
+        }
+    }
+
     if (result.timestamp_us == 0) {
-        // 约定时间戳为0时 代表采样失败 解锁当前阶段 重新采样
+        // 约定时间戳为0时 代表采样失败 解锁当前阶段 由调度器重新选择 (连续失败的设备进入退避)
         instance->i2c_sampling_stages_[i2c_bus].stage_locked = false;
         return;
     };
 
+    instance->touch_trace_.record(result);
+
+    // 原始数据流：读取本次采样随状态一起带回的原始值
+    if (instance->touch_raw_stream_.accepts(device_mask)) {
+        const I2C_SamplingStage& stages = instance->i2c_sampling_stages_[i2c_bus];
+        const TouchSensor* device = stages.device_instances[stages.current_stage];
+        if (device && device->getModuleMask() == device_mask) {
+            uint8_t count = 0;
+            const uint16_t* values = device->getRawValues(count);
+            instance->touch_raw_stream_.record(device_mask, result.timestamp_us, values, count);
+        }
+    }
+
     for (int8_t i = 0; i < instance->touch_sensor_devices_.size(); i++) {
         if (instance->touch_sensor_devices_[i]->getModuleMask() == device_mask) {
             device_index = i;
@@ -2810,25 +3959,110 @@ void InputManager::async_touchsampleresult(const TouchSampleResult& result) {
     instance->touch_device_states_[device_index].current_touch_mask = result.touch_mask;
     instance->touch_device_states_[device_index].timestamp_us = result.timestamp_us;
     
+    // 本轮首个完成的设备记录帧采样时间
+    if (instance->device_completed_bitmap_ == 0) {
+        instance->frame_sample_us_ = result.timestamp_us;
+    }
+
     // 标记该设备已完成采样（使用device_index）
     if (device_index < 32) {
         instance->device_completed_bitmap_ |= (1u << device_index);
     }
     
-    // 检查是否所有设备都已完成采样
-    uint32_t expected_bitmap = (1u << instance->total_device_count_) - 1;
-    if (instance->device_completed_bitmap_ == expected_bitmap) {
-        // 所有设备完成采样，执行一次性处理
-        instance->incrementSampleCounter();
-        instance->storeDelayedSerialState();
-        
-        // 重置bitmap为下一轮采样做准备
-        instance->device_completed_bitmap_ = 0;
+    if (instance->config_->partial_frame_enabled) {
+        instance->assemblePartialFrame(result.timestamp_us, false);
+    } else {
+        // 检查是否所有设备都已完成采样
+        uint32_t expected_bitmap = (1u << instance->total_device_count_) - 1;
+        if (instance->device_completed_bitmap_ == expected_bitmap) {
+            // 所有设备完成采样，执行一次性处理
+            instance->emitTouchFrame();
+        }
     }
     
-    // 解锁当前阶段并递增到下一个阶段
+    // 解锁当前阶段，下一个阶段由调度器选择
     instance->i2c_sampling_stages_[i2c_bus].stage_locked = false;
-    instance->i2c_sampling_stages_[i2c_bus].next_stage();
+}
+
+// 一帧组装完成：写入延迟缓冲、发布快照，重置bitmap为下一轮采样做准备
+inline void InputManager::emitTouchFrame() {
+    incrementSampleCounter();
+    storeDelayedSerialState();
+    publishTouchFrame();
+    device_completed_bitmap_ = 0;
+    last_frame_us_ = time_us_32();
+}
+
+/**
+ * 部分帧组帧
+ * 在新鲜度上限内上报过的设备视为新鲜，本轮所有新鲜设备都完成采样即出帧，
+ * 不再被一个变慢或NACK的设备拖住整帧；过期设备的触摸按松开处理并计入统计。
+ * cadence=true 时由节拍定时器调用：距上一帧已超过新鲜度上限时，用各设备的最新采样强制出帧，
+ * 保证所有设备都停止上报时过期触摸也能被及时松开。
+ * 在I2C完成中断或关中断的task0中执行，两者互斥。
+ */
+void InputManager::assemblePartialFrame(uint32_t now_us, bool cadence) {
+    const uint32_t staleness_us = static_cast<uint32_t>(config_->frame_staleness_ms) * 1000u;
+    if (cadence && (now_us - last_frame_us_) < staleness_us) {
+        return;
+    }
+
+    uint32_t fresh_bitmap = 0;
+    for (uint8_t i = 0; i < total_device_count_; i++) {
+        const uint32_t timestamp_us = touch_device_states_[i].timestamp_us;
+        if (timestamp_us != 0 && (now_us - timestamp_us) < staleness_us) {
+            fresh_bitmap |= (1u << i);
+        }
+    }
+    if (!cadence && (device_completed_bitmap_ & fresh_bitmap) != fresh_bitmap) {
+        return;  // 仍有新鲜设备未上报，等待它或节拍定时器
+    }
+
+    const uint32_t expected_bitmap = (1u << total_device_count_) - 1;
+    frame_stale_bitmap_ = expected_bitmap & ~fresh_bitmap;
+    if (frame_stale_bitmap_) {
+        touch_frame_stats_.partial_frames++;
+        uint32_t stale = frame_stale_bitmap_;
+        while (stale) {
+            const uint8_t i = static_cast<uint8_t>(__builtin_ctz(stale));
+            stale &= stale - 1;
+            touch_device_states_[i].current_touch_mask &= 0xFF000000;  // 保留设备掩码，清空通道
+            touch_frame_stats_.device_stale_frames[i]++;
+        }
+    } else {
+        touch_frame_stats_.full_frames++;
+    }
+
+    // 节拍帧没有新的采样时，以出帧时间作为本帧采样时间
+    if (device_completed_bitmap_ == 0) {
+        frame_sample_us_ = now_us;
+    }
+    emitTouchFrame();
+}
+
+// 部分帧模式开启时以半个新鲜度上限为周期检查，停止时取消；配置变化在下一轮task0生效
+inline void InputManager::updateFrameTimer() {
+    const uint32_t period_us = config_->partial_frame_enabled
+        ? static_cast<uint32_t>(config_->frame_staleness_ms) * 500u : 0;
+    if (period_us == frame_timer_.period_us) {
+        return;
+    }
+    if (period_us) {
+        TimerWheel::core().schedule_periodic(frame_timer_, period_us, onFrameTimer, this);
+    } else {
+        TimerWheel::core().cancel(frame_timer_);
+    }
+}
+
+void InputManager::onFrameTimer(void* context) {
+    InputManager* instance = static_cast<InputManager*>(context);
+    if (!instance->config_->partial_frame_enabled || instance->total_device_count_ == 0) {
+        return;
+    }
+    // 与I2C完成中断中的组帧互斥
+    const uint32_t irq_state = save_and_disable_interrupts();
+    instance->assemblePartialFrame(time_us_32(), true);
+    restore_interrupts(irq_state);
 }
 
 // 设备注册到阶段的接口实现
@@ -2854,6 +4088,7 @@ bool InputManager::registerDeviceToStage(uint8_t stage, uint8_t device_id) {
     
     // 存储实例地址（如果找不到设备则存储nullptr）
     i2c_sampling_stages_[i2c_bus].device_instances[stage] = device_instance;
+    i2c_sampling_stages_[i2c_bus].device_indices[stage] = findStageDeviceIndex(touch_sensor_devices_, device_instance);
     return device_instance != nullptr;
 }
 
@@ -2863,6 +4098,7 @@ bool InputManager::unregisterDeviceFromStage(uint8_t i2c_bus, uint8_t stage) {
     }
     
     i2c_sampling_stages_[i2c_bus].device_instances[stage] = nullptr;
+    i2c_sampling_stages_[i2c_bus].device_indices[stage] = 0xFF;
     return true;
 }
 
@@ -2902,9 +4138,23 @@ bool InputManager::overrideStageDeviceId(uint8_t stage, uint8_t device_id) {
     
     // 存储实例地址
     i2c_sampling_stages_[i2c_bus].device_instances[stage] = device_instance;
+    i2c_sampling_stages_[i2c_bus].device_indices[stage] = findStageDeviceIndex(touch_sensor_devices_, device_instance);
     return (device_id == 0) || (device_instance != nullptr);
 }
 
+// 设备在touch_sensor_devices_中的下标 (与device_completed_bitmap_位序一致)，不存在返回0xFF
+uint8_t InputManager::findStageDeviceIndex(const std::vector<TouchSensor*>& devices, TouchSensor* device) {
+    if (device == nullptr) {
+        return 0xFF;
+    }
+    for (uint8_t i = 0; i < devices.size() && i < MAX_TOUCH_DEVICE; i++) {
+        if (devices[i] == device) {
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
 // 阶段分配管理接口实现
 bool InputManager::setStageAssignment(uint8_t stage, uint8_t device_id) {
     // 从device_id中解析i2c_bus
@@ -2984,7 +4234,7 @@ const std::vector<InputManager_PrivateConfig::StageAssignment>& InputManager::ge
 
 void InputManager::processSensitivityRequests() {
     SensitivityRequest request;
-    while (sensitivity_request_buffer_.popRequest(request)) {
+    while (sensitivity_request_buffer_.pop(request)) {
         // 查找对应的触摸设备
         TouchDeviceMapping* mapping = findTouchDeviceMapping(request.device_id);
         if (!mapping) {
@@ -12,12 +12,17 @@ typedef uint32_t millis_t;
 #include <vector>
 #include <map>
 #include "../../hal/i2c/hal_i2c.h"
+#include "../../hal/cross_core.h"
+#include "../../hal/timer_wheel.h"
 #include "../../protocol/mai2serial/mai2serial.h"
 #include "../../protocol/hid/hid.h"
 // 统一使用TouchSensor接口
 #include "../../protocol/touch_sensor/touch_sensor.h"
 #include "../../protocol/mcp23s17/mcp23s17.h"
 #include "../ui_manager/ui_manager.h"
+#include "touch_trace.h"
+#include "touch_raw_stream.h"
+#include "latency_histogram.h"
 
 // 触摸键盘映射预处理定义
 #define TOUCH_KEYBOARD_KEY HID_KeyCode::KEY_SPACE  // 默认触摸映射按键
@@ -25,6 +30,9 @@ typedef uint32_t millis_t;
 // 灵敏度设置定义
 #define DEFAULT_TOUCH_SENSITIVITY 45  // 默认触摸灵敏度 (0-99范围)
 #define MAX_TOUCH_DEVICE 16           // 最大触摸模块数量
+#define MAPPING_TABLE_DEVICES 8       // 映射编译表覆盖的设备数量 (与注册上限一致)
+#define MAX_HID_AREA_MAPPINGS (MAPPING_TABLE_DEVICES * 24)  // HID区域上限：每个通道都可作为独立触点
+#define MAX_TOUCH_KEYBOARD_MAPPINGS 32  // 触摸键盘映射上限 (与分发表容量一致)
 
 // 触摸坐标结构体 - 前向声明，供TouchDeviceMapping使用
 struct TouchAxis {
@@ -68,6 +76,15 @@ enum class GPIOTriggerLevel : uint8_t {
     AUTO = 2            // 自动模式：加入映射时采样当前电平作为“未触发”电平
 };
 
+// 按键消抖算法
+enum class GPIODebounceMode : uint8_t {
+    NONE = 0,     // 不消抖：每次电平变化立即生效
+    EAGER = 1,    // 即时消抖：首个边沿立即上报，随后debounce_us内锁定 (按下无附加延迟)
+    DEFER = 2     // 延迟消抖：电平稳定debounce_us后才上报 (抗干扰更强，增加等量延迟)
+};
+
+#define GPIO_DEFAULT_DEBOUNCE_US 5000
+
 // 物理键盘映射结构体
 struct PhysicalKeyboardMapping {
     union {
@@ -77,10 +94,15 @@ struct PhysicalKeyboardMapping {
     };
     HID_KeyCode default_key;
     GPIOTriggerLevel trigger_level;  // 触发电平选择
-    
-    PhysicalKeyboardMapping() : gpio(static_cast<uint8_t>(MCU_GPIO::GPIO_NONE)), default_key(HID_KeyCode::KEY_NONE), trigger_level(GPIOTriggerLevel::ACTIVE_LOW) {}
-    PhysicalKeyboardMapping(MCU_GPIO mcu, HID_KeyCode key, GPIOTriggerLevel level = GPIOTriggerLevel::ACTIVE_LOW) : mcu_gpio(mcu), default_key(key), trigger_level(level) {}
-    PhysicalKeyboardMapping(MCP_GPIO mcp, HID_KeyCode key, GPIOTriggerLevel level = GPIOTriggerLevel::ACTIVE_LOW) : mcp_gpio(mcp), default_key(key), trigger_level(level) {}
+    GPIODebounceMode debounce_mode;  // 消抖算法
+    uint16_t debounce_us;            // 消抖时间（微秒）
+    
+    PhysicalKeyboardMapping() : gpio(static_cast<uint8_t>(MCU_GPIO::GPIO_NONE)), default_key(HID_KeyCode::KEY_NONE), trigger_level(GPIOTriggerLevel::ACTIVE_LOW),
+        debounce_mode(GPIODebounceMode::EAGER), debounce_us(GPIO_DEFAULT_DEBOUNCE_US) {}
+    PhysicalKeyboardMapping(MCU_GPIO mcu, HID_KeyCode key, GPIOTriggerLevel level = GPIOTriggerLevel::ACTIVE_LOW) : mcu_gpio(mcu), default_key(key), trigger_level(level),
+        debounce_mode(GPIODebounceMode::EAGER), debounce_us(GPIO_DEFAULT_DEBOUNCE_US) {}
+    PhysicalKeyboardMapping(MCP_GPIO mcp, HID_KeyCode key, GPIOTriggerLevel level = GPIOTriggerLevel::ACTIVE_LOW) : mcp_gpio(mcp), default_key(key), trigger_level(level),
+        debounce_mode(GPIODebounceMode::EAGER), debounce_us(GPIO_DEFAULT_DEBOUNCE_US) {}
 };
 
 // 单次触发时的状态枚举
@@ -137,7 +159,7 @@ struct AreaChannelMappingConfig {
         
         HIDAreaMapping() : channel(0xFFFFFFFF), coordinates({0.0f, 0.0f}) {}  // 0xFFFFFFFF表示未映射
     };
-    HIDAreaMapping hid_mappings[10];                // 支持最多10个HID触摸区域
+    HIDAreaMapping hid_mappings[MAX_HID_AREA_MAPPINGS];  // HID触摸区域
     
     // 键盘映射：按键 -> 通道
     struct KeyboardMapping {
@@ -152,7 +174,7 @@ struct AreaChannelMappingConfig {
         for (int i = 0; i < 34; i++) {
             serial_mappings[i] = AreaChannelMapping();
         }
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < MAX_HID_AREA_MAPPINGS; i++) {
             hid_mappings[i] = HIDAreaMapping();
         }
     }
@@ -165,8 +187,9 @@ struct TouchDeviceMapping {
     uint8_t sensitivity[24];                        // 每个物理通道的灵敏度设置（以设备为单位统一管理）
     uint32_t enabled_channels_mask;                  // 启用的通道掩码（位图，仅低24位有效）
     bool is_connected;                              // 设备连接状态标志
+    uint8_t int_pin;                                // 就绪中断(INT)引脚：0表示未接 (轮询就绪)，否则为GPIO编号+1；占用原结构体填充字节，旧配置读出为0
     
-    TouchDeviceMapping() : device_id_mask(0), max_channels(0), enabled_channels_mask(0), is_connected(false) {
+    TouchDeviceMapping() : device_id_mask(0), max_channels(0), enabled_channels_mask(0), is_connected(false), int_pin(0) {
         // 初始化物理通道灵敏度为默认值
         for (int i = 0; i < 24; i++) {
             sensitivity[i] = DEFAULT_TOUCH_SENSITIVITY;
@@ -187,7 +210,16 @@ struct TouchDeviceMapping {
             sensitivity[channel] = sens;
         }
     }
+    
+    // 就绪中断引脚，未接时返回0xFF
+    uint8_t getIntPin() const {
+        return int_pin ? static_cast<uint8_t>(int_pin - 1) : 0xFF;
+    }
+    void setIntPin(uint8_t gpio) {
+        int_pin = (gpio < 30) ? static_cast<uint8_t>(gpio + 1) : 0;
+    }
 };
+static_assert(sizeof(TouchDeviceMapping) == 36, "TouchDeviceMapping按原始字节持久化，布局不能改变");
 
 // 触摸键盘映射模式
 enum class TouchKeyboardMode : uint8_t {
@@ -201,7 +233,8 @@ enum class TouchKeyboardMode : uint8_t {
 #define INPUTMANAGER_TOUCH_DEVICES "input_manager_touch_devices"
 #define INPUTMANAGER_TOUCH_KEYBOARD_ENABLED "input_manager_touch_keyboard_enabled"
 #define INPUTMANAGER_TOUCH_KEYBOARD_MODE "input_manager_touch_keyboard_mode"
-#define INPUTMANAGER_PHYSICAL_KEYBOARDS "input_manager_physical_keyboards"
+#define INPUTMANAGER_PHYSICAL_KEYBOARDS "input_manager_physical_keyboards_v2"
+#define INPUTMANAGER_PHYSICAL_KEYBOARDS_LEGACY "input_manager_physical_keyboards"  // 无消抖字段的旧格式，仅用于加载迁移
 #define INPUTMANAGER_TOUCH_RESPONSE_DELAY "input_manager_touch_response_delay"
 #define INPUTMANAGER_AREA_CHANNEL_MAPPINGS "input_manager_area_channel_mappings"
 #define INPUTMANAGER_MAI2SERIAL_BAUD_RATE "input_manager_mai2serial_baud_rate"
@@ -211,6 +244,9 @@ enum class TouchKeyboardMode : uint8_t {
 #define INPUTMANAGER_RATE_LIMIT_ENABLED "input_manager_rate_limit_enabled"
 #define INPUTMANAGER_RATE_LIMIT_FREQUENCY "input_manager_rate_limit_frequency"
 #define INPUTMANAGER_STAGE_ASSIGNMENTS "input_manager_stage_assignments"
+#define INPUTMANAGER_GPIO_IRQ_MODE "input_manager_gpio_irq_mode"
+#define INPUTMANAGER_PARTIAL_FRAME_ENABLED "input_manager_partial_frame_enabled"
+#define INPUTMANAGER_FRAME_STALENESS "input_manager_frame_staleness"
 
 
 // 工作模式枚举
@@ -227,6 +263,15 @@ enum class BindingState : uint8_t {
     PROCESSING       // 处理绑定
 };
 
+// 触摸延迟统计阶段
+enum class TouchLatencyStage : uint8_t {
+    SAMPLE_TO_BUFFER = 0,  // I2C采样完成 -> 写入延迟缓冲
+    BUFFER_TO_SELECT,      // 写入延迟缓冲 -> 被选中发送 (包含响应延迟与聚合)
+    SELECT_TO_WIRE,        // 被选中 -> UART TX DMA开始发送
+    SAMPLE_TO_WIRE,        // 端到端
+    COUNT
+};
+
 // 统一使用TouchDeviceMapping
 
 // 私有配置结构体
@@ -258,6 +303,13 @@ struct InputManager_PrivateConfig {
     bool rate_limit_enabled;                     // 频率限制开关
     uint16_t rate_limit_frequency;               // 频率限制值(Hz, 10-1000)
     
+    // 按键输入模式：true时由GPIO/MCP INT边沿中断驱动，false时每轮主循环轮询
+    bool gpio_irq_mode;
+    
+    // 组帧模式：true时不再等待所有设备，超过新鲜度上限未上报的设备按无触摸处理
+    bool partial_frame_enabled;
+    uint8_t frame_staleness_ms;                  // 设备采样新鲜度上限(ms, 1-100)
+    
     // 阶段分配配置
     struct StageAssignment {
         uint8_t i2c_bus;      // I2C总线编号 (0或1)
@@ -283,6 +335,9 @@ struct InputManager_PrivateConfig {
         , extra_send_count(0)
         , rate_limit_enabled(false)
         , rate_limit_frequency(120)
+        , gpio_irq_mode(false)
+        , partial_frame_enabled(false)
+        , frame_staleness_ms(10)
         , mai2serial_config() {
     }
 };
@@ -309,8 +364,9 @@ public:
         HID* hid;
         MCP23S17* mcp23s17;
         UIManager* ui_manager;
+        uint8_t mcp23s17_int_pin;  // MCP23S17 INT引脚 (INTA/INTB镜像合并)，0xFF表示未连接
         
-        InitConfig() : mai2_serial(nullptr), hid(nullptr), mcp23s17(nullptr), ui_manager(nullptr) {}
+        InitConfig() : mai2_serial(nullptr), hid(nullptr), mcp23s17(nullptr), ui_manager(nullptr), mcp23s17_int_pin(0xFF) {}
     };
     
     // 初始化和去初始化
@@ -367,6 +423,70 @@ public:
     // 检查是否存在支持校准的传感器
     bool hasCalibratableSensors() const;
     
+    // 触摸轨迹录制 - 停止后由task0写入 TOUCH_TRACE_FILE_PATH
+    bool startTouchTrace(uint32_t capacity_bytes = TOUCH_TRACE_DEFAULT_CAPACITY);
+    void stopTouchTrace();
+    inline bool isTouchTraceRecording() const { return touch_trace_.is_recording(); }
+    inline uint32_t getTouchTraceRecordCount() const { return touch_trace_.record_count(); }
+    inline bool isTouchTraceSavePending() const { return touch_trace_.save_pending(); }
+    // 原始CDC数据流 - 采样时连同原始值读回，由task1以二进制帧写入USB CDC (帧格式见touch_raw_stream.h)
+    // module_filter为0表示所有支持的设备；没有设备支持原始值读取时返回false
+    bool startRawStream(uint8_t module_filter, uint16_t stage_mask, uint8_t decimation = 1);
+    void stopRawStream();
+    inline bool isRawStreamActive() const { return touch_raw_stream_.is_active(); }
+    // 注入一条采样结果，与I2C采样完成回调走同一路径 (轨迹回放使用)
+    inline void injectTouchSample(const TouchSampleResult& result) { async_touchsampleresult(result); }
+    
+    // 触摸延迟统计 - 请求由task0处理，通过USB_SerialLogs输出各阶段p50/p99/max
+    void requestTouchLatencyDump(bool reset_after = false);
+    void requestTouchLatencyReset();
+    inline const LatencyHistogram& getTouchLatencyHistogram(TouchLatencyStage stage) const {
+        return touch_latency_[static_cast<uint8_t>(stage)];
+    }
+    static const char* getTouchLatencyStageName(TouchLatencyStage stage);
+    
+    // 组帧统计 (部分帧模式)，由task0/采样中断写入，随延迟统计一起输出与重置
+    struct TouchFrameStats {
+        uint32_t full_frames;                            // 所有设备都新鲜的帧
+        uint32_t partial_frames;                         // 至少一个设备过期的帧
+        uint32_t device_stale_frames[MAX_TOUCH_DEVICE];  // 每个设备被判定过期的帧数
+    };
+    inline const TouchFrameStats& getTouchFrameStats() const { return touch_frame_stats_; }
+    inline uint32_t getStaleDeviceBitmap() const { return frame_stale_bitmap_; }  // 最近一帧中过期的设备 (bit = 设备索引)
+    
+    // I2C采样调度统计：每个设备实测的事务耗时与就绪间隔 (指数滑动平均)，调度器据此选择下一个采样设备
+    struct TouchDeviceTiming {
+        uint32_t issue_us;           // 本次采样发起时间
+        uint32_t done_us;            // 上次成功采样完成时间
+        uint32_t next_poll_us;       // 预计就绪/退避结束时间，之前不发起阻塞的就绪查询
+        uint32_t samples;            // 成功采样次数
+        uint32_t not_ready_polls;    // 就绪查询未就绪次数
+        uint32_t failure_total;      // 采样失败次数
+        uint16_t cost_us;            // 发起->完成的事务耗时
+        uint16_t ready_us;           // 完成->再次就绪的间隔
+        uint8_t failures;            // 连续失败次数
+        bool waited;                 // 本次完成后是否出现过未就绪
+    };
+    inline const TouchDeviceTiming& getTouchDeviceTiming(uint8_t device_index) const { return device_timing_[device_index]; }
+    uint32_t getI2CBusFrameCost(uint8_t i2c_bus) const;  // 总线上所有设备各采样一次的预计耗时(us)
+    
+    // 采样遥测：固定RAM计数，窗口量每秒滚动一次 (Core0时间轮)，供触摸状态页与USB命令 "touchstat" 查询
+    // 累计量 (成功/失败采样数、完成时间) 见TouchDeviceTiming
+    struct TouchDeviceTelemetry {
+        uint32_t nacks;                 // 失败采样中设备未应答的次数
+        uint32_t window_busy_us;        // 当前窗口占用总线的时间 (采样事务 + 就绪查询)
+        uint32_t window_cost_us;        // 当前窗口采样事务耗时之和
+        uint16_t window_samples;        // 当前窗口成功采样数
+        uint16_t window_transactions;   // 当前窗口采样事务数 (含失败)
+        uint16_t samples_per_sec;       // 上一窗口成功采样率
+        uint16_t mean_cost_us;          // 上一窗口平均事务耗时
+        uint16_t max_cost_us;           // 最长事务耗时 (重置后)
+    };
+    inline const TouchDeviceTelemetry& getTouchDeviceTelemetry(uint8_t device_index) const { return device_telemetry_[device_index]; }
+    inline uint16_t getI2CBusUtilisation(uint8_t i2c_bus) const { return i2c_bus_busy_permille_[i2c_bus & 1]; }  // 上一窗口总线占用率(‰)
+    uint32_t getTimeSinceLastSample(uint8_t device_index) const;  // 距上次成功采样的时间(ms)，从未成功时返回UINT32_MAX
+    void requestTouchTelemetryDump(bool reset_after = false);     // 由task0通过USB_SerialLogs输出
+    
     // 根据设备ID掩码获取设备名称 - UI显示时调用
     std::string getDeviceNameByMask(uint32_t device_and_channel_mask) const;
     
@@ -416,6 +536,7 @@ public:
     bool addPhysicalKeyboard(MCP_GPIO gpio, HID_KeyCode default_key = HID_KeyCode::KEY_NONE, GPIOTriggerLevel trigger_level = GPIOTriggerLevel::ACTIVE_LOW);
     bool removePhysicalKeyboard(uint8_t gpio_id);
     void clearPhysicalKeyboards();
+    bool setPhysicalKeyboardDebounce(uint8_t gpio_id, GPIODebounceMode mode, uint16_t debounce_us);
     const std::vector<PhysicalKeyboardMapping>& getPhysicalKeyboards() const;
     
     // 触摸键盘映射方法
@@ -429,8 +550,8 @@ public:
     bool removeTouchKeyboardMapping(uint64_t area_mask, HID_KeyCode key);
     const std::vector<TouchKeyboardMapping>& getTouchKeyboardMappings() const;
     
-    // 触摸键盘转换内联接口 - serial模式专用
-    inline void checkTouchKeyboardTrigger();  // 检查触发条件并处理按键状态
+    // 触摸键盘转换接口 - serial模式专用
+    void checkTouchKeyboardTrigger();  // 检查触发条件并处理按键状态 (非inline，供微基准直接调用)
     
     // 通道控制接口
     void enableAllChannels();   // 启用所有通道(绑定时使用)
@@ -448,6 +569,15 @@ public:
     
     // Serial模式新功能接口
     void setSendOnlyOnChange(bool enabled);        // 设置仅改变时发送功能
+    void setGPIOIRQMode(bool enabled);             // 设置按键中断输入模式 (Core1下一轮生效)
+    bool getGPIOIRQMode() const;                   // 获取按键中断输入模式
+    void setPartialFrameEnabled(bool enabled);     // 设置部分帧组帧模式 (task0下一轮生效)
+    bool getPartialFrameEnabled() const;           // 获取部分帧组帧模式
+    void setFrameStaleness(uint8_t staleness_ms);  // 设置设备采样新鲜度上限(1-100ms)
+    uint8_t getFrameStaleness() const;             // 获取设备采样新鲜度上限
+    bool setTouchDeviceIntPin(uint8_t device_id_mask, uint8_t gpio);  // 设置设备就绪中断引脚 (0xFF为轮询，重启后生效)
+    uint8_t getTouchDeviceIntPin(uint8_t device_id_mask);             // 获取设备就绪中断引脚 (0xFF为轮询)
+    bool isTouchDeviceIntActive(uint8_t device_id_mask) const;        // 设备当前是否由INT引脚判断就绪
     bool getSendOnlyOnChange() const;              // 获取仅改变时发送状态
     void setDataAggregationDelay(uint8_t delay_ms); // 设置数据聚合延迟(0-100ms)
     uint8_t getDataAggregationDelay() const;       // 获取数据聚合延迟
@@ -495,6 +625,9 @@ public:
     static bool is_debug_enabled();
     
 private:
+    // 微基准直接测量私有热点内核 (src/benchmark)
+    friend class FirmwareBenchmark;
+
     // 私有构造函数
     InputManager();
     InputManager(const InputManager&) = delete;
@@ -510,22 +643,37 @@ private:
     std::vector<TouchSensor*> touch_sensor_devices_;           // 注册的TouchSensor设备列表
 
     // I2C总线采样stage队列系统
+    // 阶段分配只决定设备所在的槽位和同分值时的轮转顺序，每次由selectSamplingStage按实测代价挑选下一个设备
     struct I2C_SamplingStage {
         TouchSensor* device_instances[4];  // 每个总线4个阶段的设备实例地址 (nullptr表示空)
-        uint8_t current_stage;             // 当前阶段 (0-3)
+        uint8_t device_indices[4];         // 对应touch_sensor_devices_下标 (0xFF表示空)
+        uint8_t current_stage;             // 正在采样/最近一次选中的阶段 (0-3)
         bool stage_locked;                 // 当前阶段是否被锁定(正在采样中)
         
         I2C_SamplingStage() : current_stage(0), stage_locked(false) {
             for (int i = 0; i < 4; i++) {
                 device_instances[i] = nullptr;
+                device_indices[i] = 0xFF;
             }
         }
-
-        void next_stage() {
-            current_stage = (current_stage + 1) % 4;
-        }
     };
     I2C_SamplingStage i2c_sampling_stages_[2];  // 支持I2C0和I2C1两个总线
+    TouchDeviceTiming device_timing_[MAX_TOUCH_DEVICE];  // 每个设备的采样代价统计 (仅Core0访问)
+    TouchDeviceTelemetry device_telemetry_[MAX_TOUCH_DEVICE];  // 每个设备的采样遥测 (Core0写入)
+    uint16_t i2c_bus_busy_permille_[2];
+    uint32_t telemetry_window_start_us_;
+    WheelTimer telemetry_timer_;             // 遥测窗口滚动定时器 (Core0时间轮)
+    volatile bool telemetry_dump_pending_;
+    volatile bool telemetry_reset_pending_;
+    
+    // 就绪中断：INT下降沿 (Core0中断) 置位就绪标志，发起采样时清除；未接INT的设备仍用sample_ready()查询
+    uint8_t touch_int_pins_[MAX_TOUCH_DEVICE];        // 每个设备生效的INT引脚 (0xFF表示轮询)
+    volatile bool touch_int_ready_[MAX_TOUCH_DEVICE];
+    uint8_t touch_int_fallbacks_[MAX_TOUCH_DEVICE];   // 连续回退到查询才就绪的次数，达到上限时锁定为轮询
+    uint32_t touch_int_pin_mask_;                     // 生效INT引脚位图，中断分发用
+    void setupTouchReadyInterrupts();
+    inline bool touchDeviceReady(uint8_t device_index, TouchSensor* device, uint32_t now_us, bool& polled);
+    void latchTouchDevicePolling(uint8_t device_index, TouchSensor* device);
     
     // 设备注册到阶段的接口
     bool registerDeviceToStage(uint8_t stage, uint8_t device_id);
@@ -548,7 +696,14 @@ private:
         TouchDeviceState() : current_touch_mask(0), 
                            previous_touch_mask(0), timestamp_us(0) {}
     };
-    TouchDeviceState touch_device_states_[MAX_TOUCH_DEVICE];          // 每个设备的触摸状态
+    TouchDeviceState touch_device_states_[MAX_TOUCH_DEVICE];          // 每个设备的触摸状态 (仅Core0访问)
+    
+    // 完整采样帧的触摸掩码快照，Core0在所有设备完成采样后发布，供task1/UI跨核读取
+    struct TouchFrameSnapshot {
+        uint32_t touch_masks[MAX_TOUCH_DEVICE];
+        TouchFrameSnapshot() : touch_masks{0} {}
+    };
+    SeqLock<TouchFrameSnapshot> touch_frame_;
     
     // 统一使用TouchDeviceState
 
@@ -557,102 +712,114 @@ private:
     static constexpr uint16_t DELAY_BUFFER_SIZE = 512;  // 扩充缓冲区大小，支持更长延迟和更多数据
     struct DelayedSerialState {
         uint32_t timestamp_us;                          // 时间戳（微秒）
+        uint32_t sample_us;                             // 本帧最早完成的I2C采样时间戳
         Mai2Serial_TouchState serial_touch_state;      // Serial触摸状态
     };
     
-    // 新增：投票聚合状态结构体（按位投票）
+    // 投票聚合状态结构体（按位投票，位切片纵向计数器）
+    // count_planes[k] 的第b位是区域b计数值的第k位，一次加/减样本只需少量64位字运算即可更新全部35个区域
+    static constexpr uint8_t VOTING_COUNTER_BITS = 10;  // 计数上限1023，覆盖DELAY_BUFFER_SIZE个样本
+    static constexpr uint64_t VOTING_AREA_MASK = 0x7FFFFFFFFULL;  // 35位有效区域
     struct VotingAggregationState {
-        uint16_t ones_count_state1[32];     // state1各位的1计数
-        uint16_t ones_count_state2[32];     // state2各位的1计数（仅低3位有效）
-        uint16_t total_samples;             // 聚合窗口内样本数
+        uint64_t count_planes[VOTING_COUNTER_BITS];  // 纵向计数器位平面
+        uint16_t total_samples;                      // 聚合窗口内样本数
 
-        VotingAggregationState() : ones_count_state1{0}, ones_count_state2{0}, total_samples(0) {}
+        VotingAggregationState() : count_planes{0}, total_samples(0) {}
 
         inline void reset() {
-            // 使用循环清零，避免memset潜在的未对齐问题
-            for (int i = 0; i < 32; ++i) {
-                ones_count_state1[i] = 0;
-                ones_count_state2[i] = 0;
+            for (uint8_t k = 0; k < VOTING_COUNTER_BITS; ++k) {
+                count_planes[k] = 0;
             }
             total_samples = 0;
         }
 
-        // 单样本累加：对每位进行计数
-        inline void accumulate(uint32_t state1_bits, uint32_t state2_bits) {
-            // 逐位计数，保证按位多数投票
-            for (int b = 0; b < 32; ++b) {
-                if (state1_bits & (1u << b)) ones_count_state1[b]++;
-            }
-            for (int b = 0; b < 32; ++b) {
-                if (state2_bits & (1u << b)) ones_count_state2[b]++;
+        // 样本进入窗口：纵向行波进位加1
+        inline void accumulate(uint64_t bits) {
+            uint64_t carry = bits & VOTING_AREA_MASK;
+            for (uint8_t k = 0; k < VOTING_COUNTER_BITS && carry; ++k) {
+                const uint64_t next = count_planes[k] & carry;
+                count_planes[k] ^= carry;
+                carry = next;
             }
             total_samples++;
         }
 
-        // 批量累加：遍历数组并调用单样本累加
-        inline void accumulateBatch(const uint32_t* state1_array, const uint32_t* state2_array, uint32_t count) {
-            for (uint32_t i = 0; i < count; ++i) {
-                accumulate(state1_array[i], state2_array[i]);
+        // 样本离开窗口：纵向行波借位减1 (调用方保证该样本此前已累加)
+        inline void remove(uint64_t bits) {
+            uint64_t borrow = bits & VOTING_AREA_MASK;
+            for (uint8_t k = 0; k < VOTING_COUNTER_BITS && borrow; ++k) {
+                const uint64_t next = ~count_planes[k] & borrow;
+                count_planes[k] ^= borrow;
+                borrow = next;
             }
+            total_samples--;
         }
 
-        // 获取投票结果（按位多数；平票取上次结果反向）
-        inline void getVotingResult(uint32_t& result_state1, uint32_t& result_state2,
-                                    const Mai2Serial_TouchState& last_emitted) const {
-            uint32_t r1 = 0, r2 = 0;
+        // 获取投票结果（按位多数；平票取上次结果反向；无样本沿用上次结果）
+        // 与 total_samples/2 做位切片比较：高位向低位逐平面求出 "大于" 与 "等于" 掩码
+        inline uint64_t getVotingResult(const Mai2Serial_TouchState& last_emitted) const {
             if (total_samples == 0) {
-                // 无样本则不更改（由调用方决定是否沿用之前状态）
-                result_state1 = last_emitted.parts.state1;
-                result_state2 = last_emitted.parts.state2;
-                return;
+                return last_emitted.raw & VOTING_AREA_MASK;
             }
-            for (int b = 0; b < 32; ++b) {
-                uint16_t ones = ones_count_state1[b];
-                uint16_t zeros = static_cast<uint16_t>(total_samples - ones);
-                if (ones > zeros) {
-                    r1 |= (1u << b);
-                } else if (ones < zeros) {
-                    // 保持0
+            const uint16_t half = total_samples >> 1;
+            uint64_t greater = 0;
+            uint64_t equal = VOTING_AREA_MASK;
+            for (int8_t k = VOTING_COUNTER_BITS - 1; k >= 0; --k) {
+                if (half & (1u << k)) {
+                    equal &= count_planes[k];
                 } else {
-                    // 平票取上次结果的反向
-                    if ((last_emitted.parts.state1 & (1u << b)) == 0) {
-                        r1 |= (1u << b);
-                    }
+                    greater |= equal & count_planes[k];
+                    equal &= ~count_planes[k];
                 }
             }
-            for (int b = 0; b < 32; ++b) {
-                uint16_t ones = ones_count_state2[b];
-                uint16_t zeros = static_cast<uint16_t>(total_samples - ones);
-                if (ones > zeros) {
-                    r2 |= (1u << b);
-                } else if (ones < zeros) {
-                    // 保持0
-                } else {
-                    if ((last_emitted.parts.state2 & (1u << b)) == 0) {
-                        r2 |= (1u << b);
-                    }
-                }
+            // 奇数样本不会平票；偶数样本时 ones == half 即平票
+            if (total_samples & 1) {
+                return greater;
             }
-            result_state1 = r1;
-            result_state2 = r2;
+            return greater | (equal & ~last_emitted.raw & VOTING_AREA_MASK);
         }
     };
     
     // 新增：processSerialModeWithDelay静态变量管理结构体
     struct SerialModeDelayState {
-        uint16_t last_hit_offset;                    // 上次命中偏移量
         Mai2Serial_TouchState last_emitted_result;   // 上次发出的结果（用于平票时取反向）
         VotingAggregationState voting_state;        // 投票聚合状态
+        // 滑动聚合窗口，以帧序号表示 [window_begin_seq, window_end_seq)
+        uint32_t window_begin_seq;
+        uint32_t window_end_seq;
+        uint32_t window_start_time;                  // 上次窗口起始时间，回退时需重建
+        bool window_valid;                           // 窗口与计数器是否一致
         
-        SerialModeDelayState() : last_hit_offset(0) {
+        SerialModeDelayState() : window_begin_seq(0), window_end_seq(0),
+                                 window_start_time(0), window_valid(false) {
             last_emitted_result.raw = 0;
         }
     };
     
+    // 串口区域编译表：[模块行][通道] -> 区域位 (bit = 区域-1)，映射变化后在Core0组帧前重建
+    uint64_t serial_area_table_[MAPPING_TABLE_DEVICES][24];
+    uint8_t serial_area_modules_[MAPPING_TABLE_DEVICES];  // 每行对应的8位模块掩码
+    uint8_t serial_area_module_count_;                  // 编译表中有效的行数
+    
+    // 无法单通道查表的映射 (多通道组合或仅模块)，按原逻辑逐项比较
+    struct SerialComboMapping {
+        uint32_t channel;                               // 完整物理通道地址 (高8位模块掩码)
+        uint8_t area_idx;
+    };
+    SerialComboMapping serial_combo_mappings_[34];
+    uint8_t serial_combo_count_;
+    
+    // HID坐标编译表：[模块行][通道] -> 预转换的HID坐标 (x<<16 | y)，在task1中按需重建
+    uint32_t hid_coord_table_[MAPPING_TABLE_DEVICES][24];
+    uint32_t hid_coord_valid_[MAPPING_TABLE_DEVICES];     // 每行已映射坐标的通道掩码
+    uint8_t hid_coord_modules_[MAPPING_TABLE_DEVICES];    // 每行对应的8位模块掩码
+    uint8_t hid_coord_module_count_;
+    
     // 新增：设备采样完成状态bitmap结构体
     DelayedSerialState delay_buffer_[DELAY_BUFFER_SIZE]; // 延迟缓冲区
     uint16_t delay_buffer_head_;                        // 缓冲区头指针
     uint16_t delay_buffer_count_;                       // 缓冲区中的有效数据数量
+    uint32_t delay_buffer_seq_;                         // 累计写入帧数 (帧序号，回绕安全)
     
     // 新增：静态状态管理实例
     static SerialModeDelayState serial_delay_state_;    // processSerialModeWithDelay静态状态
@@ -664,11 +831,10 @@ private:
     uint32_t mcu_gpio_previous_states_;      // MCU GPIO上一次状态
     
     // Serial状态桥梁变量 - 用于触摸键盘转换
-    Mai2Serial_TouchState serial_state_;    // 当前Serial触摸状态，作为task0和task1之间的桥梁
+    SeqLock<Mai2Serial_TouchState> serial_state_;  // 当前Serial触摸状态，task0发布、task1读取快照
     
     // 触摸键盘缓存变量
     mutable uint32_t touch_keyboard_current_time_cache_; // 当前时间缓存
-    mutable bool touch_keyboard_areas_matched_cache_;    // 区域匹配结果缓存
     mutable bool touch_keyboard_hold_satisfied_cache_;   // 长按时间满足缓存
     
     // 采样频率测量相关
@@ -676,6 +842,22 @@ private:
     uint32_t last_reset_time_;          // 上次重置时间
     uint32_t current_sample_rate_;      // 当前采样频率
     
+    // 触摸轨迹录制器
+    TouchTraceRecorder touch_trace_;
+    TouchRawStream touch_raw_stream_;
+    
+    // 触摸延迟统计
+    LatencyHistogram touch_latency_[static_cast<uint8_t>(TouchLatencyStage::COUNT)];
+    uint32_t frame_sample_us_;               // 当前采样轮最早完成的采样时间戳
+    volatile bool latency_dump_pending_;     // 延迟统计输出请求
+    volatile bool latency_reset_pending_;    // 延迟统计重置请求
+    
+    // 部分帧组帧
+    WheelTimer frame_timer_;                 // 组帧节拍定时器 (Core0时间轮)，新鲜设备迟迟不齐时按节拍出帧
+    uint32_t last_frame_us_;                 // 上一帧写入延迟缓冲的时间
+    uint32_t frame_stale_bitmap_;            // 最近一帧中过期的设备
+    TouchFrameStats touch_frame_stats_;
+    
     // 绑定相关私有成员变量
     bool binding_active_;
     InteractiveBindingCallback binding_callback_;
@@ -718,22 +900,87 @@ private:
     MCP23S17_GPIO_State mcp_gpio_previous_states_; // MCP GPIO上一次状态
     
     // GPIO处理缓存变量（避免高频函数中的内存分配）
-    mutable uint32_t gpio_mcu_changed_;      // MCU GPIO变化位图缓存
     mutable uint32_t gpio_mcu_inverted_;     // MCU GPIO反转位图缓存
-    mutable uint16_t gpio_mcp_changed_a_;    // MCP GPIO Port A变化位图缓存
-    mutable uint16_t gpio_mcp_changed_b_;    // MCP GPIO Port B变化位图缓存
     mutable uint16_t gpio_mcp_inverted_a_;   // MCP GPIO Port A反转位图缓存
     mutable uint16_t gpio_mcp_inverted_b_;   // MCP GPIO Port B反转位图缓存
-    mutable const PhysicalKeyboardMapping* gpio_mappings_cache_;     // 物理键盘映射指针缓存
-    mutable size_t gpio_mapping_count_cache_;                        // 物理键盘映射数量缓存
     mutable const LogicalKeyMapping* gpio_logical_mappings_cache_;   // 逻辑键盘映射指针缓存
     mutable size_t gpio_logical_count_cache_;                        // 逻辑键盘映射数量缓存
-    mutable uint8_t gpio_pin_cache_;         // GPIO引脚号缓存
-    mutable uint8_t gpio_pin_num_cache_;     // GPIO引脚编号缓存
-    mutable uint8_t gpio_bit_pos_cache_;     // GPIO位位置缓存
-    mutable bool gpio_current_state_cache_;  // GPIO当前状态缓存
-    mutable const PhysicalKeyboardMapping* gpio_mapping_ptr_cache_;  // 当前映射指针缓存
-    mutable const HID_KeyCode* gpio_keys_ptr_cache_;                 // 当前按键指针缓存
+    
+    // 键盘分发表：映射变化时由compileKeyboardDispatch()把物理/逻辑/触摸键盘映射编译为连续数组，
+    // 轮询路径只访问这些数组，不再遍历配置容器
+    // 输入位布局：MCU GPIO 0-29 -> bit 0-29，MCP Port A -> bit 32-39，MCP Port B -> bit 40-47
+    static constexpr uint8_t GPIO_INPUT_BITS = 48;
+    static constexpr uint8_t MAX_GPIO_DISPATCH_ENTRIES = GPIO_INPUT_BITS * 4;  // 每个输入位：1个物理键 + 3个逻辑键
+
+    enum KeyboardDispatchFlags : uint8_t {
+        KEYBOARD_DISPATCH_ACTIVE_LOW   = 1 << 0,  // 低电平有效 (输入位需翻转)
+        KEYBOARD_DISPATCH_LOGICAL      = 1 << 1,  // 来自逻辑键映射
+        KEYBOARD_DISPATCH_TRIGGER_ONCE = 1 << 2,  // 触摸键盘：同一次触摸只触发一次
+    };
+
+    // GPIO分发项：输入位 -> 按键位；key_bit为0表示该输入位只占位 (物理映射未指定按键)
+    struct KeyboardDispatchEntry {
+        uint8_t input_bit;
+        uint8_t key_bit;
+        uint8_t flags;
+    };
+
+    // 触摸键盘分发项：输入为区域组合掩码，全部区域按下时触发
+    struct TouchKeyboardDispatchEntry {
+        uint64_t area_mask;
+        uint32_t hold_time_ms;
+        uint8_t key_bit;
+        uint8_t flags;
+    };
+
+    // 触摸键盘运行时状态，与分发项一一对应
+    struct TouchKeyboardDispatchState {
+        uint32_t press_timestamp;             // 按下时间戳（毫秒），0表示未按下
+        TouchKeyboard_TriggleStage stage;     // trigger_once模式的触发阶段
+        bool key_pressed;                     // 当前按键是否处于按下状态
+    };
+
+    KeyboardDispatchEntry gpio_dispatch_entries_[MAX_GPIO_DISPATCH_ENTRIES];  // 按输入位排序
+    uint8_t gpio_dispatch_offsets_[GPIO_INPUT_BITS + 1];  // 输入位b的分发项区间为[offsets[b], offsets[b+1])
+    uint8_t gpio_dispatch_count_;
+    uint64_t gpio_mapped_inputs_;            // 存在映射的输入位
+
+    // 按键消抖：按输入位维护已上报电平与定时截止时间，时间戳来自采样时刻 (中断模式下为边沿时刻)
+    uint32_t gpio_sample_time_us_;                    // 当前输入快照的采样时间
+    uint64_t gpio_debounced_inputs_;                  // 消抖后的输入电平 (已上报)
+    uint64_t gpio_debounce_eager_;                    // 即时消抖的输入位
+    uint64_t gpio_debounce_defer_;                    // 延迟消抖的输入位
+    uint64_t gpio_debounce_pending_;                  // 定时进行中的输入位 (锁定期或等待稳定)
+    uint16_t gpio_debounce_us_[GPIO_INPUT_BITS];      // 每个输入位的消抖时间
+    uint32_t gpio_debounce_deadline_[GPIO_INPUT_BITS]; // 每个输入位的定时截止时间
+
+    // 按键中断输入模式：边沿中断记录时间戳与电平快照，Core1主循环按顺序消费
+    // 中断与主循环同在Core1，短按在两次主循环之间按下又松开也不会丢失
+    struct GPIOEdgeEvent {
+        uint32_t timestamp_us;             // 边沿时间
+        uint32_t mcu_states;               // 中断时刻的MCU输入电平
+        MCP23S17_GPIO_State mcp_states;    // 中断时刻已知的MCP输入电平
+    };
+    SpscRing<GPIOEdgeEvent, 32> gpio_edge_events_;
+    MCP23S17_GPIO_State gpio_irq_mcp_states_;  // 中断侧维护的MCP最新电平
+    uint64_t gpio_irq_inputs_;                 // 当前已使能边沿中断的输入位
+    uint8_t mcp_int_pin_;                      // MCP23S17 INT引脚，0xFF表示未连接 (MCP输入退回轮询)
+    bool gpio_irq_active_;
+    volatile bool gpio_edge_overflow_;         // 事件队列溢出或刚切换模式，需要整体重采样
+    volatile bool mcp_read_pending_;           // MCP中断到达时SPI总线被占用，等待主循环补读
+
+    TouchKeyboardDispatchEntry touch_dispatch_entries_[MAX_TOUCH_KEYBOARD_MAPPINGS];
+    TouchKeyboardDispatchState touch_dispatch_states_[MAX_TOUCH_KEYBOARD_MAPPINGS];
+    uint8_t touch_dispatch_count_;
+    uint32_t touch_dispatch_active_;         // 运行时状态非空闲的触摸分发项 (位i对应第i项)
+
+    // 触摸键盘事件驱动：只在区域状态变化、长按到期或单次触发待松开时处理相关分发项
+    uint32_t touch_area_dispatch_[34];       // 区域 -> 引用该区域的分发项位图
+    uint64_t touch_dispatch_touched_;        // 上一次处理的区域状态
+    uint32_t touch_dispatch_waiting_;        // 区域已匹配、等待长按时间的分发项
+    uint32_t touch_dispatch_release_next_;   // trigger_once已按下、下一轮松开的分发项
+    WheelTimer touch_hold_timer_;            // 等待项中最早的长按到期定时器 (Core1时间轮)
+    bool touch_hold_expired_;                // 长按定时器已到期，下一轮处理全部等待项
 
     // Serial模式新功能状态变量
     Mai2Serial_TouchState last_sent_serial_state_;                   // 上次发送的Serial状态（用于仅改变时发送）
@@ -742,8 +989,14 @@ private:
 
     // 内部函数   // 内部处理函数
     inline void updateTouchStates();
+    inline int8_t selectSamplingStage(uint8_t bus, uint32_t now_us) const;  // 按实测代价选择总线上下一个采样阶段，-1表示本轮不采样
+    inline void recordSampleTiming(uint8_t device_index, bool success, uint32_t now_us);  // 更新设备采样代价统计
+    void resetSamplingSchedule();                // 设备或阶段变化后重置调度统计
+    static void onTelemetryTimer(void* context); // 滚动采样遥测窗口 (Core0时间轮)
+    void processTouchTelemetryRequests();        // 处理遥测输出/重置请求（在task0中调用）
+    static uint8_t findStageDeviceIndex(const std::vector<TouchSensor*>& devices, TouchSensor* device);
     inline void updateAutoCalibrationControl();  // 处理自动校准控制
-    inline void sendHIDTouchData();
+    void sendHIDTouchData();                     // HID触点发送 (非inline，供微基准直接调用)
     void processCalibrationRequest();               // 处理校准请求（在task0中调用）
     
     // 异步采样相关函数
@@ -753,9 +1006,20 @@ private:
     inline void processSensitivityRequests();                     // 处理灵敏度设置请求（在task0中调用）
     
     // 触摸响应延迟管理私有方法
-    inline void storeDelayedSerialState();                     // 存储当前Serial状态到延迟缓冲区
+    void storeDelayedSerialState();                            // 存储当前Serial状态到延迟缓冲区 (非inline，供微基准直接调用)
+    void rebuildSerialAreaTable();                             // 由serial_mappings重建通道->区域编译表
+    void rebuildHIDCoordTable();                               // 由hid_mappings重建通道->HID坐标编译表
+    void publishTouchFrame();                                  // 发布完整帧触摸快照供跨核读取
+    inline void emitTouchFrame();                              // 写入延迟缓冲并发布快照，开始下一轮组帧
+    void assemblePartialFrame(uint32_t now_us, bool cadence);  // 部分帧模式：按设备新鲜度决定是否出帧
+    inline void updateFrameTimer();                            // 按配置启动/停止组帧节拍定时器
+    static void onFrameTimer(void* context);                   // 组帧节拍回调 (Core0时间轮)
 
     inline void processSerialModeWithDelay();          // 带延迟的Serial模式处理
+    bool findDelayedFrame(uint32_t target_time, uint16_t &buffer_idx) const;            // 二分查找延迟目标帧 (非inline，供微基准直接调用)
+    uint64_t updateVotingWindow(uint16_t end_idx, uint32_t window_start_time);         // 滑动更新聚合窗口并返回投票结果 (非inline，供微基准直接调用)
+    inline void recordTouchLatency(const DelayedSerialState& frame, uint32_t select_us);  // 记录已发出帧的各阶段延迟
+    void processTouchLatencyRequests();                // 处理延迟统计输出/重置请求（在task0中调用）
     
     // 通道mask辅助函数
     static uint32_t generateChannelMask(uint8_t ic_id, uint8_t channel) {
@@ -783,11 +1047,25 @@ private:
 
     // GPIO键盘处理函数
     inline void updateGPIOStates();          // 更新GPIO状态
-    inline void processGPIOKeyboard();       // 处理GPIO键盘输入
+    void processGPIOKeyboard();              // 处理GPIO键盘输入 (非inline，供微基准直接调用)
+    inline uint64_t debounceGPIOInputs(uint64_t inputs, uint64_t previous_inputs); // 按键消抖，返回消抖后的输入电平
+    void applyGPIOIRQMode();                 // 按配置与当前映射使能/关闭边沿中断 (必须在Core1调用)
+    void processGPIOEdgeEvents();            // 中断模式：消费边沿事件并补读MCP
+    void onGPIOEdge(uint8_t gpio);           // 边沿中断处理 (中断上下文)
+    static void gpioIRQHandler(unsigned int gpio, uint32_t events);
     inline void processTouchKeyboard();      // 处理触摸键盘映射
 
     // 优化与校验辅助函数
-    inline void rebuildGPIOInversionMasks(); // 基于映射重建MCU/MCP反转位图
+    static void onTouchHoldTimer(void* context);
+    inline void evaluateTouchKeyboardEntry(uint8_t index, uint64_t touched, uint32_t now_ms); // 处理单个触摸分发项
+    void compileKeyboardDispatch();          // 编译键盘分发表并派生反转位图 (映射变化时调用)
+    static inline uint8_t getGPIOInputBit(uint8_t gpio);  // GPIO编码 -> 输入位
+    // MCU与MCP电平合并为输入字 (布局同分发表输入位)
+    static inline uint64_t combineGPIOInputs(uint32_t mcu_states, const MCP23S17_GPIO_State &mcp_states) {
+        return mcu_states
+            | (static_cast<uint64_t>(mcp_states.port_a) << 32)
+            | (static_cast<uint64_t>(mcp_states.port_b) << 40);
+    }
     inline void sanityCheckPhysicalKeyboard(const PhysicalKeyboardMapping& mapping); // 新增映射时进行电平有效性检查
 
     // 32位物理通道地址处理辅助函数
@@ -831,53 +1109,7 @@ private:
             : device_id(dev_id), channel(ch), sensitivity(sens) {}
     };
     
-    struct SensitivityRequestBuffer {
-        static constexpr uint8_t BUFFER_SIZE = 32;
-        SensitivityRequest requests[BUFFER_SIZE];   // 环形缓冲区数组
-        volatile uint8_t head;                      // 头指针（UI写入，task0读取）
-        volatile uint8_t tail;                      // 尾指针（task0写入，UI读取）
-        
-        SensitivityRequestBuffer() : head(0), tail(0) {}
-        
-        // UI侧：推送请求到缓冲区（CPU1调用）
-        bool pushRequest(uint8_t device_id, uint8_t channel, uint8_t sensitivity) {
-            uint8_t next_head = (head + 1) % BUFFER_SIZE;
-            if (next_head == tail) {
-                return false; // 缓冲区满
-            }
-            
-            requests[head] = SensitivityRequest(device_id, channel, sensitivity);
-            head = next_head;
-            return true;
-        }
-        
-        // task0侧：从缓冲区获取请求（CPU0调用）
-        bool popRequest(SensitivityRequest& request) {
-            if (head == tail) {
-                return false; // 缓冲区空
-            }
-            
-            request = requests[tail];
-            tail = (tail + 1) % BUFFER_SIZE;
-            return true;
-        }
-        
-        // 检查缓冲区是否有数据
-        bool hasData() const {
-            return head != tail;
-        }
-        
-        // 获取缓冲区中的数据数量
-        uint8_t getDataCount() const {
-            if (head >= tail) {
-                return head - tail;
-            } else {
-                return BUFFER_SIZE - tail + head;
-            }
-        }
-    };
-    
-    SensitivityRequestBuffer sensitivity_request_buffer_;  // 异步灵敏度设置缓冲区
+    SpscRing<SensitivityRequest, 32> sensitivity_request_buffer_;  // 异步灵敏度设置缓冲区 (UI写入，task0读取)
     
     const char* getMai2AreaName(Mai2_TouchArea area);
 };
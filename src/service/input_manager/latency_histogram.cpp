@@ -0,0 +1,38 @@
+#include "latency_histogram.h"
+#include <cstring>
+
+void LatencyHistogram::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    max_us_ = 0;
+    sum_us_ = 0;
+}
+
+uint32_t LatencyHistogram::bucket_upper_bound(uint8_t index) {
+    if (index < LATENCY_HISTOGRAM_SUB_COUNT) {
+        return index;
+    }
+    // 桶下界为 (8 + 子桶号) << (指数 - 3)，宽度为 1 << (指数 - 3)
+    uint32_t exponent = index / LATENCY_HISTOGRAM_SUB_COUNT + LATENCY_HISTOGRAM_SUB_BITS - 1;
+    uint32_t mantissa = LATENCY_HISTOGRAM_SUB_COUNT + (index & (LATENCY_HISTOGRAM_SUB_COUNT - 1));
+    uint32_t shift = exponent - LATENCY_HISTOGRAM_SUB_BITS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t percent) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    // 目标名次向上取整，保证p100落在最大值所在的桶
+    uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(count_) * percent + 99) / 100);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            uint32_t upper = bucket_upper_bound(i);
+            return upper < max_us_ ? upper : max_us_;
+        }
+    }
+    return max_us_;
+}
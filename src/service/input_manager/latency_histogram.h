@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * 延迟直方图 - 固定内存的对数分桶统计
+ * 每个2的幂区间再细分为8个子桶，相对误差不超过12.5%，覆盖 0 ~ 约524ms (微秒单位)。
+ * record() 仅做一次 clz 与一次自增，可在采样/发送热路径中直接调用。
+ */
+
+#define LATENCY_HISTOGRAM_SUB_BITS 3
+#define LATENCY_HISTOGRAM_SUB_COUNT (1u << LATENCY_HISTOGRAM_SUB_BITS)
+#define LATENCY_HISTOGRAM_BUCKETS 136   // (18 - 2 + 1) * 8
+
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    void reset();
+
+    inline void record(uint32_t value_us) {
+        buckets_[bucket_index(value_us)]++;
+        count_++;
+        sum_us_ += value_us;
+        if (value_us > max_us_) max_us_ = value_us;
+    }
+
+    // 百分位数 (取所在桶的上界，不超过最大值)，无样本时返回0
+    uint32_t percentile(uint8_t percent) const;
+
+    inline uint32_t count() const { return count_; }
+    inline uint32_t max_us() const { return max_us_; }
+    inline uint32_t mean_us() const { return count_ ? static_cast<uint32_t>(sum_us_ / count_) : 0; }
+
+private:
+    uint32_t buckets_[LATENCY_HISTOGRAM_BUCKETS];
+    uint32_t count_;
+    uint32_t max_us_;
+    uint64_t sum_us_;
+
+    static inline uint8_t bucket_index(uint32_t value) {
+        if (value < LATENCY_HISTOGRAM_SUB_COUNT) {
+            return static_cast<uint8_t>(value);
+        }
+        uint32_t exponent = 31 - __builtin_clz(value);
+        uint32_t index = (exponent - LATENCY_HISTOGRAM_SUB_BITS + 1) * LATENCY_HISTOGRAM_SUB_COUNT
+                       + ((value >> (exponent - LATENCY_HISTOGRAM_SUB_BITS)) & (LATENCY_HISTOGRAM_SUB_COUNT - 1));
+        return index < LATENCY_HISTOGRAM_BUCKETS ? static_cast<uint8_t>(index) : LATENCY_HISTOGRAM_BUCKETS - 1;
+    }
+
+    static uint32_t bucket_upper_bound(uint8_t index);
+};
@@ -0,0 +1,180 @@
+#include "touch_raw_stream.h"
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <hardware/sync.h>
+#include "../../protocol/usb_serial_logs/usb_serial_logs.h"
+
+TouchRawStream::TouchRawStream()
+    : active_(false), module_filter_(0), stage_mask_(0), decimation_(1), seq_(0),
+      decimation_slots_(0), restart_pending_(false), frames_sent_(0), frames_dropped_(0) {
+    memset(decimation_masks_, 0, sizeof(decimation_masks_));
+    memset(decimation_counts_, 0, sizeof(decimation_counts_));
+}
+
+void TouchRawStream::start(uint8_t module_filter, uint16_t stage_mask, uint8_t decimation) {
+    active_ = false;
+    module_filter_ = module_filter;
+    stage_mask_ = stage_mask & ((1u << TOUCH_RAW_STREAM_MAX_VALUES) - 1);
+    decimation_ = decimation ? decimation : 1;
+    frames_sent_ = 0;
+    frames_dropped_ = 0;
+    restart_pending_ = true;
+    __dmb();
+    active_ = true;
+}
+
+void TouchRawStream::stop() {
+    active_ = false;
+}
+
+// 取出一个以空格分隔的数字字段，要求整段都是合法数字 (不接受符号)
+static bool parse_field(const char*& cursor, int base, unsigned long max_value, unsigned long& value) {
+    while (*cursor == ' ') {
+        cursor++;
+    }
+    if (!isxdigit(static_cast<unsigned char>(*cursor))) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtoul(cursor, &end, base);
+    if (end == cursor || (*end && *end != ' ') || value > max_value) {
+        return false;
+    }
+    cursor = end;
+    return true;
+}
+
+bool TouchRawStream::parse_args(const char* args, uint8_t& module_filter, uint16_t& stage_mask, uint8_t& decimation) {
+    const char* cursor = args;
+    unsigned long module = 0;
+    if (strncmp(cursor, "all", 3) == 0 && (cursor[3] == '\0' || cursor[3] == ' ')) {
+        cursor += 3;
+    } else if (!parse_field(cursor, 16, 0xFF, module) || module == 0) {
+        return false;
+    }
+
+    unsigned long stages = (1u << TOUCH_RAW_STREAM_MAX_VALUES) - 1;
+    unsigned long step = 1;
+    while (*cursor == ' ') {
+        cursor++;
+    }
+    if (*cursor) {
+        if (!parse_field(cursor, 16, (1u << TOUCH_RAW_STREAM_MAX_VALUES) - 1, stages) || stages == 0) {
+            return false;
+        }
+        while (*cursor == ' ') {
+            cursor++;
+        }
+        if (*cursor && (!parse_field(cursor, 10, 0xFF, step) || step == 0)) {
+            return false;
+        }
+        while (*cursor == ' ') {
+            cursor++;
+        }
+        if (*cursor) {
+            return false;
+        }
+    }
+
+    module_filter = static_cast<uint8_t>(module);
+    stage_mask = static_cast<uint16_t>(stages);
+    decimation = static_cast<uint8_t>(step);
+    return true;
+}
+
+void TouchRawStream::record(uint8_t module_mask, uint32_t timestamp_us, const uint16_t* values, uint8_t count) {
+    if (!accepts(module_mask) || !values || count == 0) {
+        return;
+    }
+    if (restart_pending_) {
+        restart_pending_ = false;
+        decimation_slots_ = 0;
+        seq_ = 0;
+    }
+
+    // 按设备抽取
+    uint8_t slot = 0;
+    while (slot < decimation_slots_ && decimation_masks_[slot] != module_mask) {
+        slot++;
+    }
+    if (slot == decimation_slots_) {
+        if (slot >= TOUCH_RAW_STREAM_MAX_MODULES) {
+            return;
+        }
+        decimation_masks_[slot] = module_mask;
+        decimation_counts_[slot] = 0;
+        decimation_slots_++;
+    }
+    if (decimation_counts_[slot]) {
+        decimation_counts_[slot]--;
+        return;
+    }
+    decimation_counts_[slot] = decimation_ - 1;
+
+    TouchRawStreamRecord record;
+    record.timestamp_us = timestamp_us;
+    record.module_mask = module_mask;
+    record.seq = seq_++;
+    record.stage_mask = stage_mask_ & ((1u << (count < TOUCH_RAW_STREAM_MAX_VALUES ? count : TOUCH_RAW_STREAM_MAX_VALUES)) - 1);
+    uint8_t n = 0;
+    for (uint16_t stages = record.stage_mask; stages; stages &= stages - 1) {
+        record.values[n++] = values[__builtin_ctz(stages)];
+    }
+    if (!queue_.push(record)) {
+        frames_dropped_++;
+    }
+}
+
+uint32_t TouchRawStream::drain(USB_SerialLogs& logs) {
+    uint32_t sent = 0;
+    uint8_t frame[TOUCH_RAW_STREAM_MAX_FRAME_SIZE];
+    TouchRawStreamRecord record;
+    while (queue_.peek(record)) {
+        const size_t length = encode(record, frame);
+        if (logs.get_write_available() < length) {
+            break;
+        }
+        queue_.pop(record);
+        if (!logs.write_raw(frame, length)) {
+            break;
+        }
+        frames_sent_++;
+        sent++;
+    }
+    return sent;
+}
+
+size_t TouchRawStream::encode(const TouchRawStreamRecord& record, uint8_t* frame) {
+    const uint8_t value_count = static_cast<uint8_t>(__builtin_popcount(record.stage_mask));
+    uint8_t* p = frame;
+    *p++ = TOUCH_RAW_STREAM_SYNC0;
+    *p++ = TOUCH_RAW_STREAM_SYNC1;
+    *p++ = TOUCH_RAW_STREAM_FRAME_CDC;
+    *p++ = static_cast<uint8_t>(8 + value_count * 2);
+    *p++ = static_cast<uint8_t>(record.timestamp_us);
+    *p++ = static_cast<uint8_t>(record.timestamp_us >> 8);
+    *p++ = static_cast<uint8_t>(record.timestamp_us >> 16);
+    *p++ = static_cast<uint8_t>(record.timestamp_us >> 24);
+    *p++ = record.module_mask;
+    *p++ = record.seq;
+    *p++ = static_cast<uint8_t>(record.stage_mask);
+    *p++ = static_cast<uint8_t>(record.stage_mask >> 8);
+    for (uint8_t i = 0; i < value_count; i++) {
+        *p++ = static_cast<uint8_t>(record.values[i]);
+        *p++ = static_cast<uint8_t>(record.values[i] >> 8);
+    }
+    *p = crc8(frame + 2, p - frame - 2);
+    return p - frame + 1;
+}
+
+uint8_t TouchRawStream::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
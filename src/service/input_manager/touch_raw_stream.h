@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../hal/cross_core.h"
+
+class USB_SerialLogs;
+
+/**
+ * 原始CDC数据流 (Raw Stream)
+ * 把传感器随采样一起读回的原始电容值 (AD7147各阶段CDC) 带时间戳推送到USB CDC，供主机离线分析噪声与漂移。
+ * 不经过字符串日志：Core0在I2C采样完成回调中把原始值写入跨核环形队列，Core1编码成二进制帧后直接写CDC，
+ * CDC发送缓冲不足时留在队列中等待，不阻塞主循环；队列满时丢弃并计入帧序号。
+ *
+ * 帧格式 (小端):
+ *   uint8   0xA5, 0x5A                 同步字
+ *   uint8   type                       TOUCH_RAW_STREAM_FRAME_CDC
+ *   uint8   length                     payload长度
+ *   payload:
+ *     uint32  timestamp_us             采样完成时间
+ *     uint8   module_mask              设备ID掩码
+ *     uint8   seq                      帧序号 (全局递增，含被丢弃的帧，主机据此统计丢帧)
+ *     uint16  stage_mask               payload中包含的阶段
+ *     uint16  values[popcount(stage_mask)]  按阶段号升序
+ *   uint8   crc8                       type..payload 的CRC-8 (多项式0x07)
+ * 日志文本与数据帧共用同一CDC端口，主机按同步字+CRC重新对齐即可跳过文本。
+ */
+
+#define TOUCH_RAW_STREAM_SYNC0 0xA5
+#define TOUCH_RAW_STREAM_SYNC1 0x5A
+#define TOUCH_RAW_STREAM_FRAME_CDC 0x01
+#define TOUCH_RAW_STREAM_MAX_VALUES 12
+#define TOUCH_RAW_STREAM_QUEUE_SIZE 64
+#define TOUCH_RAW_STREAM_MAX_MODULES 8
+#define TOUCH_RAW_STREAM_MAX_FRAME_SIZE (4 + 8 + TOUCH_RAW_STREAM_MAX_VALUES * 2 + 1)
+#define TOUCH_RAW_STREAM_USAGE "rawstream <设备掩码hex|all> [阶段掩码hex] [抽取] / rawstream off"
+
+struct TouchRawStreamRecord {
+    uint32_t timestamp_us;
+    uint8_t module_mask;
+    uint8_t seq;
+    uint16_t stage_mask;
+    uint16_t values[TOUCH_RAW_STREAM_MAX_VALUES];
+};
+
+/**
+ * record() 只在Core0 (I2C采样完成回调) 中调用，drain() 只在Core1中调用；start()/stop() 可在任意核心调用
+ */
+class TouchRawStream {
+public:
+    TouchRawStream();
+
+    // module_filter为0表示所有设备；decimation为每N次采样输出一帧 (1为全部)
+    void start(uint8_t module_filter, uint16_t stage_mask, uint8_t decimation);
+    void stop();
+
+    inline bool is_active() const { return active_; }
+    inline bool accepts(uint8_t module_mask) const {
+        return active_ && (module_filter_ == 0 || module_filter_ == module_mask);
+    }
+    inline uint8_t module_filter() const { return module_filter_; }
+    inline uint32_t frames_sent() const { return frames_sent_; }
+    inline uint32_t frames_dropped() const { return frames_dropped_; }
+
+    // 录制一次采样的原始值 (values[i] 对应阶段i)
+    void record(uint8_t module_mask, uint32_t timestamp_us, const uint16_t* values, uint8_t count);
+
+    // 编码并发送队列中的帧，CDC发送缓冲不足时停止，返回发送的帧数
+    uint32_t drain(USB_SerialLogs& logs);
+
+    // 解析CDC命令参数 "<设备掩码hex|all> [阶段掩码hex] [抽取]"，任一字段无法解析或越界时返回false且不修改输出
+    static bool parse_args(const char* args, uint8_t& module_filter, uint16_t& stage_mask, uint8_t& decimation);
+
+private:
+    SpscRing<TouchRawStreamRecord, TOUCH_RAW_STREAM_QUEUE_SIZE> queue_;
+    volatile bool active_;
+    volatile uint8_t module_filter_;
+    volatile uint16_t stage_mask_;
+    volatile uint8_t decimation_;
+    uint8_t seq_;                                           // 仅Core0
+    uint8_t decimation_masks_[TOUCH_RAW_STREAM_MAX_MODULES]; // 抽取计数 (仅Core0)
+    uint8_t decimation_counts_[TOUCH_RAW_STREAM_MAX_MODULES];
+    uint8_t decimation_slots_;
+    volatile bool restart_pending_;                          // start()后由Core0重置抽取状态
+    uint32_t frames_sent_;
+    volatile uint32_t frames_dropped_;
+
+    static uint8_t crc8(const uint8_t* data, size_t length);
+    static size_t encode(const TouchRawStreamRecord& record, uint8_t* frame);
+};
@@ -0,0 +1,205 @@
+#include "touch_trace.h"
+#include <new>
+#include <cstring>
+#include <LittleFS.h>
+#include <pico/multicore.h>
+#include <hardware/sync.h>
+#include "../../protocol/usb_serial_logs/usb_serial_logs.h"
+
+int8_t TouchTraceModuleCache::slot(uint8_t module_mask) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (module_masks[i] == module_mask) {
+            return static_cast<int8_t>(i);
+        }
+    }
+    if (count >= TOUCH_TRACE_MAX_MODULES) {
+        return -1;
+    }
+    module_masks[count] = module_mask;
+    channel_masks[count] = 0;
+    return static_cast<int8_t>(count++);
+}
+
+// TouchTraceRecorder 实现
+TouchTraceRecorder::TouchTraceRecorder()
+    : buffer_(nullptr), capacity_(0), length_(0), last_timestamp_us_(0),
+      recording_(false), save_pending_(false), overflowed_(false) {
+    memset(&header_, 0, sizeof(header_));
+    modules_.reset();
+}
+
+TouchTraceRecorder::~TouchTraceRecorder() {
+    recording_ = false;
+    release();
+}
+
+bool TouchTraceRecorder::start(uint32_t capacity_bytes) {
+    if (recording_ || save_pending_ || capacity_bytes < TOUCH_TRACE_MAX_RECORD_SIZE) {
+        return false;
+    }
+    release();
+    buffer_ = new (std::nothrow) uint8_t[capacity_bytes];
+    if (!buffer_) {
+        USB_LOG_TAG_WARNING("TouchTrace", "Alloc %lu bytes failed", (unsigned long)capacity_bytes);
+        return false;
+    }
+    capacity_ = capacity_bytes;
+    length_ = 0;
+    last_timestamp_us_ = 0;
+    overflowed_ = false;
+    memset(&header_, 0, sizeof(header_));
+    header_.magic = TOUCH_TRACE_MAGIC;
+    header_.version = TOUCH_TRACE_VERSION;
+    modules_.reset();
+    __dmb();
+    recording_ = true;
+    USB_LOG_TAG_INFO("TouchTrace", "Recording started, capacity %lu bytes", (unsigned long)capacity_bytes);
+    return true;
+}
+
+void TouchTraceRecorder::stop() {
+    if (!recording_) {
+        return;
+    }
+    recording_ = false;
+    save_pending_ = true;
+}
+
+void TouchTraceRecorder::append(const TouchSampleResult& result) {
+    if (capacity_ - length_ < TOUCH_TRACE_MAX_RECORD_SIZE) {
+        overflowed_ = true;
+        stop();
+        return;
+    }
+
+    const uint8_t module_mask = result.module_mask;
+    const uint32_t channel_mask = result.channel_mask;
+    uint32_t delta_us = 0;
+    if (header_.record_count == 0) {
+        header_.first_timestamp_us = result.timestamp_us;
+    } else {
+        delta_us = result.timestamp_us - last_timestamp_us_;
+    }
+    last_timestamp_us_ = result.timestamp_us;
+
+    // 新槽位的初始掩码为0，与读取端一致；槽位已满时总是写出完整掩码
+    int8_t slot = modules_.slot(module_mask);
+    bool changed = slot < 0 || modules_.channel_masks[slot] != channel_mask;
+    if (slot >= 0) {
+        modules_.channel_masks[slot] = channel_mask;
+    }
+
+    uint8_t* out = buffer_ + length_;
+    *out++ = module_mask;
+    uint64_t value = (static_cast<uint64_t>(delta_us) << 1) | (changed ? 1u : 0u);
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        *out++ = value ? (byte | 0x80) : byte;
+    } while (value);
+    if (changed) {
+        *out++ = static_cast<uint8_t>(channel_mask);
+        *out++ = static_cast<uint8_t>(channel_mask >> 8);
+        *out++ = static_cast<uint8_t>(channel_mask >> 16);
+    }
+    length_ = static_cast<uint32_t>(out - buffer_);
+    header_.record_count++;
+}
+
+bool TouchTraceRecorder::save(const char* path) {
+    if (!save_pending_) {
+        return false;
+    }
+    save_pending_ = false;
+    if (!buffer_) {
+        return false;
+    }
+    header_.module_count = modules_.count;
+
+    // 与ConfigManager保存流程一致：写Flash期间锁定另一核心
+    disable_interrupts();
+    multicore_lockout_start_blocking();
+    bool ok = false;
+    File file = LittleFS.open(path, "w");
+    if (file) {
+        ok = file.write(reinterpret_cast<const uint8_t*>(&header_), sizeof(header_)) == sizeof(header_)
+          && file.write(buffer_, length_) == length_;
+        file.close();
+    }
+    multicore_lockout_end_blocking();
+    enable_interrupts();
+
+    if (ok) {
+        USB_LOG_TAG_INFO("TouchTrace", "Saved %lu records (%lu bytes)%s to %s",
+                         (unsigned long)header_.record_count, (unsigned long)length_,
+                         overflowed_ ? ", buffer full" : "", path);
+    } else {
+        USB_LOG_TAG_ERROR("TouchTrace", "Save to %s failed", path);
+    }
+    release();
+    return ok;
+}
+
+void TouchTraceRecorder::release() {
+    delete[] buffer_;
+    buffer_ = nullptr;
+    capacity_ = 0;
+}
+
+// TouchTraceReader 实现
+TouchTraceReader::TouchTraceReader(const uint8_t* data, size_t length)
+    : data_(data), length_(length), pos_(0), timestamp_us_(0), valid_(false) {
+    memset(&header_, 0, sizeof(header_));
+    if (data_ && length_ >= sizeof(TouchTraceHeader)) {
+        memcpy(&header_, data_, sizeof(header_));
+        valid_ = header_.magic == TOUCH_TRACE_MAGIC && header_.version == TOUCH_TRACE_VERSION;
+    }
+    rewind();
+}
+
+void TouchTraceReader::rewind() {
+    pos_ = sizeof(TouchTraceHeader);
+    timestamp_us_ = header_.first_timestamp_us;
+    modules_.reset();
+}
+
+bool TouchTraceReader::next(TouchSampleResult& result) {
+    if (!valid_ || pos_ >= length_) {
+        return false;
+    }
+    uint8_t module_mask = data_[pos_++];
+
+    uint64_t value = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        if (pos_ >= length_ || shift > 35) {
+            valid_ = false;
+            return false;
+        }
+        byte = data_[pos_++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    timestamp_us_ += static_cast<uint32_t>(value >> 1);
+    int8_t slot = modules_.slot(module_mask);
+    uint32_t channel_mask = 0;
+    if (value & 1) {
+        if (pos_ + 3 > length_) {
+            valid_ = false;
+            return false;
+        }
+        channel_mask = data_[pos_] | (data_[pos_ + 1] << 8) | (data_[pos_ + 2] << 16);
+        pos_ += 3;
+        if (slot >= 0) modules_.channel_masks[slot] = channel_mask;
+    } else if (slot >= 0) {
+        channel_mask = modules_.channel_masks[slot];
+    }
+
+    result.touch_mask = 0;
+    result.channel_mask = channel_mask;
+    result.module_mask = module_mask;
+    result.timestamp_us = timestamp_us_;
+    return true;
+}
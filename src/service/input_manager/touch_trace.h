@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../protocol/touch_sensor/touch_sensor.h"
+
+/**
+ * 触摸采样轨迹 (Touch Trace)
+ * 录制 InputManager::async_touchsampleresult 收到的每一个 TouchSampleResult，
+ * 以紧凑二进制格式保存到 LittleFS，供主机仿真按原始时序回放整条串口处理链路。
+ *
+ * 文件格式 (小端):
+ *   TouchTraceHeader (16字节)
+ *   记录流，每条记录:
+ *     uint8   module_mask
+ *     varint  (delta_us << 1) | changed    与上一条记录的时间差，bit0 表示通道掩码是否变化
+ *     uint24  channel_mask                 仅当 changed=1 时存在，否则沿用该模块上一次的掩码
+ * 稳定按压时每条采样约3字节。
+ */
+
+#define TOUCH_TRACE_MAGIC 0x4352544D   // "MTRC"
+#define TOUCH_TRACE_VERSION 1
+#define TOUCH_TRACE_FILE_PATH "/touch_trace.bin"
+#define TOUCH_TRACE_DEFAULT_CAPACITY 16384
+#define TOUCH_TRACE_MAX_MODULES 8
+#define TOUCH_TRACE_MAX_RECORD_SIZE 9   // 1 + 5(varint) + 3
+
+struct TouchTraceHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t module_count;            // 轨迹中出现过的模块数量
+    uint16_t reserved;
+    uint32_t record_count;
+    uint32_t first_timestamp_us;     // 首条记录的设备时间戳
+};
+static_assert(sizeof(TouchTraceHeader) == 16, "TouchTraceHeader must be 16 bytes");
+
+// 每个模块最近一次的通道掩码，编解码两端共用
+struct TouchTraceModuleCache {
+    uint8_t module_masks[TOUCH_TRACE_MAX_MODULES];
+    uint32_t channel_masks[TOUCH_TRACE_MAX_MODULES];
+    uint8_t count;
+
+    void reset() { count = 0; }
+    // 返回模块槽位，不存在时分配新槽位，已满返回-1
+    int8_t slot(uint8_t module_mask);
+};
+
+/**
+ * 轨迹录制器
+ * record() 在I2C采样完成回调中调用 (Core0)，start()/stop() 可在任意核心调用；
+ * 保存动作需要锁定另一核心写Flash，因此由 Core0 的 task0 在 save_pending() 时执行。
+ */
+class TouchTraceRecorder {
+public:
+    TouchTraceRecorder();
+    ~TouchTraceRecorder();
+
+    bool start(uint32_t capacity_bytes = TOUCH_TRACE_DEFAULT_CAPACITY);
+    // 停止录制并请求保存
+    void stop();
+
+    inline bool is_recording() const { return recording_; }
+    inline bool save_pending() const { return save_pending_; }
+    inline bool overflowed() const { return overflowed_; }
+    inline uint32_t record_count() const { return header_.record_count; }
+    inline uint32_t size_bytes() const { return length_; }
+    inline const uint8_t* data() const { return buffer_; }
+
+    // 录制一条采样，缓冲区写满时自动停止并请求保存
+    inline void record(const TouchSampleResult& result) {
+        if (!recording_) return;
+        append(result);
+    }
+
+    // 写入LittleFS并释放缓冲区
+    bool save(const char* path = TOUCH_TRACE_FILE_PATH);
+
+private:
+    uint8_t* buffer_;
+    uint32_t capacity_;
+    uint32_t length_;
+    uint32_t last_timestamp_us_;
+    TouchTraceHeader header_;
+    TouchTraceModuleCache modules_;
+    volatile bool recording_;
+    volatile bool save_pending_;
+    bool overflowed_;
+
+    void append(const TouchSampleResult& result);
+    void release();
+};
+
+/**
+ * 轨迹读取器 - 顺序解码内存中的轨迹数据
+ * 解码出的 timestamp_us 为设备原始时间戳
+ */
+class TouchTraceReader {
+public:
+    TouchTraceReader(const uint8_t* data, size_t length);
+
+    bool valid() const { return valid_; }
+    const TouchTraceHeader& header() const { return header_; }
+
+    // 读取下一条记录，到达末尾或数据损坏返回false
+    bool next(TouchSampleResult& result);
+    void rewind();
+
+private:
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_;
+    uint32_t timestamp_us_;
+    bool valid_;
+    TouchTraceHeader header_;
+    TouchTraceModuleCache modules_;
+};
@@ -91,6 +91,19 @@ void CommunicationSettings::render(PageTemplate& page_template) {
                 snprintf(_text, sizeof(_text), "频率限制: %dHz", rate_limit_frequency);
                 ADD_SIMPLE_SELECTOR(_text, onRateLimitFrequencyChange, COLOR_TEXT_GREEN)
             }
+            
+            // 部分帧组帧：单个触摸模块卡顿时不拖住整帧
+            bool partial_frame_enabled = input_mgr->getPartialFrameEnabled();
+            snprintf(_text, sizeof(_text), "部分帧组帧: %s", 
+                     partial_frame_enabled ? "开启" : "关闭");
+            ADD_BUTTON(_text, onPartialFrameToggle, 
+                      partial_frame_enabled ? COLOR_TEXT_GREEN : COLOR_TEXT_WHITE, LineAlign::LEFT)
+            
+            // 新鲜度上限（仅在部分帧开启时显示）
+            if (partial_frame_enabled) {
+                snprintf(_text, sizeof(_text), "模块超时: %dms", input_mgr->getFrameStaleness());
+                ADD_SIMPLE_SELECTOR(_text, onFrameStalenessChange, COLOR_TEXT_GREEN)
+            }
         }
     }
     
@@ -362,4 +375,29 @@ void CommunicationSettings::onRateLimitFrequencyChange(JoystickState state) {
     }
 }
 
+// 部分帧组帧开关回调函数
+void CommunicationSettings::onPartialFrameToggle() {
+    InputManager* input_mgr = InputManager::getInstance();
+    if (!input_mgr) return;
+    
+    input_mgr->setPartialFrameEnabled(!input_mgr->getPartialFrameEnabled());
+}
+
+// 新鲜度上限回调函数
+void CommunicationSettings::onFrameStalenessChange(JoystickState state) {
+    InputManager* input_mgr = InputManager::getInstance();
+    if (!input_mgr) return;
+    
+    uint8_t staleness_ms = input_mgr->getFrameStaleness();
+    if (state == JoystickState::UP) {
+        if (staleness_ms < 100) {
+            input_mgr->setFrameStaleness(staleness_ms + 1);
+        }
+    } else if (state == JoystickState::DOWN) {
+        if (staleness_ms > 1) {
+            input_mgr->setFrameStaleness(staleness_ms - 1);
+        }
+    }
+}
+
 } // namespace ui
\ No newline at end of file
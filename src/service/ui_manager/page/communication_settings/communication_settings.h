@@ -58,6 +58,10 @@ private:
     static void onRateLimitEnabledToggle();
     static void onRateLimitFrequencyChange(JoystickState state);
     
+    // 部分帧组帧回调函数
+    static void onPartialFrameToggle();
+    static void onFrameStalenessChange(JoystickState state);
+    
     // 辅助函数
     static void loadCurrentSettings();
     static void ApplySettings();
@@ -3,6 +3,7 @@
 #include "../../engine/page_construction/page_macros.h"
 #include "../../engine/page_construction/page_template.h"
 #include "../../../config_manager/config_manager.h"
+#include "../../../input_manager/input_manager.h"
 #include "../../../../protocol/usb_serial_logs/usb_serial_logs.h"
 #include <cstdio>
 
@@ -51,6 +52,13 @@ void GeneralSettings::render(PageTemplate& page_template) {
     ADD_INT_SETTING(&brightness_value_, 0, 255, "亮度:", "亮度值", 
                     on_brightness_changed, on_brightness_complete, COLOR_TEXT_WHITE)
     
+    // 按键输入模式：中断 / 轮询
+    InputManager* input_manager = InputManager::getInstance();
+    if (input_manager) {
+        ADD_BUTTON(input_manager->getGPIOIRQMode() ? "按键输入: 中断" : "按键输入: 轮询",
+                   on_gpio_irq_mode_toggle, COLOR_TEXT_WHITE, LineAlign::LEFT)
+    }
+    
     PAGE_END()
 }
 
@@ -100,4 +108,12 @@ void GeneralSettings::on_brightness_complete() {
     }
 }
 
+void GeneralSettings::on_gpio_irq_mode_toggle() {
+    // 只修改InputManager配置，由主菜单"保存设置"统一落盘
+    InputManager* input_manager = InputManager::getInstance();
+    if (input_manager) {
+        input_manager->setGPIOIRQMode(!input_manager->getGPIOIRQMode());
+    }
+}
+
 } // namespace ui
\ No newline at end of file
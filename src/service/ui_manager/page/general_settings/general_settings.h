@@ -7,7 +7,7 @@ namespace ui {
 
 /**
  * 通用设置页面构造器
- * 包含息屏超时和亮度设置
+ * 包含息屏超时、亮度和按键输入模式设置
  */
 class GeneralSettings : public PageConstructor {
 public:
@@ -51,6 +51,11 @@ private:
      * 亮度值设置完成回调
      */
     static void on_brightness_complete();
+    
+    /**
+     * 按键输入模式切换回调 (中断/轮询)
+     */
+    static void on_gpio_irq_mode_toggle();
 };
 
 } // namespace ui
\ No newline at end of file
@@ -70,9 +70,16 @@ void AD7147CustomSettings::render(PageTemplate& page_template) {
     
     // 构建标题，包含CDC值和触发状态
     // CDC显示逻辑：使用AD7147_CDC_BASELINE为0值基准，低于此值显示负值，高于此值显示正值
-    static char text[32];
+    // 软件检测时附带当前阶段的差值 (基线 - 滤波值)
+    static char text[48];
     int32_t cdc_display_value = static_cast<int32_t>(current_cdc_value_) - AD7147_CDC_BASELINE;
-    snprintf(text, sizeof(text), "CDC:%ld [%s]", cdc_display_value, channel_triggered_ ? "1" : "0");
+    if (ad7147->getSoftwareDetection()) {
+        const int8_t hardware_stage = ad7147->getChannelStage(current_stage_);
+        const int16_t delta = hardware_stage >= 0 ? ad7147->getSoftwareDelta(hardware_stage) : 0;
+        snprintf(text, sizeof(text), "CDC:%ld 差值:%d [%s]", cdc_display_value, delta, channel_triggered_ ? "1" : "0");
+    } else {
+        snprintf(text, sizeof(text), "CDC:%ld [%s]", cdc_display_value, channel_triggered_ ? "1" : "0");
+    }
     
     PAGE_START()
     SET_TITLE(text, COLOR_WHITE)
@@ -87,7 +94,77 @@ void AD7147CustomSettings::render(PageTemplate& page_template) {
     } else {
         ADD_BUTTON("一键调整", onAutoOffsetButtonClick, COLOR_TEXT_YELLOW, LineAlign::CENTER)
     }
-    
+
+    // 就绪中断引脚 (保存设置并重启后生效)
+    static char int_pin_text[48];
+    const uint8_t int_pin = InputManager::getInstance()->getTouchDeviceIntPin(ad7147->getModuleMask());
+    if (int_pin == 0xFF) {
+        snprintf(int_pin_text, sizeof(int_pin_text), "INT引脚: 轮询");
+    } else {
+        snprintf(int_pin_text, sizeof(int_pin_text), "INT引脚: GPIO%u%s", int_pin,
+                 InputManager::getInstance()->isTouchDeviceIntActive(ad7147->getModuleMask()) ? "" : " (重启生效)");
+    }
+    ADD_SIMPLE_SELECTOR(int_pin_text, [](JoystickState state) {
+        AD7147* device = getAD7147Device();
+        if (!device) {
+            return;
+        }
+        InputManager* input_mgr = InputManager::getInstance();
+        const uint8_t pin = input_mgr->getTouchDeviceIntPin(device->getModuleMask());
+        // 0xFF (轮询) 位于GPIO29之后，循环切换
+        uint8_t next = pin;
+        if (state == JoystickState::UP) {
+            next = (pin == 0xFF) ? 0 : (pin >= 29 ? 0xFF : pin + 1);
+        } else if (state == JoystickState::DOWN) {
+            next = (pin == 0xFF) ? 29 : (pin == 0 ? 0xFF : pin - 1);
+        }
+        input_mgr->setTouchDeviceIntPin(device->getModuleMask(), next);
+    }, COLOR_TEXT_WHITE)
+
+    // 软件检测：由固件按CDC判定触摸，阈值与快速触发行程对全部阶段生效
+    const bool software_detect = ad7147->getSoftwareDetection();
+    std::string software_detect_text = "软件检测: " + std::string(software_detect ? "启用" : "禁用");
+    ADD_BUTTON(software_detect_text, []() {
+        AD7147* device = getAD7147Device();
+        if (device) {
+            device->setSoftwareDetection(!device->getSoftwareDetection());
+        }
+    }, software_detect ? COLOR_TEXT_GREEN : COLOR_TEXT_WHITE, LineAlign::LEFT)
+
+    if (software_detect) {
+        static char press_text[32];
+        snprintf(press_text, sizeof(press_text), "按下阈值: %u", ad7147->getSoftwarePressThreshold());
+        ADD_SIMPLE_SELECTOR(press_text, [](JoystickState state) {
+            AD7147* device = getAD7147Device();
+            if (!device) {
+                return;
+            }
+            uint16_t press = device->getSoftwarePressThreshold();
+            if (state == JoystickState::UP && press <= 0x1000 - 0x10) {
+                press += 0x10;
+            } else if (state == JoystickState::DOWN && press >= AD7147_SW_MIN_THRESHOLD + 0x10) {
+                press -= 0x10;
+            }
+            device->setSoftwareThresholds(press, device->getSoftwareRapidDelta());
+        }, COLOR_TEXT_YELLOW)
+
+        static char rapid_text[32];
+        snprintf(rapid_text, sizeof(rapid_text), "快速触发行程: %u", ad7147->getSoftwareRapidDelta());
+        ADD_SIMPLE_SELECTOR(rapid_text, [](JoystickState state) {
+            AD7147* device = getAD7147Device();
+            if (!device) {
+                return;
+            }
+            uint16_t rapid = device->getSoftwareRapidDelta();
+            if (state == JoystickState::UP && rapid <= 0x1000 - 0x10) {
+                rapid += 0x10;
+            } else if (state == JoystickState::DOWN && rapid >= AD7147_SW_MIN_THRESHOLD + 0x10) {
+                rapid -= 0x10;
+            }
+            device->setSoftwareThresholds(device->getSoftwarePressThreshold(), rapid);
+        }, COLOR_TEXT_YELLOW)
+    }
+
     // 阶段选择
     static char stage_text[32];
     snprintf(stage_text, sizeof(stage_text), "阶段选择: %ld", current_stage_);
@@ -325,9 +402,10 @@ void AD7147CustomSettings::loadStageDataAndStatus() {
         config_loaded_ = true;
     }
     
-    // 读取CDC值
+    // 读取CDC值 (选择的是通道，CDC按它当前所在的硬件阶段读取)
     uint16_t cdc_value;
-    if (ad7147->readStageCDC(current_stage_, cdc_value)) {
+    const int8_t hardware_stage = ad7147->getChannelStage(current_stage_);
+    if (hardware_stage >= 0 && ad7147->readStageCDC(hardware_stage, cdc_value)) {
         current_cdc_value_ = cdc_value;
     } else {
         current_cdc_value_ = 0;
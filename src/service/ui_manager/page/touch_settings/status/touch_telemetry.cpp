@@ -0,0 +1,73 @@
+#include "touch_telemetry.h"
+#include "../../../ui_manager.h"
+#include "../../../engine/page_construction/page_macros.h"
+#include "../../../engine/page_construction/page_template.h"
+#include "../../../../input_manager/input_manager.h"
+
+namespace ui {
+
+TouchTelemetry::TouchTelemetry() {
+    // 构造函数无需特殊初始化
+}
+
+void TouchTelemetry::render(PageTemplate& page_template) {
+    InputManager* input_manager = InputManager::getInstance();
+
+    PAGE_START()
+    SET_TITLE("采样统计", COLOR_WHITE)
+
+    // 返回上级页面
+    ADD_BACK_ITEM("返回", COLOR_TEXT_WHITE)
+
+    if (input_manager) {
+        char line[48];
+        for (uint8_t bus = 0; bus < 2; bus++) {
+            const uint16_t permille = input_manager->getI2CBusUtilisation(bus);
+            snprintf(line, sizeof(line), "I2C%u 占用 %u.%u%%", bus, permille / 10, permille % 10);
+            ADD_TEXT(line, COLOR_TEXT_WHITE, LineAlign::LEFT)
+        }
+
+        const auto& devices = input_manager->getTouchSensorDevices();
+        if (devices.empty()) {
+            ADD_TEXT("未检测到触摸IC设备", COLOR_YELLOW, LineAlign::CENTER)
+        }
+        for (uint8_t i = 0; i < devices.size(); i++) {
+            if (!devices[i]) {
+                continue;
+            }
+            const InputManager::TouchDeviceTelemetry& telemetry = input_manager->getTouchDeviceTelemetry(i);
+            const InputManager::TouchDeviceTiming& timing = input_manager->getTouchDeviceTiming(i);
+            const uint32_t since_ms = input_manager->getTimeSinceLastSample(i);
+
+            // 一秒内没有成功采样的设备标红
+            Color color = (since_ms > 1000) ? COLOR_RED : COLOR_TEXT_WHITE;
+            ADD_TEXT(devices[i]->getDeviceName(), color, LineAlign::LEFT)
+            snprintf(line, sizeof(line), " %u/s 失败%lu NACK%lu", telemetry.samples_per_sec,
+                     (unsigned long)timing.failure_total, (unsigned long)telemetry.nacks);
+            ADD_TEXT(line, color, LineAlign::LEFT)
+            if (since_ms == UINT32_MAX) {
+                snprintf(line, sizeof(line), " %u/%uus 未采样", telemetry.mean_cost_us, telemetry.max_cost_us);
+            } else {
+                snprintf(line, sizeof(line), " %u/%uus %lums前", telemetry.mean_cost_us, telemetry.max_cost_us,
+                         (unsigned long)since_ms);
+            }
+            ADD_TEXT(line, color, LineAlign::LEFT)
+        }
+
+        // 同时输出到USB日志，并清零累计计数
+        ADD_BUTTON("输出并清零", onResetButtonPressed, COLOR_TEXT_WHITE, LineAlign::CENTER)
+    } else {
+        ADD_TEXT("InputManager未初始化", COLOR_RED, LineAlign::CENTER)
+    }
+
+    PAGE_END()
+}
+
+void TouchTelemetry::onResetButtonPressed() {
+    InputManager* input_manager = InputManager::getInstance();
+    if (input_manager) {
+        input_manager->requestTouchTelemetryDump(true);
+    }
+}
+
+} // namespace ui
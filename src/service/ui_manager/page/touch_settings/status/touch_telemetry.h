@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../../../engine/page_construction/page_constructor.h"
+#include "../../../../input_manager/input_manager.h"
+#include <cstdint>
+#include <string>
+
+namespace ui {
+
+/**
+ * 采样统计页面构造器
+ * 显示各I2C总线占用率与每个触摸设备的采样遥测 (采样率、失败/NACK、事务耗时、距上次成功采样)
+ */
+class TouchTelemetry : public PageConstructor {
+public:
+    TouchTelemetry();
+    virtual ~TouchTelemetry() = default;
+    
+    /**
+     * 渲染采样统计页面
+     * @param page_template PageTemplate实例引用
+     */
+    virtual void render(PageTemplate& page_template) override;
+    
+private:
+    static void onResetButtonPressed();
+};
+
+} // namespace ui
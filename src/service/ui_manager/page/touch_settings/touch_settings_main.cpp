@@ -85,6 +85,7 @@ void TouchSettingsMain::render(PageTemplate& page_template) {
 
     // 触摸状态查看菜单项
     ADD_MENU("查看触摸状态", "touch_status", COLOR_TEXT_WHITE)
+    ADD_MENU("采样统计", "touch_telemetry", COLOR_TEXT_WHITE)
     
     // 检查是否存在可校准的传感器
     bool has_calibratable_sensors = input_manager->hasCalibratableSensors();
@@ -130,6 +131,19 @@ void TouchSettingsMain::render(PageTemplate& page_template) {
     // 灵敏度调整菜单项
     ADD_MENU("按模块调整灵敏度", "sensitivity_main", COLOR_TEXT_WHITE)
 
+    // 触摸轨迹录制
+    if (input_manager->isTouchTraceRecording()) {
+        static char trace_text[32];
+        snprintf(trace_text, sizeof(trace_text), "录制中: %lu", (unsigned long)input_manager->getTouchTraceRecordCount());
+        ADD_TEXT(trace_text, COLOR_YELLOW, LineAlign::CENTER)
+        ADD_BUTTON("停止录制并保存", onTouchTraceButtonPressed, COLOR_TEXT_WHITE, LineAlign::CENTER)
+    } else {
+        ADD_BUTTON("开始触摸录制", onTouchTraceButtonPressed, COLOR_TEXT_WHITE, LineAlign::CENTER)
+    }
+
+    // 输出各阶段延迟统计到USB日志，并清零开始新一轮统计
+    ADD_BUTTON("输出延迟统计", onLatencyDumpButtonPressed, COLOR_TEXT_WHITE, LineAlign::CENTER)
+
     PAGE_END()
 }
 
@@ -172,5 +186,23 @@ void TouchSettingsMain::onCalibrateButtonPressed() {
     }
 }
 
+void TouchSettingsMain::onTouchTraceButtonPressed() {
+    InputManager* input_manager = InputManager::getInstance();
+    if (!input_manager) {
+        return;
+    }
+    if (input_manager->isTouchTraceRecording()) {
+        input_manager->stopTouchTrace();
+    } else {
+        input_manager->startTouchTrace();
+    }
+}
+
+void TouchSettingsMain::onLatencyDumpButtonPressed() {
+    InputManager* input_manager = InputManager::getInstance();
+    if (input_manager) {
+        input_manager->requestTouchLatencyDump(true);
+    }
+}
 
 } // namespace ui
\ No newline at end of file
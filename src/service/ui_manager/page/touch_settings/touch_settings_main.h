@@ -88,6 +88,16 @@ private:
      * 校准按钮回调函数
      */
     static void onCalibrateButtonPressed();
+    
+    /**
+     * 触摸轨迹录制按钮回调函数 (开始/停止切换)
+     */
+    static void onTouchTraceButtonPressed();
+    
+    /**
+     * 延迟统计输出按钮回调函数 (输出后清零)
+     */
+    static void onLatencyDumpButtonPressed();
 };
 
 } // namespace ui
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "page/main_menu.h"
 #include "page/touch_settings/touch_settings_main.h"
 #include "page/touch_settings/status/touch_status.h"
+#include "page/touch_settings/status/touch_telemetry.h"
 #include "page/touch_settings/sensitivity/zone_sensitivity.h"
 #include "page/touch_settings/sensitivity/sensitivity_main.h"
 #include "page/touch_settings/sensitivity/sensitivity_device.h"
@@ -91,6 +92,10 @@ void PageRegistry::register_default_pages() {
     auto touch_status_page = std::make_shared<TouchStatus>();
     register_page("touch_status", touch_status_page);
     
+    // 注册采样统计页面
+    auto touch_telemetry_page = std::make_shared<TouchTelemetry>();
+    register_page("touch_telemetry", touch_telemetry_page);
+    
     // 注册按分区设置灵敏度页面
     auto zone_sensitivity_page = std::make_shared<ZoneSensitivity>();
     register_page("zone_sensitivity", zone_sensitivity_page);
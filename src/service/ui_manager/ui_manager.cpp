@@ -152,7 +152,7 @@ UIManager::UIManager()
     , backlight_enabled_(true)
     , screen_off_(false)
     , last_activity_time_(0)
-    , last_refresh_time_(0)
+    , refresh_due_(false)
     , last_navigation_time_(0)
     , navigation_start_time_(0)
     , navigation_direction_up_(false)
@@ -331,6 +331,10 @@ void UIManager::deinit() {
     
     // 页面注册器已移除，无需清理
     
+    if (refresh_timer_.pending()) {
+        TimerWheel::core().cancel(refresh_timer_);
+    }
+
     // 清理显示系统
     deinit_display();
     
@@ -405,25 +409,33 @@ void UIManager::refresh_display() {
     display_device_->write_buffer(framebuffer_, SCREEN_BUFFER_SIZE);
 }
 
+// 刷新节拍回调 - 只置位标志，渲染与SPI写屏留在task中执行，避免阻塞同轮其他定时器
+void UIManager::display_refresh_timer_callback(void* arg) {
+    static_cast<UIManager*>(arg)->refresh_due_ = true;
+}
+
 // 30fps刷新任务
-void UIManager::refresh_task_30fps(uint32_t millis) {
+void UIManager::refresh_task_30fps() {
     if (!initialized_ || !display_device_) {
         return;
     }
     
-    // 30fps = 33.33ms间隔
-    if (millis - last_refresh_time_ >= 33) {
-        // 屏幕亮起时始终刷新
-
-        draw_page_with_template();
-        // 渲染光标指示器
-        render_cursor_indicator();
-        
-        // 刷新显示
-        refresh_display();
-        
-        last_refresh_time_ = millis;
+    // 亮屏期间保持33.33ms周期节拍，首帧立即渲染
+    if (!refresh_timer_.pending()) {
+        TimerWheel::core().schedule_periodic(refresh_timer_, UI_REFRESH_PERIOD_US, display_refresh_timer_callback, this);
+        refresh_due_ = true;
+    }
+    if (!refresh_due_) {
+        return;
     }
+    refresh_due_ = false;
+
+    draw_page_with_template();
+    // 渲染光标指示器
+    render_cursor_indicator();
+    
+    // 刷新显示
+    refresh_display();
 }
 
 // 处理导航输入
@@ -898,13 +910,16 @@ void UIManager::task() {
             wake_screen();
         }
         
-        // 息屏状态下不进行页面更新
+        // 息屏状态下不进行页面更新，停掉刷新节拍让Core1可以休眠
+        if (refresh_timer_.pending()) {
+            TimerWheel::core().cancel(refresh_timer_);
+        }
         return;
     }
     
     // 屏幕开启状态下的正常渲染
     // 使用30fps刷新任务进行页面渲染
-    refresh_task_30fps(current_time);
+    refresh_task_30fps();
 }
 
 // 息屏管理
@@ -4,6 +4,7 @@
 #include "../../protocol/st7735s/st7735s.h"
 #include "../../protocol/hid/hid.h"
 #include "../config_manager/config_types.h"
+#include "../../hal/timer_wheel.h"
 #include "engine/graphics_rendering/graphics_engine.h"
 #include "engine/fonts/font_data.h"
 #include "engine/page_construction/page_template.h"
@@ -26,6 +27,9 @@ class ConfigManager;
 #define UIMANAGER_ENABLE_JOYSTICK "UIMANAGER_ENABLE_JOYSTICK"
 #define UIMANAGER_JOYSTICK_SENSITIVITY "UIMANAGER_JOYSTICK_SENSITIVITY"
 
+// 30fps刷新节拍 (Core1时间轮)
+#define UI_REFRESH_PERIOD_US 33333
+
 // 内置模板页构造 设置该名字时必须设置对应的模板构造器 否则崩溃
 #define _TEMPLATE_PAGE_NAME "__template_page__"
 
@@ -238,7 +242,8 @@ private:
     bool backlight_enabled_;
     bool screen_off_;
     uint32_t last_activity_time_;
-    uint32_t last_refresh_time_;
+    WheelTimer refresh_timer_;              // 30fps刷新节拍定时器 (Core1时间轮)，息屏时取消
+    volatile bool refresh_due_;             // 节拍到期，下一次task渲染一帧
     static bool debug_enabled_;
     uint32_t last_navigation_time_;
     
@@ -322,7 +327,7 @@ private:
     void update_page_template_content();
     
     // 30fps刷新任务
-    inline void refresh_task_30fps(uint32_t millis);
+    inline void refresh_task_30fps();
     static void display_refresh_timer_callback(void* arg);
     
     // 处理输入相关